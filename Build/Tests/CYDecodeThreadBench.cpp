@@ -0,0 +1,138 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include "Common/Thread/CYThreadBudget.hpp"
+
+// One player's video decoder: decode the best video stream of pszPath from the start, looping,
+// until bStop, with nThreads codec threads (0 = "auto", one per core).
+struct CYDecodeInstance
+{
+    std::atomic<int64_t> nFrames{ 0 };
+    int nThreads = 0;
+    bool bFailed = false;
+
+    void Run(const char* pszPath, const std::atomic_bool* pStop)
+    {
+        AVFormatContext* pIC = nullptr;
+        AVCodecContext* pCodecCtx = nullptr;
+        AVPacket* pPkt = av_packet_alloc();
+        AVFrame* pFrame = av_frame_alloc();
+        const AVCodec* pCodec = nullptr;
+        int nStream = -1;
+
+        bFailed = true;
+        if (!pPkt || !pFrame || avformat_open_input(&pIC, pszPath, nullptr, nullptr) < 0 || avformat_find_stream_info(pIC, nullptr) < 0)
+            goto end;
+        nStream = av_find_best_stream(pIC, AVMEDIA_TYPE_VIDEO, -1, -1, &pCodec, 0);
+        if (nStream < 0 || !(pCodecCtx = avcodec_alloc_context3(pCodec)))
+            goto end;
+        avcodec_parameters_to_context(pCodecCtx, pIC->streams[nStream]->codecpar);
+        pCodecCtx->thread_count = nThreads;
+        if (avcodec_open2(pCodecCtx, pCodec, nullptr) < 0)
+            goto end;
+        bFailed = false;
+
+        while (!*pStop)
+        {
+            int ret = av_read_frame(pIC, pPkt);
+            if (ret < 0)
+            {
+                avcodec_send_packet(pCodecCtx, nullptr);
+                while (avcodec_receive_frame(pCodecCtx, pFrame) >= 0)
+                    nFrames++;
+                avcodec_flush_buffers(pCodecCtx);
+                if (avformat_seek_file(pIC, -1, INT64_MIN, 0, INT64_MAX, 0) < 0)
+                    break;
+                continue;
+            }
+            if (pPkt->stream_index == nStream && avcodec_send_packet(pCodecCtx, pPkt) >= 0)
+            {
+                while (avcodec_receive_frame(pCodecCtx, pFrame) >= 0)
+                    nFrames++;
+            }
+            av_packet_unref(pPkt);
+        }
+
+    end:
+        avcodec_free_context(&pCodecCtx);
+        avformat_close_input(&pIC);
+        av_frame_free(&pFrame);
+        av_packet_free(&pPkt);
+    }
+};
+
+// nInstances decoders of the same file running together for nSeconds, each opened with "auto"
+// threads or with what its lease gets from a budget of one thread per core. The lease pixel
+// rate is the same for all, priorities cycle through low, normal and high.
+void RunRound(const char* pszPath, int nInstances, int nSeconds, bool bBudget)
+{
+    cry::CYThreadBudget::Instance().SetBudget(bBudget ? (int)std::thread::hardware_concurrency() : 0);
+
+    std::vector<cry::CYThreadLease> vecLeases(nInstances);
+    std::vector<CYDecodeInstance> vecInstances(nInstances);
+    AVFormatContext* pIC = nullptr;
+    int64_t nPixelRate = 1920 * 1080 * 30;
+    if (avformat_open_input(&pIC, pszPath, nullptr, nullptr) >= 0 && avformat_find_stream_info(pIC, nullptr) >= 0)
+    {
+        int nStream = av_find_best_stream(pIC, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        if (nStream >= 0)
+        {
+            AVStream* st = pIC->streams[nStream];
+            AVRational objRate = av_guess_frame_rate(pIC, st, nullptr);
+            nPixelRate = (int64_t)st->codecpar->width * st->codecpar->height * (objRate.num > 0 && objRate.den > 0 ? av_q2d(objRate) : 25);
+        }
+    }
+    avformat_close_input(&pIC);
+
+    for (int i = 0; i < nInstances; i++)
+        vecInstances[i].nThreads = vecLeases[i].Acquire(nPixelRate, i % 3);
+
+    std::atomic_bool bStop{ false };
+    std::vector<std::thread> vecThreads;
+    auto tStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < nInstances; i++)
+        vecThreads.emplace_back(&CYDecodeInstance::Run, &vecInstances[i], pszPath, &bStop);
+    std::this_thread::sleep_for(std::chrono::seconds(nSeconds));
+    bStop = true;
+    for (auto& objThread : vecThreads)
+        objThread.join();
+    std::chrono::duration<double> tElapsed = std::chrono::steady_clock::now() - tStart;
+
+    int64_t nTotal = 0, nMin = INT64_MAX, nMax = 0;
+    int nCodecThreads = 0, nFailed = 0;
+    for (auto& objInstance : vecInstances)
+    {
+        nFailed += objInstance.bFailed;
+        nTotal += objInstance.nFrames;
+        nMin = std::min<int64_t>(nMin, objInstance.nFrames);
+        nMax = std::max<int64_t>(nMax, objInstance.nFrames);
+        nCodecThreads += objInstance.nThreads ? objInstance.nThreads : (int)std::thread::hardware_concurrency();
+    }
+    std::cout << (bBudget ? "budget " : "auto   ")
+        << "  codec threads: " << nCodecThreads
+        << "  total: " << (int64_t)(nTotal / tElapsed.count()) << " fps"
+        << "  per instance min/max: " << (int64_t)(nMin / tElapsed.count()) << "/" << (int64_t)(nMax / tElapsed.count()) << " fps";
+    if (nFailed)
+        std::cout << "  (" << nFailed << " could not decode)";
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <media_file_path> [instances] [seconds]" << std::endl;
+        return 1;
+    }
+    int nInstances = argc > 2 ? atoi(argv[2]) : 16;
+    int nSeconds = argc > 3 ? atoi(argv[3]) : 10;
+
+    std::cout << "instances: " << nInstances << "  cores: " << (int)std::thread::hardware_concurrency() << "  seconds: " << nSeconds << std::endl;
+    RunRound(argv[1], nInstances, nSeconds, false);
+    RunRound(argv[1], nInstances, nSeconds, true);
+    return 0;
+}
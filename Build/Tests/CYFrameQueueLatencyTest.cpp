@@ -0,0 +1,241 @@
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+#include "Common/Queue/CYPacketQueue.hpp"
+#include "Common/Queue/CYFrameQueue.hpp"
+
+// log2 buckets of the producer->consumer handoff latency in nanoseconds.
+struct CYLatencyHistogram
+{
+    int64_t arrBuckets[48] = { 0 };
+    int64_t nCount = 0;
+    int64_t nMax = 0;
+
+    void Add(int64_t nNanos)
+    {
+        int nBucket = 0;
+        while (nBucket < 47 && (int64_t(1) << (nBucket + 1)) <= nNanos)
+            nBucket++;
+        arrBuckets[nBucket]++;
+        nCount++;
+        nMax = FFMAX(nMax, nNanos);
+    }
+
+    /* upper bound of the bucket holding the fPercent percentile */
+    int64_t Percentile(double fPercent) const
+    {
+        int64_t nTarget = (int64_t)(nCount * fPercent / 100.0);
+        int64_t nSeen = 0;
+        for (int i = 0; i < 48; i++)
+        {
+            nSeen += arrBuckets[i];
+            if (nSeen > nTarget)
+                return int64_t(1) << (i + 1);
+        }
+        return nMax;
+    }
+};
+
+static int64_t NowNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The producer stamps each frame with the time it was pushed, the consumer records how long it took
+// to see it. With nPaceMicros > 0 the consumer is usually parked when the frame arrives, which
+// measures the wake path rather than the spin path.
+int RunLatency(const char* pszName, int nFrames, int nPaceMicros, int nKeepLast)
+{
+    SharePtr<cry::CYPacketQueue> ptrPktQueue = MakeShared<cry::CYPacketQueue>();
+    ptrPktQueue->Init();
+    ptrPktQueue->Start();
+
+    cry::CYFrameQueue objQueue;
+    objQueue.Init(ptrPktQueue, SAMPLE_QUEUE_SIZE, nKeepLast);
+
+    std::thread objProducer([&]() {
+        for (int i = 0; i < nFrames; i++)
+        {
+            if (nPaceMicros > 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(nPaceMicros));
+            CYFrame* pFrame = objQueue.PeekWritable();
+            if (!pFrame)
+                break;
+            pFrame->pts = i;
+            pFrame->pos = NowNanos();
+            objQueue.Push();
+        }
+    });
+
+    CYLatencyHistogram objHistogram;
+    int nErrors = 0;
+    for (int i = 0; i < nFrames; i++)
+    {
+        CYFrame* pFrame = objQueue.PeekReadable();
+        if (!pFrame)
+        {
+            std::cout << pszName << ": queue aborted at frame " << i << std::endl;
+            nErrors++;
+            break;
+        }
+        objHistogram.Add(NowNanos() - pFrame->pos);
+        if (pFrame->pts != i)
+        {
+            std::cout << pszName << ": expected frame " << i << " got " << pFrame->pts << std::endl;
+            nErrors++;
+        }
+        objQueue.Next();
+    }
+    objProducer.join();
+
+    if (objQueue.NbRemaining() != 0)
+    {
+        std::cout << pszName << ": " << objQueue.NbRemaining() << " frames left behind" << std::endl;
+        nErrors++;
+    }
+
+    ptrPktQueue->Abort();
+    objQueue.Destroy();
+
+    std::cout << pszName
+        << "  frames: " << objHistogram.nCount
+        << "  p50: <" << objHistogram.Percentile(50) << " ns"
+        << "  p99: <" << objHistogram.Percentile(99) << " ns"
+        << "  max: " << objHistogram.nMax << " ns" << std::endl;
+    return nErrors;
+}
+
+// The writer must never get more than the current depth ahead, and late drops must grow an
+// adaptive queue within its bounds.
+int RunDepth()
+{
+    SharePtr<cry::CYPacketQueue> ptrPktQueue = MakeShared<cry::CYPacketQueue>();
+    ptrPktQueue->Init();
+    ptrPktQueue->Start();
+
+    cry::CYFrameQueue objQueue;
+    objQueue.Init(ptrPktQueue, 16, 1);
+    objQueue.SetDepth(3);
+    int nErrors = 0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        objQueue.PeekWritable();
+        objQueue.Push();
+    }
+    CYFrame* arrFrames[16];
+    objQueue.Next();
+    objQueue.Next();
+    if (objQueue.PeekWritableBatch(arrFrames, 16) != 1)
+    {
+        std::cout << "depth: writer went past depth 3" << std::endl;
+        nErrors++;
+    }
+    objQueue.Next();
+    objQueue.Next();
+
+    objQueue.EnableAdaptiveDepth(2, 8);
+    for (int i = 0; i < FRAME_QUEUE_ADAPT_INTERVAL; i++)
+    {
+        objQueue.ReportLateDrop();
+        objQueue.ReportProduceTime(0.001, 0.040);
+    }
+    if (objQueue.GetDepth() != 4)
+    {
+        std::cout << "depth: late drops grew depth to " << objQueue.GetDepth() << std::endl;
+        nErrors++;
+    }
+    for (int i = 0; i < 10 * FRAME_QUEUE_ADAPT_INTERVAL; i++)
+        objQueue.ReportProduceTime(0.001, 0.040);
+    if (objQueue.GetDepth() != 3)
+    {
+        std::cout << "depth: steady decode shrank depth to " << objQueue.GetDepth() << std::endl;
+        nErrors++;
+    }
+
+    ptrPktQueue->Abort();
+    objQueue.Destroy();
+    std::cout << "depth: " << (nErrors ? "failed" : "ok") << std::endl;
+    return nErrors;
+}
+
+// A third thread waiting for a free slot is woken by the reader or by its cancel, and an armed
+// drain wakeup fires once the reader has shown every queued frame.
+int RunWakeups()
+{
+    SharePtr<cry::CYPacketQueue> ptrPktQueue = MakeShared<cry::CYPacketQueue>();
+    ptrPktQueue->Init();
+    ptrPktQueue->Start();
+
+    cry::CYFrameQueue objQueue;
+    objQueue.Init(ptrPktQueue, 2, 1);
+    int nErrors = 0;
+
+    for (int i = 0; i < 2; i++)
+    {
+        objQueue.PeekWritable();
+        objQueue.Push();
+    }
+
+    std::atomic_bool bCancel{ false };
+    bool bWritable = false;
+    std::thread objWaiter([&]() { bWritable = objQueue.WaitWritable(bCancel); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    objQueue.Next();
+    objQueue.Next();
+    objWaiter.join();
+    if (!bWritable || !objQueue.TryPeekWritable())
+    {
+        std::cout << "wakeups: the reader did not wake a waiting writer" << std::endl;
+        nErrors++;
+    }
+    objQueue.Push();
+
+    bWritable = true;
+    objWaiter = std::thread([&]() { bWritable = objQueue.WaitWritable(bCancel); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    bCancel = true;
+    objQueue.WakeWriters();
+    objWaiter.join();
+    if (bWritable)
+    {
+        std::cout << "wakeups: a cancelled wait reported a free slot" << std::endl;
+        nErrors++;
+    }
+
+    cry::CYCondition objDrained(true);
+    objQueue.ArmDrainWakeup(&objDrained);
+    if (objDrained.WaitTimeOut(0) != cry::COND_RET_TIMEOUT)
+    {
+        std::cout << "wakeups: drain wakeup fired with a frame left" << std::endl;
+        nErrors++;
+    }
+    objQueue.Next();
+    if (objDrained.WaitTimeOut(1000) != cry::COND_RET_OK)
+    {
+        std::cout << "wakeups: drain wakeup did not fire" << std::endl;
+        nErrors++;
+    }
+
+    ptrPktQueue->Abort();
+    objQueue.Destroy();
+    std::cout << "wakeups: " << (nErrors ? "failed" : "ok") << std::endl;
+    return nErrors;
+}
+
+int main(int argc, char* argv[])
+{
+    int nFrames = argc > 1 ? atoi(argv[1]) : 200000;
+    int nErrors = 0;
+
+    nErrors += RunLatency("back-to-back", nFrames, 0, 1);
+    nErrors += RunLatency("back-to-back no keep_last", nFrames, 0, 0);
+    nErrors += RunLatency("paced 100us", FFMIN(nFrames, 5000), 100, 1);
+    nErrors += RunDepth();
+    nErrors += RunWakeups();
+
+    return nErrors ? 1 : 0;
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include "Common/Memory/CYMemoryBudget.hpp"
+#include "ChainFilter/Common/CYGopCache.hpp"
+
+#define TEST_FRAME_SEC  0.04
+#define TEST_GOP_FRAMES 12
+#define TEST_FRAMES     250
+#define TEST_FRAME_SIZE (1024 * 1024)
+
+// Reverse playback of a 10 second stream through a CYGopCache of nCapacity bytes. The worker
+// "decodes" the 12 frame GOP before the start of the cached run, from its keyframe up to the
+// wanted end, like CYReversePlayback; the presenter takes frames from the end. Every frame must
+// come out once, in reverse order, without the cache ever holding more than its capacity.
+static int Run(int64_t nCapacity)
+{
+    cry::CYMemoryAccount objAccount;
+    cry::CYGopCache objCache;
+    objCache.SetMemoryAccount(&objAccount);
+    objCache.Reset(TEST_FRAMES * TEST_FRAME_SEC, nCapacity);
+
+    std::atomic<int64_t> nPeak{ 0 };
+    std::atomic<int> nGops{ 0 };
+    std::thread objWorker([&]()
+    {
+        double fEnd = 0;
+        while (objCache.WaitForRoom(&fEnd))
+        {
+            int nEnd = (int)lround(fEnd / TEST_FRAME_SEC);
+            int nKey = (nEnd - 1) / TEST_GOP_FRAMES * TEST_GOP_FRAMES;
+            std::vector<cry::CYCachedFrame> vecFrames;
+            for (int i = nKey; i < nEnd; i++)
+            {
+                cry::CYCachedFrame objFrame;
+                objFrame.ptrFrame = AVFramePtrCreate();
+                objFrame.fPts = i * TEST_FRAME_SEC;
+                objFrame.fDuration = TEST_FRAME_SEC;
+                objFrame.nBytes = TEST_FRAME_SIZE;
+                vecFrames.push_back(std::move(objFrame));
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            objCache.Prepend(vecFrames, fEnd, nKey == 0);
+            nGops++;
+            int64_t nBytes = objAccount.Usage(cry::TYPE_MEMORY_FRAMES);
+            if (nBytes > nPeak)
+                nPeak = nBytes;
+        }
+    });
+
+    int nErrors = 0;
+    int nExpected = TEST_FRAMES - 1;
+    cry::CYCachedFrame objFrame;
+    while (objCache.TakeLast(&objFrame))
+    {
+        if (lround(objFrame.fPts / TEST_FRAME_SEC) != nExpected)
+        {
+            std::cout << "frame " << objFrame.fPts << " shown, expected " << nExpected * TEST_FRAME_SEC << std::endl;
+            nErrors++;
+            break;
+        }
+        nExpected--;
+        objFrame.ptrFrame.reset();
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    objCache.Abort();
+    objWorker.join();
+    objCache.Clear();
+
+    std::cout << "capacity " << nCapacity / TEST_FRAME_SIZE << " frames: " << TEST_FRAMES - 1 - nExpected << "/" << TEST_FRAMES
+        << " frames shown, " << nGops << " GOPs decoded, peak " << nPeak / TEST_FRAME_SIZE << " frames" << std::endl;
+    if (nExpected != -1)
+    {
+        std::cout << "reverse playback did not reach the start" << std::endl;
+        nErrors++;
+    }
+    if (nPeak > FFMAX(nCapacity, TEST_FRAME_SIZE))
+    {
+        std::cout << "the cache held more than its capacity" << std::endl;
+        nErrors++;
+    }
+    if (objAccount.Usage(cry::TYPE_MEMORY_FRAMES) != 0)
+    {
+        std::cout << "frame memory still charged: " << objAccount.Usage(cry::TYPE_MEMORY_FRAMES) << std::endl;
+        nErrors++;
+    }
+    return nErrors;
+}
+
+int main(int argc, char* argv[])
+{
+    int nErrors = 0;
+    /* room for two GOPs, so the one before is decoded while the current one plays */
+    nErrors += Run(2 * TEST_GOP_FRAMES * TEST_FRAME_SIZE);
+    /* smaller than a GOP: the latest frames are kept and the GOP decoded again for the rest */
+    nErrors += Run(5 * TEST_FRAME_SIZE);
+    return nErrors ? 1 : 0;
+}
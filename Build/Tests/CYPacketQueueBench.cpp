@@ -0,0 +1,290 @@
+#include <iostream>
+#include <list>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "Common/Queue/CYPacketQueue.hpp"
+
+// Reference implementation: the std::list + mutex queue CYPacketQueue used before the ring.
+class CYListPacketQueue
+{
+public:
+    void Start()
+    {
+        UniqueLock locker(m_mutex);
+        bAbortRequest = false;
+        serial++;
+    }
+
+    int Put(AVPacketPtr& ptrPkt2)
+    {
+        AVPacketPtr pkt1 = AVPacketPtrCreate();
+        if (!pkt1)
+            return -1;
+        av_packet_move_ref(pkt1.get(), ptrPkt2.get());
+
+        SharePtr<cry::CYPacketWrapper> ptrPacket = MakeShared<cry::CYPacketWrapper>();
+        ptrPacket->ptrPkt = std::move(pkt1);
+        ptrPacket->nSerial = serial;
+
+        UniqueLock locker(m_mutex);
+        m_lstPkt.push_back(ptrPacket);
+        nb_packets++;
+        size += ptrPacket->ptrPkt->size + sizeof(cry::CYPacketWrapper);
+        duration += ptrPacket->ptrPkt->duration;
+        m_cvCond.notify_one();
+        return 0;
+    }
+
+    int Get(AVPacketPtr& ptrPkt, int block, int* pSerial)
+    {
+        UniqueLock locker(m_mutex);
+        for (;;)
+        {
+            if (bAbortRequest)
+                return -1;
+            if (m_lstPkt.size() > 0)
+            {
+                SharePtr<cry::CYPacketWrapper> ptrPacket = m_lstPkt.front();
+                m_lstPkt.pop_front();
+                nb_packets--;
+                size -= ptrPacket->ptrPkt->size + sizeof(cry::CYPacketWrapper);
+                duration -= ptrPacket->ptrPkt->duration;
+                if (pSerial)
+                    *pSerial = ptrPacket->nSerial;
+                ptrPkt = std::move(ptrPacket->ptrPkt);
+                return 1;
+            }
+            if (!block)
+                return 0;
+            m_cvCond.wait(locker);
+        }
+    }
+
+    bool Full() const
+    {
+        return false;
+    }
+
+    int NbPackets() const
+    {
+        return nb_packets;
+    }
+
+    int serial = 0;
+    int nb_packets = 0;
+    int size = 0;
+    int64_t duration = 0;
+    bool bAbortRequest = true;
+
+private:
+    std::list<SharePtr<cry::CYPacketWrapper>> m_lstPkt;
+    std::mutex m_mutex;
+    std::condition_variable m_cvCond;
+};
+
+// One demux-like producer and one decoder-like consumer, the producer backs off while the
+// consumer is more than nMaxQueued packets behind, like the demux read loop does.
+template <typename TQueue>
+double RunBench(TQueue& objQueue, int nPackets, int nMaxQueued)
+{
+    objQueue.Start();
+
+    auto tStart = std::chrono::steady_clock::now();
+    std::thread objProducer([&]() {
+        AVPacketPtr ptrPkt = AVPacketPtrCreate();
+        for (int i = 0; i < nPackets; i++)
+        {
+            while (objQueue.NbPackets() >= nMaxQueued || objQueue.Full())
+                std::this_thread::yield();
+            ptrPkt->size = 1024;
+            ptrPkt->duration = 1;
+            ptrPkt->pts = i;
+            objQueue.Put(ptrPkt);
+        }
+    });
+
+    AVPacketPtr ptrOut;
+    int nSerial = 0;
+    int64_t nExpect = 0;
+    for (int i = 0; i < nPackets; i++)
+    {
+        if (objQueue.Get(ptrOut, 1, &nSerial) <= 0)
+            break;
+        if (ptrOut->pts != nExpect++)
+        {
+            std::cout << "out of order packet " << ptrOut->pts << std::endl;
+            break;
+        }
+    }
+    objProducer.join();
+
+    std::chrono::duration<double> tElapsed = std::chrono::steady_clock::now() - tStart;
+    return nPackets / tElapsed.count();
+}
+
+// A third thread keeps taking GetStats() snapshots while packets of a fixed size flow through
+// the ring; every snapshot has to be internally consistent.
+int CheckStats(int nPackets)
+{
+    const int nPacketBytes = 1024 + (int)sizeof(cry::CYPacketWrapper);
+    cry::CYPacketQueue objRing;
+    objRing.Init();
+    objRing.Start();
+
+    std::atomic_bool bDone{ false };
+    int64_t nSnapshots = 0;
+    int nErrors = 0;
+    std::thread objMonitor([&]() {
+        while (!bDone)
+        {
+            cry::CYPacketQueueStats objStats = objRing.GetStats();
+            nSnapshots++;
+            if (objStats.nPackets < 0 || objStats.nPackets > objRing.Capacity() ||
+                objStats.nBytes != objStats.nPackets * nPacketBytes ||
+                objStats.nDuration != objStats.nPackets ||
+                objStats.nTotalEnqueued - objStats.nTotalDequeued != objStats.nPackets ||
+                objStats.nMaxPackets < objStats.nPackets)
+            {
+                if (nErrors++ < 10)
+                    std::cout << "inconsistent stats: packets " << objStats.nPackets << " bytes " << objStats.nBytes
+                        << " duration " << objStats.nDuration << " in/out " << objStats.nTotalEnqueued << "/" << objStats.nTotalDequeued << std::endl;
+            }
+        }
+    });
+
+    RunBench(objRing, nPackets, 1024);
+    bDone = true;
+    objMonitor.join();
+
+    cry::CYPacketQueueStats objStats = objRing.GetStats();
+    if (objStats.nPackets != 0 || objStats.nTotalEnqueued != nPackets || objStats.nTotalDequeued != nPackets)
+        nErrors++;
+
+    std::cout << "stats snapshots: " << nSnapshots << "  inconsistent: " << nErrors
+        << "  high water: " << objStats.nMaxPackets << " pkts / " << objStats.nMaxBytes / 1024 << " KB" << std::endl;
+    return nErrors;
+}
+
+// Packets charge their bytes to the queue's memory account while queued, and the read-ahead
+// limit follows the fair share of the process budget.
+int CheckMemory()
+{
+    int nErrors = 0;
+    cry::CYMemoryAccount objFirst;
+    cry::CYMemoryAccount objSecond;
+    cry::CYMemoryBudget::Instance().SetBudget(16 * 1024 * 1024);
+
+    {
+        cry::CYPacketQueue objRing;
+        objRing.Init();
+        objRing.Start();
+        objRing.SetMemoryAccount(&objFirst);
+
+        AVPacketPtr ptrPkt = AVPacketPtrCreate();
+        for (int i = 0; i < 4; i++)
+        {
+            ptrPkt->size = 1024;
+            objRing.Put(ptrPkt);
+        }
+        if (objFirst.Usage(cry::TYPE_MEMORY_PACKETS) != objRing.Size())
+            nErrors++;
+
+        objRing.Get(ptrPkt, 0, nullptr);
+        if (objFirst.Usage(cry::TYPE_MEMORY_PACKETS) != objRing.Size())
+            nErrors++;
+
+        objRing.Flush();
+        if (objFirst.Usage() != 0)
+            nErrors++;
+    }
+
+    /* 8 MB each while both are idle, the second may borrow what the first leaves unused */
+    objFirst.Charge(cry::TYPE_MEMORY_FRAMES, 2 * 1024 * 1024);
+    if (objSecond.Allowance() != 14 * 1024 * 1024)
+        nErrors++;
+    objFirst.Charge(cry::TYPE_MEMORY_FRAMES, 13 * 1024 * 1024 + 512 * 1024);
+    if (objSecond.Allowance() != 8 * 1024 * 1024 || objFirst.ReadAheadLimit() != MIN_QUEUE_SIZE ||
+        objFirst.Pressure() != cry::TYPE_MEMORY_PRESSURE_FRAMES)
+        nErrors++;
+
+    objSecond.SetQuota(4 * 1024 * 1024);
+    if (objSecond.Allowance() != 4 * 1024 * 1024 || objSecond.ReadAheadLimit() != 4 * 1024 * 1024 ||
+        objSecond.Pressure() != cry::TYPE_MEMORY_PRESSURE_READ_AHEAD)
+        nErrors++;
+
+    objFirst.Charge(cry::TYPE_MEMORY_FRAMES, -objFirst.Usage());
+    cry::CYMemoryBudget::Instance().SetBudget(0);
+    if (objFirst.ReadAheadLimit() != MAX_QUEUE_SIZE || objFirst.Pressure() != cry::TYPE_MEMORY_PRESSURE_NONE)
+        nErrors++;
+
+    std::cout << "memory budget: " << (nErrors ? "failed" : "ok") << std::endl;
+    return nErrors;
+}
+
+// A seek into the queued packets drops everything before the keyframe at or before the target
+// and moves the rest to a new serial; a target outside what is queued leaves the queue alone.
+int CheckSeekWithin()
+{
+    int nErrors = 0;
+    cry::CYPacketQueue objRing;
+    objRing.Init();
+    objRing.Start();
+
+    AVPacketPtr ptrPkt = AVPacketPtrCreate();
+    for (int i = 0; i < 100; i++)
+    {
+        av_new_packet(ptrPkt.get(), 64);
+        ptrPkt->pts = ptrPkt->dts = i;
+        ptrPkt->flags = i % 10 == 0 ? AV_PKT_FLAG_KEY : 0;
+        objRing.Put(ptrPkt);
+    }
+    int nSerial = objRing.serial;
+
+    if (objRing.SeekWithin(100) || objRing.NbPackets() != 100 || objRing.serial != nSerial)
+        nErrors++;
+    if (!objRing.SeekWithin(35) || objRing.NbPackets() != 70 || objRing.serial != nSerial + 1)
+        nErrors++;
+
+    int nPktSerial = 0;
+    objRing.Get(ptrPkt, 0, &nPktSerial);
+    if (ptrPkt->pts != 30 || nPktSerial != objRing.serial)
+        nErrors++;
+
+    /* the keyframe at 30 was taken out, nothing queued can start a decode before 40 */
+    if (objRing.SeekWithin(35) || objRing.NbPackets() != 69)
+        nErrors++;
+    objRing.Flush();
+
+    std::cout << "seek within queue: " << (nErrors ? "failed" : "ok") << std::endl;
+    return nErrors;
+}
+
+int main(int argc, char* argv[])
+{
+    int nPackets = argc > 1 ? atoi(argv[1]) : 1000000;
+    const int arrMaxQueued[] = { 1, 32, 1024 };
+
+    std::cout << "packets: " << nPackets << std::endl;
+    for (int nMaxQueued : arrMaxQueued)
+    {
+        CYListPacketQueue objList;
+        cry::CYPacketQueue objRing;
+        objRing.Init();
+
+        double fList = RunBench(objList, nPackets, nMaxQueued);
+        double fRing = RunBench(objRing, nPackets, nMaxQueued);
+
+        std::cout << "max queued " << nMaxQueued
+            << "  list: " << (int64_t)fList << " pkt/s"
+            << "  ring: " << (int64_t)fRing << " pkt/s"
+            << "  speedup: " << fRing / fList << "x"
+            << "  pool hits/misses: " << objRing.PoolHits() << "/" << objRing.PoolMisses() << std::endl;
+    }
+
+    int nErrors = CheckStats(nPackets);
+    nErrors += CheckMemory();
+    nErrors += CheckSeekWithin();
+    return nErrors ? 1 : 0;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+
+#include "ChainFilter/Common/CYQualityGovernor.hpp"
+
+#define TEST_FRAME_DURATION 0.040
+
+// A simulated decoder whose cost per picture shrinks with each quality level, fed to the
+// governor picture by picture; a picture that costs more than its duration is dropped late.
+// Returns the level reached after nPictures at fBaseCost seconds per full quality picture.
+int Simulate(cry::CYQualityGovernor& objGovernor, double fBaseCost, int nPictures, int* pChanges)
+{
+    const double arrCost[] = { 1.0, 0.8, 0.65, 0.55, 0.35 };
+    int nLevel = objGovernor.Level();
+    for (int i = 0; i < nPictures; i++)
+    {
+        double fCost = fBaseCost * arrCost[objGovernor.Level()];
+        objGovernor.ReportDecodeTime(fCost, TEST_FRAME_DURATION);
+        if (fCost > TEST_FRAME_DURATION)
+            objGovernor.ReportDrop();
+        if (objGovernor.Level() != nLevel)
+        {
+            nLevel = objGovernor.Level();
+            (*pChanges)++;
+        }
+    }
+    return nLevel;
+}
+
+int main(int argc, char* argv[])
+{
+    int nErrors = 0;
+    int nChanges = 0;
+    cry::CYQualityGovernor objGovernor;
+
+    objGovernor.Reset(false);
+    if (Simulate(objGovernor, 0.080, 3000, &nChanges) != cry::TYPE_DECODE_QUALITY_FULL)
+    {
+        std::cout << "a disabled governor changed the quality" << std::endl;
+        nErrors++;
+    }
+
+    /* twice too slow at full quality, real time is only reached without non-reference frames */
+    objGovernor.Reset(true);
+    int nLevel = Simulate(objGovernor, 0.080, 3000, &nChanges);
+    std::cout << "overloaded: level " << nLevel << " after " << nChanges << " changes" << std::endl;
+    if (nLevel != cry::TYPE_DECODE_QUALITY_NO_NONREF)
+    {
+        std::cout << "the governor did not step down to a level that keeps up" << std::endl;
+        nErrors++;
+    }
+
+    /* slightly too slow: one step is enough, and it must not keep trying to go back up */
+    objGovernor.Reset(true);
+    nChanges = 0;
+    nLevel = Simulate(objGovernor, 0.045, 30000, &nChanges);
+    std::cout << "mildly overloaded: level " << nLevel << " after " << nChanges << " changes" << std::endl;
+    if (nLevel == cry::TYPE_DECODE_QUALITY_FULL || nChanges > 40)
+    {
+        std::cout << "the governor did not settle below full quality" << std::endl;
+        nErrors++;
+    }
+
+    /* the load goes away: back to full quality */
+    nLevel = Simulate(objGovernor, 0.010, 30000, &nChanges);
+    std::cout << "idle: level " << nLevel << std::endl;
+    if (nLevel != cry::TYPE_DECODE_QUALITY_FULL)
+    {
+        std::cout << "the governor did not return to full quality" << std::endl;
+        nErrors++;
+    }
+    return nErrors ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+
+#include "Common/Queue/CYPacketQueue.hpp"
+#include "ChainFilter/Common/CYSeekRequest.hpp"
+
+#define TEST_FRAME_US   40000
+#define TEST_GOP_US     1000000
+#define TEST_SEEK_US    1500
+#define TEST_DECODE_US  1000
+
+// A paused player scrubbed by 100 rapid seeks. The demux thread takes the newest target,
+// spends TEST_SEEK_US in a simulated avformat_seek_file (abandoned when a newer target
+// arrives, like DecodeInterruptCallBack does), restarts the queue at the keyframe before the
+// target and feeds 40ms frames. The decoder drops what SkipFrame rejects and "displays" the
+// first frame it keeps for a serial, as a paused player steps one frame after a seek.
+struct CYSeekPipeline
+{
+    cry::CYPacketQueue objQueue;
+    cry::CYSeekRequest objSeekReq;
+    std::atomic_bool bStop{ false };
+    std::atomic<uint64_t> nExecutedGeneration{ 0 };
+    std::atomic<int> nExecutedSerial{ -1 };
+    std::atomic<int> nExecuted{ 0 };
+    std::atomic<int> nInterrupted{ 0 };
+    std::atomic<int64_t> nDisplayedPts{ -1 };
+    std::atomic<int> nDisplayedSerial{ -1 };
+    std::atomic<int> nSkipped{ 0 };
+
+    void Demux()
+    {
+        AVPacketPtr ptrPkt = AVPacketPtrCreate();
+        int64_t nNextPts = -1;
+        while (!bStop)
+        {
+            cry::CYSeekTarget objSeek;
+            if (objSeekReq.Take(&objSeek))
+            {
+                bool bInterrupted = false;
+                for (int i = 0; i < TEST_SEEK_US / 500 && !bInterrupted; i++)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(500));
+                    bInterrupted = objSeekReq.Pending();
+                }
+                if (bInterrupted)
+                {
+                    nInterrupted++;
+                    objSeekReq.ClearDecodeTarget();
+                    continue;
+                }
+                objQueue.Flush();
+                nNextPts = objSeek.nPos / TEST_GOP_US * TEST_GOP_US;
+                objSeekReq.SetDecodeTarget(objSeek.nPos, objQueue.serial, -1, objSeek.nGeneration);
+                nExecutedSerial = objQueue.serial;
+                nExecutedGeneration = objSeek.nGeneration;
+                nExecuted++;
+            }
+            if (nNextPts < 0 || objQueue.NbPackets() >= 64)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            ptrPkt->size = 1024;
+            ptrPkt->pts = nNextPts;
+            ptrPkt->flags = nNextPts % TEST_GOP_US == 0 ? AV_PKT_FLAG_KEY : 0;
+            objQueue.Put(ptrPkt);
+            nNextPts += TEST_FRAME_US;
+        }
+    }
+
+    void Decode()
+    {
+        AVPacketPtr ptrPkt = AVPacketPtrCreate();
+        int nSerial = 0;
+        while (!bStop && objQueue.Get(ptrPkt, 1, &nSerial) > 0)
+        {
+            int64_t nPts = ptrPkt->pts;
+            av_packet_unref(ptrPkt.get());
+            std::this_thread::sleep_for(std::chrono::microseconds(TEST_DECODE_US));
+            if (objSeekReq.SkipFrame(false, nSerial, nPts + TEST_FRAME_US))
+            {
+                nSkipped++;
+                continue;
+            }
+            if (nDisplayedSerial != nSerial)
+            {
+                nDisplayedPts = nPts;
+                nDisplayedSerial = nSerial;
+            }
+        }
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    int nSeeks = argc > 1 ? atoi(argv[1]) : 100;
+    CYSeekPipeline objPipeline;
+    objPipeline.objQueue.Init();
+    objPipeline.objQueue.Start();
+
+    std::thread objDemux(&CYSeekPipeline::Demux, &objPipeline);
+    std::thread objDecode(&CYSeekPipeline::Decode, &objPipeline);
+
+    std::mt19937 objRandom(1234);
+    int64_t nLastTarget = 0;
+    uint64_t nLastGeneration = 0;
+    auto tStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < nSeeks; i++)
+    {
+        /* anywhere in a 10 minute file, on the frame grid */
+        nLastTarget = (int64_t)(objRandom() % (600000000 / TEST_FRAME_US)) * TEST_FRAME_US;
+        nLastGeneration = objPipeline.objSeekReq.Post(nLastTarget, 0, false, true);
+        std::this_thread::sleep_for(std::chrono::microseconds(objRandom() % 4000));
+    }
+
+    /* the newest target must be executed and its first kept frame displayed */
+    bool bSettled = false;
+    while (!bSettled && std::chrono::steady_clock::now() - tStart < std::chrono::seconds(5))
+    {
+        bSettled = objPipeline.nExecutedGeneration == nLastGeneration &&
+            objPipeline.nDisplayedSerial == objPipeline.nExecutedSerial;
+        if (!bSettled)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::chrono::duration<double, std::milli> tElapsed = std::chrono::steady_clock::now() - tStart;
+
+    objPipeline.bStop = true;
+    objPipeline.objQueue.Abort();
+    objDemux.join();
+    objDecode.join();
+    objPipeline.objQueue.Destroy();
+
+    int64_t nDisplayed = objPipeline.nDisplayedPts;
+    std::cout << "seeks: " << nSeeks
+        << "  executed: " << objPipeline.nExecuted
+        << "  interrupted: " << objPipeline.nInterrupted
+        << "  frames skipped: " << objPipeline.nSkipped
+        << "  settled after: " << tElapsed.count() << " ms" << std::endl;
+    std::cout << "last target: " << nLastTarget << "  displayed: " << nDisplayed << std::endl;
+
+    int nErrors = 0;
+    if (!bSettled)
+    {
+        std::cout << "the last seek was never displayed" << std::endl;
+        nErrors++;
+    }
+    else if (nDisplayed != nLastTarget)
+    {
+        std::cout << "displayed frame does not match the last seek" << std::endl;
+        nErrors++;
+    }
+    if (objPipeline.nExecuted >= nSeeks)
+    {
+        std::cout << "no seek was coalesced" << std::endl;
+        nErrors++;
+    }
+    return nErrors ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "CYPlayer/ICYPlayer.hpp"
+#include "CYPlayer/CYPlayerFactory.hpp"
+#include "CYPlayer/CYPlayerDefine.hpp"
+
+#define SEEK_LATENCY_TARGET_MS 50.0
+
+static std::atomic<int> g_nSeeksCompleted{ 0 };
+static std::atomic<double> g_fLastLatency{ 0 };
+
+void SeekEventCallback(const cry::EPlayerEventInfo* pEvent)
+{
+    if (pEvent && pEvent->eEventType == cry::TYPE_EVENT_SEEK_COMPLETED)
+    {
+        g_fLastLatency = pEvent->fSeekLatency;
+        g_nSeeksCompleted++;
+    }
+}
+
+// Seek-to-first-displayed-frame latency of a playing file, as reported by TYPE_EVENT_SEEK_COMPLETED.
+// Seeks are spread over the file and issued one at a time, each after the previous one was shown.
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <media_file_path> [seeks]" << std::endl;
+        return 1;
+    }
+    int nSeeks = argc > 2 ? atoi(argv[2]) : 20;
+
+    cry::ICYPlayer* pPlayer = cry::CYPlayerFactory::CreatePlayer();
+    if (!pPlayer)
+        return 1;
+    pPlayer->SetEventCallback(SeekEventCallback);
+
+    cry::EPlayerParam objParam;
+    objParam.eClockType = cry::TYPE_SYNC_CLOCK_AUDIO;
+    objParam.eVideoRenderType = cry::TYPE_VIDEO_RENDER_SDL;
+    objParam.eAudioRenderType = cry::TYPE_AUDIO_RENDER_SDL;
+    cry::EPlayerMediaParam objMediaParam;
+    if (pPlayer->Init(&objParam) != cry::ERR_SUCESS || pPlayer->Open(argv[1], &objMediaParam) != cry::ERR_SUCESS ||
+        pPlayer->Play() != cry::ERR_SUCESS)
+    {
+        std::cout << "cannot play " << argv[1] << std::endl;
+        cry::CYPlayerFactory::DestroyPlayer(pPlayer);
+        return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    int64_t nDuration = pPlayer->GetDuration();
+    std::vector<double> vecLatency;
+    for (int i = 0; i < nSeeks; i++)
+    {
+        /* jump back and forth so most seeks leave the queued packets */
+        int64_t nTarget = (i % 2 ? nDuration / 4 : nDuration / 2) + (int64_t)i * nDuration / (4 * nSeeks);
+        int nCompleted = g_nSeeksCompleted;
+        pPlayer->Seek(nTarget);
+
+        auto tStart = std::chrono::steady_clock::now();
+        while (g_nSeeksCompleted == nCompleted && std::chrono::steady_clock::now() - tStart < std::chrono::seconds(2))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (g_nSeeksCompleted == nCompleted)
+        {
+            std::cout << "seek to " << nTarget << " ms was never displayed" << std::endl;
+            continue;
+        }
+        vecLatency.push_back(g_fLastLatency);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    pPlayer->Stop();
+    pPlayer->UnInit();
+    cry::CYPlayerFactory::DestroyPlayer(pPlayer);
+
+    if (vecLatency.empty())
+        return 1;
+    std::sort(vecLatency.begin(), vecLatency.end());
+    double fP50 = vecLatency[vecLatency.size() / 2];
+    double fP90 = vecLatency[vecLatency.size() * 9 / 10];
+    std::cout << "seeks: " << vecLatency.size() << "/" << nSeeks
+        << "  p50: " << fP50 << " ms  p90: " << fP90 << " ms  max: " << vecLatency.back() << " ms"
+        << "  (target < " << SEEK_LATENCY_TARGET_MS << " ms: " << (fP90 < SEEK_LATENCY_TARGET_MS ? "met" : "missed") << ")" << std::endl;
+    return (int)vecLatency.size() == nSeeks ? 0 : 1;
+}
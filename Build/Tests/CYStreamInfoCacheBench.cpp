@@ -0,0 +1,105 @@
+#include <iostream>
+#include <chrono>
+
+#include "ChainFilter/Common/CYStreamInfoCache.hpp"
+
+// Time from avformat_open_input to the first decoded frame of the best video (or audio) stream.
+// A cold open probes with avformat_find_stream_info and stores the result, a warm open takes it
+// from the cache. pParams receives width/height/sample rate so both paths can be compared.
+double TimeToFirstFrame(const char* pszPath, bool bWarm, int64_t* pParams)
+{
+    AVFormatContext* pIC = nullptr;
+    AVCodecContext* pCodecCtx = nullptr;
+    AVPacket* pPkt = av_packet_alloc();
+    AVFrame* pFrame = av_frame_alloc();
+    double fSeconds = -1;
+    int nStream = -1;
+    bool bGotFrame = false;
+
+    auto tStart = std::chrono::steady_clock::now();
+    if (!pPkt || !pFrame || avformat_open_input(&pIC, pszPath, nullptr, nullptr) < 0)
+        goto end;
+    if (bWarm)
+    {
+        if (!cry::CYStreamInfoCache::Instance().Apply(pIC, pszPath, nullptr))
+        {
+            std::cout << "warm open missed the cache" << std::endl;
+            goto end;
+        }
+    }
+    else
+    {
+        if (avformat_find_stream_info(pIC, nullptr) < 0)
+            goto end;
+        cry::CYStreamInfoCache::Instance().Store(pIC, pszPath, nullptr);
+    }
+
+    nStream = av_find_best_stream(pIC, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (nStream < 0)
+        nStream = av_find_best_stream(pIC, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (nStream < 0)
+        goto end;
+    {
+        AVCodecParameters* par = pIC->streams[nStream]->codecpar;
+        const AVCodec* pCodec = avcodec_find_decoder(par->codec_id);
+        if (!pCodec || !(pCodecCtx = avcodec_alloc_context3(pCodec)) ||
+            avcodec_parameters_to_context(pCodecCtx, par) < 0 || avcodec_open2(pCodecCtx, pCodec, nullptr) < 0)
+            goto end;
+        pParams[0] = par->width;
+        pParams[1] = par->height;
+        pParams[2] = par->sample_rate;
+        pParams[3] = pIC->duration;
+    }
+
+    while (!bGotFrame && av_read_frame(pIC, pPkt) >= 0)
+    {
+        if (pPkt->stream_index == nStream && avcodec_send_packet(pCodecCtx, pPkt) >= 0)
+            bGotFrame = avcodec_receive_frame(pCodecCtx, pFrame) >= 0;
+        av_packet_unref(pPkt);
+    }
+    if (bGotFrame)
+    {
+        std::chrono::duration<double> tElapsed = std::chrono::steady_clock::now() - tStart;
+        fSeconds = tElapsed.count();
+    }
+
+end:
+    avcodec_free_context(&pCodecCtx);
+    avformat_close_input(&pIC);
+    av_frame_free(&pFrame);
+    av_packet_free(&pPkt);
+    return fSeconds;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "usage: CYStreamInfoCacheBench <local media file> [rounds]" << std::endl;
+        return 1;
+    }
+    int nRounds = argc > 2 ? atoi(argv[2]) : 5;
+    av_log_set_level(AV_LOG_ERROR);
+
+    int nErrors = 0;
+    double fColdTotal = 0, fWarmTotal = 0;
+    for (int i = 0; i < nRounds; i++)
+    {
+        int64_t arrCold[4] = { 0 }, arrWarm[4] = { 0 };
+        cry::CYStreamInfoCache::Instance().Clear();
+        double fCold = TimeToFirstFrame(argv[1], false, arrCold);
+        double fWarm = TimeToFirstFrame(argv[1], true, arrWarm);
+        if (fCold < 0 || fWarm < 0 || memcmp(arrCold, arrWarm, sizeof(arrCold)))
+            nErrors++;
+        fColdTotal += fCold;
+        fWarmTotal += fWarm;
+
+        std::cout << "round " << i
+            << "  cold: " << fCold * 1000 << " ms"
+            << "  warm: " << fWarm * 1000 << " ms" << std::endl;
+    }
+    std::cout << "time to first frame  cold: " << fColdTotal * 1000 / nRounds << " ms"
+        << "  warm: " << fWarmTotal * 1000 / nRounds << " ms" << std::endl;
+
+    return nErrors ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "CYPlayer/ICYPlayer.hpp"
+#include "CYPlayer/CYPlayerFactory.hpp"
+#include "CYPlayer/CYPlayerDefine.hpp"
+
+static double ProcessCpuSeconds()
+{
+#ifdef _WIN32
+    FILETIME tCreate, tExit, tKernel, tUser;
+    if (!GetProcessTimes(GetCurrentProcess(), &tCreate, &tExit, &tKernel, &tUser))
+        return 0;
+    ULARGE_INTEGER nKernel, nUser;
+    nKernel.LowPart = tKernel.dwLowDateTime;
+    nKernel.HighPart = tKernel.dwHighDateTime;
+    nUser.LowPart = tUser.dwLowDateTime;
+    nUser.HighPart = tUser.dwHighDateTime;
+    return (nKernel.QuadPart + nUser.QuadPart) / 10000000.0;
+#else
+    struct rusage objUsage;
+    if (getrusage(RUSAGE_SELF, &objUsage) != 0)
+        return 0;
+    return objUsage.ru_utime.tv_sec + objUsage.ru_stime.tv_sec + (objUsage.ru_utime.tv_usec + objUsage.ru_stime.tv_usec) / 1000000.0;
+#endif
+}
+
+// Plays nSeconds at fSpeed from nStart, returns the CPU seconds used per wall second and
+// the media time covered per wall second.
+static bool Measure(cry::ICYPlayer* pPlayer, float fSpeed, int64_t nStart, int nSeconds, double* pCpuLoad, double* pRate)
+{
+    if (pPlayer->SetSpeed(fSpeed) != cry::ERR_SUCESS)
+        return false;
+    pPlayer->Seek(nStart);
+    /* let the seek and the speed change settle before measuring */
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    int64_t nPosStart = pPlayer->GetPosition();
+    double fCpuStart = ProcessCpuSeconds();
+    auto tStart = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(nSeconds));
+    std::chrono::duration<double> tElapsed = std::chrono::steady_clock::now() - tStart;
+
+    *pCpuLoad = (ProcessCpuSeconds() - fCpuStart) / tElapsed.count();
+    *pRate = (pPlayer->GetPosition() - nPosStart) / 1000.0 / tElapsed.count();
+    return true;
+}
+
+// CPU load of a file played at normal speed and fast forward, which should not cost more:
+// 2x-4x skips non-reference pictures, 8x and up shows a few keyframes per second.
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <media_file_path> [speed] [seconds]" << std::endl;
+        return 1;
+    }
+    float fSpeed = argc > 2 ? (float)atof(argv[2]) : 32.0f;
+    int nSeconds = argc > 3 ? atoi(argv[3]) : 5;
+
+    cry::ICYPlayer* pPlayer = cry::CYPlayerFactory::CreatePlayer();
+    if (!pPlayer)
+        return 1;
+
+    cry::EPlayerParam objParam;
+    objParam.eClockType = cry::TYPE_SYNC_CLOCK_AUDIO;
+    objParam.eVideoRenderType = cry::TYPE_VIDEO_RENDER_SDL;
+    objParam.eAudioRenderType = cry::TYPE_AUDIO_RENDER_SDL;
+    cry::EPlayerMediaParam objMediaParam;
+    if (pPlayer->Init(&objParam) != cry::ERR_SUCESS || pPlayer->Open(argv[1], &objMediaParam) != cry::ERR_SUCESS ||
+        pPlayer->Play() != cry::ERR_SUCESS)
+    {
+        std::cout << "cannot play " << argv[1] << std::endl;
+        cry::CYPlayerFactory::DestroyPlayer(pPlayer);
+        return 1;
+    }
+
+    /* the fast forward part starts early enough to stay inside the file */
+    int64_t nDuration = pPlayer->GetDuration();
+    double fNormalLoad = 0, fNormalRate = 0, fFastLoad = 0, fFastRate = 0;
+    bool bMeasured = Measure(pPlayer, 1.0f, nDuration / 10, nSeconds, &fNormalLoad, &fNormalRate) &&
+        Measure(pPlayer, fSpeed, nDuration / 10, nSeconds, &fFastLoad, &fFastRate);
+
+    pPlayer->Stop();
+    pPlayer->UnInit();
+    cry::CYPlayerFactory::DestroyPlayer(pPlayer);
+
+    if (!bMeasured)
+    {
+        std::cout << "speed " << fSpeed << " was refused" << std::endl;
+        return 1;
+    }
+    std::cout << "1x:  cpu " << fNormalLoad * 100 << "%  media " << fNormalRate << " s/s" << std::endl;
+    std::cout << fSpeed << "x:  cpu " << fFastLoad * 100 << "%  media " << fFastRate << " s/s"
+        << "  (cpu not above 1x: " << (fFastLoad <= fNormalLoad * 1.1 ? "met" : "missed") << ")" << std::endl;
+    return fFastLoad <= fNormalLoad * 1.1 ? 0 : 1;
+}
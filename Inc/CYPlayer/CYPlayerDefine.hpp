@@ -89,6 +89,8 @@ enum EEventType
     TYPE_EVENT_ERROR_OCCURRED,
     TYPE_EVENT_BUFFERING_STARTED,
     TYPE_EVENT_BUFFERING_ENDED,
+    TYPE_EVENT_SEEK_COMPLETED,      // The first frame after a seek was displayed.
+    TYPE_EVENT_MEDIA_CHANGED,       // Playback moved on to the next playlist item.
 };
 
 /**
@@ -188,6 +190,7 @@ struct EPlayerEventInfo
     int nErrorCode;
     char szMessage[512];
     double fBufferProgress;     // Buffer Progress0~1
+    double fSeekLatency;        // TYPE_EVENT_SEEK_COMPLETED: ms from the seek request to its first displayed frame
 };
 
 /**
@@ -231,6 +234,49 @@ struct EPlayerMediaParam
     char szForceSubtitleCodecName[256] = { 0 };
     char szForceVideoCodecName[256] = { 0 };
     char szHWAccel[256] = { 0 };     // use HW accelerated decoding.
+
+    int nVideoQueueDepth = 3;        // decoded pictures buffered ahead of the renderer, including the one on screen.
+    int nAudioQueueDepth = 9;        // decoded audio frames buffered ahead of the audio device.
+    int nSubtitleQueueDepth = 16;    // decoded subtitles buffered ahead of the renderer.
+    bool bAdaptiveVideoQueue = false;// grow/shrink the picture queue from decode jitter and late drops.
+    int nVideoQueueMinDepth = 2;     // adaptive picture queue lower bound.
+    int nVideoQueueMaxDepth = 16;    // adaptive picture queue upper bound (at most 64).
+    bool bFrameBufferPool = true;    // decode software video into player-owned, reused 64-byte aligned buffers.
+    bool bHugePageFrames = false;    // back pooled frame buffers with huge pages when the OS allows it.
+    bool bMappedFileIO = false;      // read local files through a memory mapping instead of the file protocol; for files nothing rewrites during playback.
+    int64_t nReadAheadSize = 0;      // bytes cached ahead of the demuxer by a separate I/O thread (NFS, slow disks), 0 = off.
+    bool bKeyframeIndex = false;     // learn keyframe byte offsets while demuxing, seek through them when the container has no index.
+    bool bStreamInfoCache = false;   // reuse the stream probe of a local file opened before instead of avformat_find_stream_info.
+    char szIndexCacheDir[256] = { 0 };// directory keeping keyframe indexes and stream probes of local files across runs, empty = memory only.
+    int nDecodePriority = 1;         // share of the process-wide decode thread budget: 0 low, 1 normal, 2 high.
+    bool bAdaptiveQuality = false;   // make the video decoder skip work (deblocking, non-reference frames) while it falls behind.
+    int64_t nReverseCacheSize = 0;   // bytes of decoded frames held for reverse playback and StepBack, 0 = 256 MB.
+};
+
+/**
+ * Video decode quality, lowered step by step while the decoder falls behind (bAdaptiveQuality).
+ */
+enum EDecodeQuality
+{
+    TYPE_DECODE_QUALITY_FULL = 0,       // every frame fully decoded.
+    TYPE_DECODE_QUALITY_FAST,           // codec speedups that are not bit-exact, no deblocking of non-reference frames.
+    TYPE_DECODE_QUALITY_NO_DEBLOCK,     // no in-loop deblocking filter at all.
+    TYPE_DECODE_QUALITY_NO_IDCT,        // also no IDCT for non-reference frames.
+    TYPE_DECODE_QUALITY_NO_NONREF,      // non-reference frames are not decoded.
+};
+
+/**
+ * Memory Usage, in bytes.
+ */
+struct EPlayerMemoryUsage
+{
+    int64_t nPacketBytes = 0;        // demuxed packets waiting to be decoded.
+    int64_t nFrameBytes = 0;         // decoded frames waiting to be rendered.
+    int64_t nTextureBytes = 0;       // video/subtitle/visualization textures.
+    int64_t nAudioBytes = 0;         // resampled audio buffers.
+    int64_t nTotalBytes = 0;
+    int64_t nLimitBytes = 0;         // what may be used right now, 0 when unlimited.
+    bool bUnderPressure = false;     // read-ahead (and maybe frame queues) is currently cut to stay under the limit.
 };
 
 /**
@@ -272,6 +318,13 @@ enum ERetCode
     ERR_PLAYER_PARAM_NOT_VARIABLE = 23, 
     ERR_OPEN_MEDIA_ERROR = 24,
     ERR_SETDISPLAYSIZE_ERROR = 25,
+    ERR_SETMEMORYQUOTA_FAILED = 26,
+    ERR_GETMEMORYUSAGE_FAILED = 27,
+    ERR_SCRUB_FAILED = 28,
+    ERR_PLAYLIST_FAILED = 29,
+    ERR_SETTHREADBUDGET_FAILED = 30,
+    ERR_GETDECODEQUALITY_FAILED = 31,
+    ERR_STEPBACK_FAILED = 32,
 };
 
 CYPLAYER_NAMESPACE_END
@@ -57,6 +57,20 @@ public:
 public:
     static ICYPlayer* CreatePlayer();
     static void DestroyPlayer(ICYPlayer*& pDevice);
+
+    /**
+     * Process-wide memory budget shared fairly by all players, 0 for unlimited.
+     */
+    static int16_t SetMemoryBudget(int64_t nBytes);
+    static int64_t GetMemoryBudget();
+    static int16_t GetMemoryUsage(EPlayerMemoryUsage* pUsage);
+
+    /**
+     * Process-wide budget of codec threads split among the video decoders of all players by
+     * resolution and EPlayerMediaParam::nDecodePriority, 0 lets every decoder use one per core.
+     */
+    static int16_t SetDecodeThreadBudget(int nThreads);
+    static int GetDecodeThreadBudget();
 };
 
 CYPLAYER_NAMESPACE_END
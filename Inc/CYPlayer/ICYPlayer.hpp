@@ -75,6 +75,16 @@ public:
      */
     virtual int16_t Open(const char* pszURL, EPlayerMediaParam* pParam) = 0;
 
+    /**
+     * Gapless playlist: items queued after the opened one are opened in the background and played
+     * without a gap, on the same audio device and window. Positions and the duration are those of the
+     * item on screen, TYPE_EVENT_MEDIA_CHANGED reports each switch. An item whose streams differ from
+     * the current one (audio, video or cover picture) is skipped with TYPE_EVENT_ERROR_OCCURRED.
+     * Open starts a new, empty playlist.
+     */
+    virtual int16_t AddToPlaylist(const char* pszURL) = 0;
+    virtual int16_t ClearPlaylist() = 0;
+
     /**
      * Playback control.
      */
@@ -98,10 +108,33 @@ public:
      * Jump to the specified position (seconds).
      */
     virtual int16_t Seek(int64_t nTimestamp) = 0;
+
+    /**
+     * Timeline scrubbing (milliseconds): while scrubbing, ScrubTo shows the keyframe nearest to each
+     * position with audio muted, EndScrub seeks accurately to the last one and restores playback.
+     * bLowQuality also skips the in-loop deblocking filter for a cheaper, blockier preview.
+     */
+    virtual int16_t BeginScrub(bool bLowQuality) = 0;
+    virtual int16_t ScrubTo(int64_t nTimestamp) = 0;
+    virtual int16_t EndScrub() = 0;
+
     virtual int16_t SetMute(bool bMute) = 0;
     virtual int16_t SetLoop(bool bLoop) = 0;
+
+    /**
+     * Playback speed, 0.5 ~ 64.0, or -1.0 to play backwards at normal speed. Audio is time-stretched
+     * up to 2x and muted above and backwards; from 2x on non-reference video frames are skipped,
+     * from 8x on only keyframes are shown. Backwards, each GOP is decoded ahead into a cache of
+     * EPlayerMediaParam::nReverseCacheSize bytes.
+     */
     virtual int16_t SetSpeed(float fSpeed) = 0;
 
+    /**
+     * Show the previous frame and pause. Further StepBack calls, and stepping, go on backwards
+     * until playback is resumed, which continues forward from the frame on screen.
+     */
+    virtual int16_t StepBack() = 0;
+
     /**
      * Volume control.0.0 ~ 1.0
      */
@@ -114,6 +147,19 @@ public:
     virtual int16_t SetVideoMirror(bool bMirror) = 0;
     virtual int16_t SetAspectRatio(float fRatio) = 0;
 
+    /**
+     * Memory quota / usage.
+     * The quota caps this player on top of its share of CYPlayerFactory::SetMemoryBudget, 0 for none.
+     */
+    virtual int16_t SetMemoryQuota(int64_t nBytes) = 0;
+    virtual int16_t GetMemoryUsage(EPlayerMemoryUsage* pUsage) = 0;
+
+    /**
+     * Video decode quality: TYPE_DECODE_QUALITY_FULL unless EPlayerMediaParam::bAdaptiveQuality let
+     * the player skip decoding work while it could not keep up.
+     */
+    virtual int16_t GetDecodeQuality(EDecodeQuality* peQuality) = 0;
+
     /**
      * Event callback settings.
      */
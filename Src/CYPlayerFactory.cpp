@@ -1,5 +1,7 @@
 #include "CYPlayer/CYPlayerFactory.hpp"
 #include "CYPlayerImpl.hpp"
+#include "Common/Memory/CYMemoryBudget.hpp"
+#include "Common/Thread/CYThreadBudget.hpp"
 
 CYPLAYER_NAMESPACE_BEGIN
 
@@ -25,4 +27,48 @@ void CYPlayerFactory::DestroyPlayer(ICYPlayer*& pDevice)
     }
 }
 
+int16_t CYPlayerFactory::SetMemoryBudget(int64_t nBytes)
+{
+    if (nBytes < 0)
+        return ERR_SETMEMORYQUOTA_FAILED;
+
+    CYMemoryBudget::Instance().SetBudget(nBytes);
+    return ERR_SUCESS;
+}
+
+int64_t CYPlayerFactory::GetMemoryBudget()
+{
+    return CYMemoryBudget::Instance().GetBudget();
+}
+
+int16_t CYPlayerFactory::GetMemoryUsage(EPlayerMemoryUsage* pUsage)
+{
+    if (!pUsage)
+        return ERR_GETMEMORYUSAGE_FAILED;
+
+    CYMemoryBudget& objBudget = CYMemoryBudget::Instance();
+    pUsage->nPacketBytes = objBudget.Usage(TYPE_MEMORY_PACKETS);
+    pUsage->nFrameBytes = objBudget.Usage(TYPE_MEMORY_FRAMES);
+    pUsage->nTextureBytes = objBudget.Usage(TYPE_MEMORY_TEXTURES);
+    pUsage->nAudioBytes = objBudget.Usage(TYPE_MEMORY_AUDIO);
+    pUsage->nTotalBytes = objBudget.Usage();
+    pUsage->nLimitBytes = objBudget.GetBudget();
+    pUsage->bUnderPressure = objBudget.GetBudget() && pUsage->nTotalBytes > objBudget.GetBudget();
+    return ERR_SUCESS;
+}
+
+int16_t CYPlayerFactory::SetDecodeThreadBudget(int nThreads)
+{
+    if (nThreads < 0)
+        return ERR_SETTHREADBUDGET_FAILED;
+
+    CYThreadBudget::Instance().SetBudget(nThreads);
+    return ERR_SUCESS;
+}
+
+int CYPlayerFactory::GetDecodeThreadBudget()
+{
+    return CYThreadBudget::Instance().GetBudget();
+}
+
 CYPLAYER_NAMESPACE_END
\ No newline at end of file
@@ -46,6 +46,19 @@ int16_t CYPlayerImpl::Open(const char* pszURL, EPlayerMediaParam* pParam)
     return m_ptrChainFilterManager->Open(pszURL, pParam);;
 }
 
+/**
+* Gapless playlist.
+*/
+int16_t CYPlayerImpl::AddToPlaylist(const char* pszURL)
+{
+    return m_ptrChainFilterManager->AddToPlaylist(pszURL);
+}
+
+int16_t CYPlayerImpl::ClearPlaylist()
+{
+    return m_ptrChainFilterManager->ClearPlaylist();
+}
+
 /**
 * Playback control.
 */
@@ -98,6 +111,24 @@ int16_t CYPlayerImpl::Seek(int64_t nTimestamp)
     return m_ptrChainFilterManager->Seek(nTimestamp);
 }
 
+/**
+* Timeline scrubbing.
+*/
+int16_t CYPlayerImpl::BeginScrub(bool bLowQuality)
+{
+    return m_ptrChainFilterManager->BeginScrub(bLowQuality);
+}
+
+int16_t CYPlayerImpl::ScrubTo(int64_t nTimestamp)
+{
+    return m_ptrChainFilterManager->ScrubTo(nTimestamp);
+}
+
+int16_t CYPlayerImpl::EndScrub()
+{
+    return m_ptrChainFilterManager->EndScrub();
+}
+
 int16_t CYPlayerImpl::SetMute(bool bMute)
 {
     return m_ptrChainFilterManager->SetMute(bMute);
@@ -113,6 +144,11 @@ int16_t CYPlayerImpl::SetSpeed(float fSpeed)
     return m_ptrChainFilterManager->SetSpeed(fSpeed);
 }
 
+int16_t CYPlayerImpl::StepBack()
+{
+    return m_ptrChainFilterManager->StepBack();
+}
+
 /**
 * Volume control.0.0 ~ 1.0
 */
@@ -147,6 +183,24 @@ int16_t CYPlayerImpl::SetAspectRatio(float fRatio)
     return m_ptrChainFilterManager->SetAspectRatio(fRatio);
 }
 
+/**
+* Memory quota / usage.
+*/
+int16_t CYPlayerImpl::SetMemoryQuota(int64_t nBytes)
+{
+    return m_ptrChainFilterManager->SetMemoryQuota(nBytes);
+}
+
+int16_t CYPlayerImpl::GetMemoryUsage(EPlayerMemoryUsage* pUsage)
+{
+    return m_ptrChainFilterManager->GetMemoryUsage(pUsage);
+}
+
+int16_t CYPlayerImpl::GetDecodeQuality(EDecodeQuality* peQuality)
+{
+    return m_ptrChainFilterManager->GetDecodeQuality(peQuality);
+}
+
 /**
 * Event callback settings.
 */
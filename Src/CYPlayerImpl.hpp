@@ -73,6 +73,12 @@ public:
      */
     virtual int16_t Open(const char* pszURL, EPlayerMediaParam* pParam) override;
 
+    /**
+     * Gapless playlist.
+     */
+    virtual int16_t AddToPlaylist(const char* pszURL) override;
+    virtual int16_t ClearPlaylist() override;
+
     /**
      * Playback control.
      */
@@ -96,9 +102,18 @@ public:
      * Jump to the specified position (seconds).
      */
     virtual int16_t Seek(int64_t nTimestamp) override;
+
+    /**
+     * Timeline scrubbing.
+     */
+    virtual int16_t BeginScrub(bool bLowQuality) override;
+    virtual int16_t ScrubTo(int64_t nTimestamp) override;
+    virtual int16_t EndScrub() override;
+
     virtual int16_t SetMute(bool bMute) override;
     virtual int16_t SetLoop(bool bLoop) override;
     virtual int16_t SetSpeed(float fSpeed) override;
+    virtual int16_t StepBack() override;
 
     /**
      * Volume control.0.0 ~ 1.0
@@ -112,6 +127,17 @@ public:
     virtual int16_t SetVideoMirror(bool bMirror) override;
     virtual int16_t SetAspectRatio(float fRatio) override;
 
+    /**
+     * Memory quota / usage.
+     */
+    virtual int16_t SetMemoryQuota(int64_t nBytes) override;
+    virtual int16_t GetMemoryUsage(EPlayerMemoryUsage* pUsage) override;
+
+    /**
+     * Current video decode quality of the load governor.
+     */
+    virtual int16_t GetDecodeQuality(EDecodeQuality* peQuality) override;
+
     /**
      * Event callback settings.
      */
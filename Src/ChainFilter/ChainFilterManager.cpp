@@ -183,6 +183,22 @@ int16_t CChainFilterManager::Open(const char* pszURL, EPlayerMediaParam* pParam)
         strcpy(m_ptrContext->szForceSubtitleCodecName, pParam->szForceSubtitleCodecName);
         strcpy(m_ptrContext->szForceVideoCodecName, pParam->szForceVideoCodecName);
         strcpy(m_ptrContext->szHWAccel, pParam->szHWAccel);
+        m_ptrContext->nVideoQueueDepth = pParam->nVideoQueueDepth > 0 ? pParam->nVideoQueueDepth : VIDEO_PICTURE_QUEUE_SIZE;
+        m_ptrContext->nAudioQueueDepth = pParam->nAudioQueueDepth > 0 ? pParam->nAudioQueueDepth : SAMPLE_QUEUE_SIZE;
+        m_ptrContext->nSubtitleQueueDepth = pParam->nSubtitleQueueDepth > 0 ? pParam->nSubtitleQueueDepth : SUBPICTURE_QUEUE_SIZE;
+        m_ptrContext->bAdaptiveVideoQueue = pParam->bAdaptiveVideoQueue;
+        m_ptrContext->nVideoQueueMinDepth = pParam->nVideoQueueMinDepth;
+        m_ptrContext->nVideoQueueMaxDepth = pParam->nVideoQueueMaxDepth;
+        m_ptrContext->bFrameBufferPool = pParam->bFrameBufferPool;
+        m_ptrContext->bHugePageFrames = pParam->bHugePageFrames;
+        m_ptrContext->bMappedFileIO = pParam->bMappedFileIO;
+        m_ptrContext->nReadAheadSize = pParam->nReadAheadSize;
+        m_ptrContext->bKeyframeIndex = pParam->bKeyframeIndex;
+        m_ptrContext->bStreamInfoCache = pParam->bStreamInfoCache;
+        av_strlcpy(m_ptrContext->szCacheDir, pParam->szIndexCacheDir, sizeof(m_ptrContext->szCacheDir));
+        m_ptrContext->nDecodePriority = pParam->nDecodePriority;
+        m_ptrContext->bAdaptiveQuality = pParam->bAdaptiveQuality;
+        m_ptrContext->nReverseCacheSize = pParam->nReverseCacheSize > 0 ? pParam->nReverseCacheSize : REVERSE_GOP_CACHE_SIZE;
 
         if (m_ptrSourceFilter)
         {
@@ -206,6 +222,48 @@ int16_t CChainFilterManager::Open(const char* pszURL, EPlayerMediaParam* pParam)
     return ERR_OPEN_ERROR;
 }
 
+/**
+ * Gapless playlist: the demux thread takes the queued URLs one at a time and preloads them.
+ */
+int16_t CChainFilterManager::AddToPlaylist(const char* pszURL)
+{
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(m_eStateType < TYPE_STATUS_PREPARED || m_eStateType > TYPE_STATUS_PAUSED, "Player Has No Media Open.");
+        IfTrueThrow(!pszURL || !strlen(pszURL), "URL is empty.");
+
+        {
+            UniqueLock locker(m_ptrContext->mutexPlaylist);
+            m_ptrContext->deqPlaylist.push_back(pszURL);
+        }
+        if (m_ptrContext->ptrReadCond)
+            m_ptrContext->ptrReadCond->NotifyOne();
+        return ERR_SUCESS;
+    }
+    EXCEPTION_END;
+
+    return ERR_PLAYLIST_FAILED;
+}
+
+int16_t CChainFilterManager::ClearPlaylist()
+{
+    EXCEPTION_BEGIN
+    {
+        {
+            UniqueLock locker(m_ptrContext->mutexPlaylist);
+            m_ptrContext->deqPlaylist.clear();
+        }
+        /* an item already preloading is dropped by the demux thread */
+        m_ptrContext->bPlaylistCleared = true;
+        if (m_ptrContext->ptrReadCond)
+            m_ptrContext->ptrReadCond->NotifyOne();
+        return ERR_SUCESS;
+    }
+    EXCEPTION_END;
+
+    return ERR_PLAYLIST_FAILED;
+}
+
 /**
  * Playback control.
  */
@@ -374,6 +432,63 @@ int16_t CChainFilterManager::Seek(int64_t nTimestamp)
     return ERR_SEEK_FAILED;
 }
 
+/**
+ * Timeline scrubbing: playback is held while the user drags, the public state does not change.
+ */
+int16_t CChainFilterManager::BeginScrub(bool bLowQuality)
+{
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow((m_eStateType != TYPE_STATUS_PLAYING && m_eStateType != TYPE_STATUS_PAUSED), "Player Is Not Playing Or Paused State.");
+
+        auto ptrDemuxFilter = std::dynamic_pointer_cast<CYDemuxFilter>(m_ptrDemuxFilter);
+        IfTrueThrow(!ptrDemuxFilter, "variable is conver failed.");
+        IfTrueThrow(ptrDemuxFilter->IsScrubbing(), "Scrub is already in progress.");
+
+        m_bScrubResume = m_eStateType == TYPE_STATUS_PLAYING;
+        if (m_bScrubResume)
+            m_ptrFirstFilter->Pause();
+        return ptrDemuxFilter->BeginScrub(bLowQuality);
+    }
+    EXCEPTION_END;
+
+    return ERR_SCRUB_FAILED;
+}
+
+int16_t CChainFilterManager::ScrubTo(int64_t nTimestamp)
+{
+    EXCEPTION_BEGIN
+    {
+        auto ptrDemuxFilter = std::dynamic_pointer_cast<CYDemuxFilter>(m_ptrDemuxFilter);
+        IfTrueThrow(!ptrDemuxFilter, "variable is conver failed.");
+        IfTrueThrow(!ptrDemuxFilter->IsScrubbing(), "BeginScrub was not called.");
+
+        return ptrDemuxFilter->ScrubTo(nTimestamp);
+    }
+    EXCEPTION_END;
+
+    return ERR_SCRUB_FAILED;
+}
+
+int16_t CChainFilterManager::EndScrub()
+{
+    EXCEPTION_BEGIN
+    {
+        auto ptrDemuxFilter = std::dynamic_pointer_cast<CYDemuxFilter>(m_ptrDemuxFilter);
+        IfTrueThrow(!ptrDemuxFilter, "variable is conver failed.");
+        IfTrueThrow(!ptrDemuxFilter->IsScrubbing(), "BeginScrub was not called.");
+
+        int16_t nRet = ptrDemuxFilter->EndScrub();
+        if (m_bScrubResume && m_eStateType == TYPE_STATUS_PLAYING)
+            m_ptrFirstFilter->Resume();
+        m_bScrubResume = false;
+        return nRet;
+    }
+    EXCEPTION_END;
+
+    return ERR_SCRUB_FAILED;
+}
+
 int16_t CChainFilterManager::SetMute(bool bMute)
 {
     EXCEPTION_BEGIN
@@ -423,13 +538,14 @@ int16_t CChainFilterManager::SetSpeed(float fSpeed)
     EXCEPTION_BEGIN
     {
         IfTrueThrow(m_eStateType == TYPE_STATUS_IDLE, "Player State is TYPE_STATUS_IDLE.");
+        IfTrueThrow(!(fSpeed == REVERSE_PLAY_SPEED || (fSpeed >= TRICK_PLAY_MIN_SPEED && fSpeed <= TRICK_PLAY_MAX_SPEED)), "Speed is out of range.");
 
-        if (m_ptrAudioRenderFilter)
+        if (m_ptrDemuxFilter)
         {
-            auto ptrAudioRenderFilter = std::dynamic_pointer_cast<CYAudioRenderFilter>(m_ptrAudioRenderFilter);
-            if (ptrAudioRenderFilter)
+            auto ptrDemuxFilter = std::dynamic_pointer_cast<CYDemuxFilter>(m_ptrDemuxFilter);
+            if (ptrDemuxFilter)
             {
-               return ptrAudioRenderFilter->SetSpeed(fSpeed);
+               return ptrDemuxFilter->SetSpeed(fSpeed);
             }
             return ERR_VARIABLE_CONVER_FAILED;
         }
@@ -440,6 +556,28 @@ int16_t CChainFilterManager::SetSpeed(float fSpeed)
     return ERR_SETSPEED_FAILED;
 }
 
+int16_t CChainFilterManager::StepBack()
+{
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(m_eStateType == TYPE_STATUS_IDLE, "Player State is TYPE_STATUS_IDLE.");
+
+        if (m_ptrDemuxFilter)
+        {
+            auto ptrDemuxFilter = std::dynamic_pointer_cast<CYDemuxFilter>(m_ptrDemuxFilter);
+            if (ptrDemuxFilter)
+            {
+               return ptrDemuxFilter->StepBack();
+            }
+            return ERR_VARIABLE_CONVER_FAILED;
+        }
+        return ERR_NOT_INIT;
+    }
+    EXCEPTION_END;
+
+    return ERR_STEPBACK_FAILED;
+}
+
 /**
  * Volume control.0.0 ~ 1.0
  */
@@ -576,6 +714,61 @@ int16_t CChainFilterManager::SetAspectRatio(float fRatio)
     return ERR_SETASPECT_RATIO_ERROR;
 }
 
+/**
+ * Memory quota / usage.
+ */
+int16_t CChainFilterManager::SetMemoryQuota(int64_t nBytes)
+{
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(!m_ptrContext, "Player is not initialized.");
+        IfTrueThrow(nBytes < 0, "Memory quota must not be negative.");
+
+        m_ptrContext->objMemAccount.SetQuota(nBytes);
+        return ERR_SUCESS;
+    }
+    EXCEPTION_END;
+
+    return ERR_SETMEMORYQUOTA_FAILED;
+}
+
+int16_t CChainFilterManager::GetMemoryUsage(EPlayerMemoryUsage* pUsage)
+{
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(!m_ptrContext, "Player is not initialized.");
+        IfTrueThrow(!pUsage, "Memory usage pointer is null.");
+
+        CYMemoryAccount& objAccount = m_ptrContext->objMemAccount;
+        pUsage->nPacketBytes = objAccount.Usage(TYPE_MEMORY_PACKETS);
+        pUsage->nFrameBytes = objAccount.Usage(TYPE_MEMORY_FRAMES);
+        pUsage->nTextureBytes = objAccount.Usage(TYPE_MEMORY_TEXTURES);
+        pUsage->nAudioBytes = objAccount.Usage(TYPE_MEMORY_AUDIO);
+        pUsage->nTotalBytes = objAccount.Usage();
+        pUsage->nLimitBytes = objAccount.Allowance();
+        pUsage->bUnderPressure = objAccount.Pressure() != TYPE_MEMORY_PRESSURE_NONE;
+        return ERR_SUCESS;
+    }
+    EXCEPTION_END;
+
+    return ERR_GETMEMORYUSAGE_FAILED;
+}
+
+int16_t CChainFilterManager::GetDecodeQuality(EDecodeQuality* peQuality)
+{
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(!m_ptrContext, "Player is not initialized.");
+        IfTrueThrow(!peQuality, "Decode quality pointer is null.");
+
+        *peQuality = m_ptrContext->objQualityGovernor.Level();
+        return ERR_SUCESS;
+    }
+    EXCEPTION_END;
+
+    return ERR_GETDECODEQUALITY_FAILED;
+}
+
 /**
  * Event callback settings.
  */
@@ -619,12 +812,29 @@ int16_t CChainFilterManager::ResetContext(SharePtr<CYMediaContext>& ptrContext)
     ptrContext->bPaused = false;
     ptrContext->nLastPaused = 0;
     ptrContext->nQueueAttachmentsReq = 0;
-    ptrContext->bSeekReq = false;
+    ptrContext->objSeekReq.Reset();
+    ptrContext->bSeeking = false;
+    ptrContext->nScrubMode = SCRUB_MODE_NONE;
+    ptrContext->fPlaybackSpeed = 1.0;
+    ptrContext->nTrickMode = TRICK_MODE_NONE;
+    ptrContext->nStepBackReq = 0;
+    ptrContext->bReversing = false;
+    ptrContext->bAccurate = false;
     ptrContext->nSeekFlags = 0;
     ptrContext->nSeekPos = 0;
     ptrContext->nSeekRel = 0;
     ptrContext->nReadPauseReturn = 0;
+    {
+        UniqueLock locker(ptrContext->mutexPlaylist);
+        ptrContext->deqPlaylist.clear();
+    }
+    ptrContext->bPlaylistCleared = false;
     ptrContext->ptrIC.reset();
+    ptrContext->ptrMappedIO.reset();
+    ptrContext->ptrReadAheadIO.reset();
+    ptrContext->vecRetiredItems.clear();
+    ptrContext->ptrPlaylistItem.reset();
+    ptrContext->objTimeline.Reset(AV_NOPTS_VALUE, 0);
     ptrContext->bRealTime = false;
     ptrContext->audclk = {};
     ptrContext->vidclk = {};
@@ -656,6 +866,7 @@ int16_t CChainFilterManager::ResetContext(SharePtr<CYMediaContext>& ptrContext)
 
     ptrContext->ptrAudioBuffer1.reset();
     ptrContext->nAudioBuf1Size = 0;
+    ptrContext->objAudioBufMem.Set(0);
     ptrContext->nAudioBufIndex = 0; /* in bytes */
     ptrContext->nAudioWriteBufSize = 0;
     ptrContext->nAudioVolume = 100;
@@ -666,9 +877,12 @@ int16_t CChainFilterManager::ResetContext(SharePtr<CYMediaContext>& ptrContext)
     ptrContext->ptrSwrCtx.reset();
     ptrContext->nFrameDropsEarly = 0;
     ptrContext->nFrameDropsLate = 0;
+    ptrContext->nPacketDropsLate = 0;
 
     ptrContext->eShowMode = SHOW_MODE_NONE;
-    ptrContext->arraySample[SAMPLE_ARRAY_SIZE] = { 0 };
+    ptrContext->bAudioDisplay = false;
+    ptrContext->ptrSampleArray.reset();
+    ptrContext->objSampleArrayMem.Set(0);
     ptrContext->nSampleArrayIndex = 0;
     ptrContext->nLastIStart = 0;
     ptrContext->pRdftContext = nullptr;
@@ -681,6 +895,9 @@ int16_t CChainFilterManager::ResetContext(SharePtr<CYMediaContext>& ptrContext)
     ptrContext->vis_texture = nullptr;
     ptrContext->sub_texture = nullptr;
     ptrContext->vid_texture = nullptr;
+    ptrContext->objVisTextureMem.Set(0);
+    ptrContext->objSubTextureMem.Set(0);
+    ptrContext->objVidTextureMem.Set(0);
 
     ptrContext->nSubtitleStreamIndex = 0;
     ptrContext->pSubTitleStream = nullptr;
@@ -751,6 +968,23 @@ int16_t CChainFilterManager::ResetContext(SharePtr<CYMediaContext>& ptrContext)
     ptrContext->szForceSubtitleCodecName[256] = { 0 };
     ptrContext->szForceVideoCodecName[256] = { 0 };
     ptrContext->szHWAccel[256] = { 0 };
+    ptrContext->nVideoQueueDepth = VIDEO_PICTURE_QUEUE_SIZE;
+    ptrContext->nAudioQueueDepth = SAMPLE_QUEUE_SIZE;
+    ptrContext->nSubtitleQueueDepth = SUBPICTURE_QUEUE_SIZE;
+    ptrContext->bAdaptiveVideoQueue = false;
+    ptrContext->nVideoQueueMinDepth = 2;
+    ptrContext->nVideoQueueMaxDepth = 16;
+    ptrContext->bFrameBufferPool = true;
+    ptrContext->bHugePageFrames = false;
+    ptrContext->bMappedFileIO = false;
+    ptrContext->nReadAheadSize = 0;
+    ptrContext->bKeyframeIndex = false;
+    ptrContext->bStreamInfoCache = false;
+    ptrContext->szCacheDir[0] = '\0';
+    ptrContext->nDecodePriority = 1;
+    ptrContext->bAdaptiveQuality = false;
+    ptrContext->nReverseCacheSize = REVERSE_GOP_CACHE_SIZE;
+    // ptrFramePool is kept on purpose: its buffers are reused by the next open.
 
     ptrContext->nSampleRate = 0;
     ptrContext->nAudioCallbackTime = 0;
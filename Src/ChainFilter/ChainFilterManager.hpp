@@ -75,6 +75,12 @@ public:
      */
     virtual int16_t Open(const char* pszURL, EPlayerMediaParam* pParam);
 
+    /**
+     * Gapless playlist.
+     */
+    virtual int16_t AddToPlaylist(const char* pszURL);
+    virtual int16_t ClearPlaylist();
+
     /**
      * Playback control.
      */
@@ -98,9 +104,18 @@ public:
      * Jump to the specified position (seconds).
      */
     virtual int16_t Seek(int64_t nTimestamp);
+
+    /**
+     * Timeline scrubbing.
+     */
+    virtual int16_t BeginScrub(bool bLowQuality);
+    virtual int16_t ScrubTo(int64_t nTimestamp);
+    virtual int16_t EndScrub();
+
     virtual int16_t SetMute(bool bMute);
     virtual int16_t SetLoop(bool bLoop);
     virtual int16_t SetSpeed(float fSpeed);
+    virtual int16_t StepBack();
 
     /**
      * Volume control.0.0 ~ 1.0
@@ -114,6 +129,17 @@ public:
     virtual int16_t SetVideoMirror(bool bMirror);
     virtual int16_t SetAspectRatio(float fRatio);
 
+    /**
+     * Memory quota / usage.
+     */
+    virtual int16_t SetMemoryQuota(int64_t nBytes);
+    virtual int16_t GetMemoryUsage(EPlayerMemoryUsage* pUsage);
+
+    /**
+     * Current video decode quality of the load governor.
+     */
+    virtual int16_t GetDecodeQuality(EDecodeQuality* peQuality);
+
     /**
      * Event callback settings.
      */
@@ -151,6 +177,7 @@ private:
     FunStateCallBack m_funStateCallBack;
     FunPositionCallBack m_funPositionCallBack;
     EStateType m_eStateType = TYPE_STATUS_IDLE;
+    bool m_bScrubResume = false;    // playing when the scrub began, resumed by EndScrub
 };
 
 CYPLAYER_NAMESPACE_END
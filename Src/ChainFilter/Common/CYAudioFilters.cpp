@@ -19,6 +19,17 @@ int ConfigureAudioFilters(SharePtr<CYMediaContext>& ptrContext, const char* pAFi
     const AVDictionaryEntry* pDictEntry = nullptr;
     AVBPrint bPrint;
     char szAsrcArgs[256];
+    char szTempoFilters[1024];
+
+    /* trick play stretches the audio without changing its pitch, asetpts puts the timestamps atempo
+       counts in output samples back on the media timeline */
+    double fTempo = nForceOutputFormat ? AudioTempo(ptrContext) : 1.0;
+    if (fTempo != 1.0)
+    {
+        snprintf(szTempoFilters, sizeof(szTempoFilters), "%s%satempo=%f,asetpts=STARTPTS+(PTS-STARTPTS)*%f",
+            pAFilters ? pAFilters : "", pAFilters ? "," : "", fTempo, fTempo);
+        pAFilters = szTempoFilters;
+    }
 
     ptrContext->ptrAgraph.reset();
     if (!(ptrContext->ptrAgraph = CreateAVFilterGraph()))
@@ -126,4 +137,15 @@ fail:
     return nRet;
 }
 
+/* the tempo the audio is played at: the playback speed, or 1.0 once it is too fast to be heard or backwards */
+double AudioTempo(SharePtr<CYMediaContext>& ptrContext)
+{
+    return AudioTempo(ptrContext->fPlaybackSpeed);
+}
+
+double AudioTempo(double fSpeed)
+{
+    return fSpeed > 0 && fSpeed <= TRICK_PLAY_AUDIO_MAX_SPEED ? fSpeed : 1.0;
+}
+
 CYPLAYER_NAMESPACE_END
\ No newline at end of file
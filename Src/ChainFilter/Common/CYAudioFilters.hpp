@@ -51,6 +51,8 @@ CYPLAYER_NAMESPACE_BEGIN
 
 int ConfigureAudioFilters(SharePtr<CYMediaContext>& ptrContext, const char* pAfilters, int nForceOutputFormat);
 int ConfigureFilterGraph(AVFilterGraph* pGraph, const char* szFilterGraph, AVFilterContext* pSourceCtx, AVFilterContext* pSinkCtx);
+double AudioTempo(SharePtr<CYMediaContext>& ptrContext);
+double AudioTempo(double fSpeed);
 
 CYPLAYER_NAMESPACE_END
 
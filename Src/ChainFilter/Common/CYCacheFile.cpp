@@ -0,0 +1,136 @@
+#include "ChainFilter/Common/CYCacheFile.hpp"
+#include "ChainFilter/Common/CYMappedFileIO.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <sys/stat.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CYPLAYER_NAMESPACE_BEGIN
+
+#ifdef _WIN32
+static std::wstring WidePath(const std::string& strPath)
+{
+    int nLen = MultiByteToWideChar(CP_UTF8, 0, strPath.c_str(), -1, nullptr, 0);
+    if (nLen <= 0)
+        return std::wstring();
+    std::wstring strWide(nLen, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, strPath.c_str(), -1, &strWide[0], nLen);
+    strWide.resize(nLen - 1);
+    return strWide;
+}
+#endif
+
+CYCacheFile::CYCacheFile()
+{
+
+}
+
+CYCacheFile::~CYCacheFile()
+{
+
+}
+
+bool CYCacheFile::Query(const char* pszURL)
+{
+    m_strPath.clear();
+    m_nSize = -1;
+    m_nModifyTime = 0;
+    if (!CYMappedFileIO::IsLocalFile(pszURL))
+        return false;
+    av_strstart(pszURL, "file:", &pszURL);
+
+#ifdef _WIN32
+    struct _stat64 objStat;
+    if (_wstat64(WidePath(pszURL).c_str(), &objStat) < 0 || !(objStat.st_mode & _S_IFREG))
+        return false;
+#else
+    struct stat objStat;
+    if (stat(pszURL, &objStat) < 0 || !S_ISREG(objStat.st_mode))
+        return false;
+#endif
+    m_strPath = pszURL;
+    m_nSize = objStat.st_size;
+    m_nModifyTime = objStat.st_mtime;
+    return true;
+}
+
+const std::string& CYCacheFile::Path() const
+{
+    return m_strPath;
+}
+
+int64_t CYCacheFile::Size() const
+{
+    return m_nSize;
+}
+
+int64_t CYCacheFile::ModifyTime() const
+{
+    return m_nModifyTime;
+}
+
+bool CYCacheFile::Matches(const std::string& strPath, int64_t nSize, int64_t nModifyTime) const
+{
+    return m_nSize >= 0 && strPath == m_strPath && nSize == m_nSize && nModifyTime == m_nModifyTime;
+}
+
+/* 64-bit FNV-1a over the path, the size and the modification time */
+std::string CYCacheFile::CachePath(const std::string& strDir, const char* pszExtension) const
+{
+    uint64_t nHash = 0xcbf29ce484222325ULL;
+    auto funMix = [&nHash](const void* pData, size_t nSize)
+    {
+        const uint8_t* p = (const uint8_t*)pData;
+        for (size_t i = 0; i < nSize; i++)
+        {
+            nHash ^= p[i];
+            nHash *= 0x100000001b3ULL;
+        }
+    };
+    funMix(m_strPath.data(), m_strPath.size());
+    funMix(&m_nSize, sizeof(m_nSize));
+    funMix(&m_nModifyTime, sizeof(m_nModifyTime));
+
+    char szName[32];
+    snprintf(szName, sizeof(szName), "%016llx", (unsigned long long)nHash);
+
+    std::string strCachePath = strDir;
+    if (!strCachePath.empty() && strCachePath.back() != '/' && strCachePath.back() != '\\')
+        strCachePath += '/';
+    return strCachePath + szName + pszExtension;
+}
+
+FILE* CYCacheFile::OpenFile(const std::string& strPath, const char* pszMode)
+{
+#ifdef _WIN32
+    std::wstring strMode(pszMode, pszMode + strlen(pszMode));
+    return _wfopen(WidePath(strPath).c_str(), strMode.c_str());
+#else
+    return fopen(strPath.c_str(), pszMode);
+#endif
+}
+
+bool CYCacheFile::Rename(const std::string& strTempPath, const std::string& strPath)
+{
+#ifdef _WIN32
+    return MoveFileExW(WidePath(strTempPath).c_str(), WidePath(strPath).c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(strTempPath.c_str(), strPath.c_str()) == 0;
+#endif
+}
+
+void CYCacheFile::Remove(const std::string& strPath)
+{
+#ifdef _WIN32
+    _wremove(WidePath(strPath).c_str());
+#else
+    unlink(strPath.c_str());
+#endif
+}
+
+CYPLAYER_NAMESPACE_END
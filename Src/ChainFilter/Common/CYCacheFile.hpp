@@ -0,0 +1,92 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_CACHE_FILE_HPP__
+#define __CY_CACHE_FILE_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+
+#include <stdio.h>
+#include <string>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/**
+ * Identity of a local media file for caches kept across opens.
+ *
+ * A cache entry describes one version of one file: it is named after a hash of the path,
+ * the size and the modification time, and the loader compares all three again against
+ * what the entry records, so a file that was replaced or rewritten never matches an
+ * entry written for its previous content.
+ */
+class CYCacheFile
+{
+public:
+    CYCacheFile();
+    virtual ~CYCacheFile();
+
+public:
+    /* stat a plain path or file: URL, false for anything else */
+    bool Query(const char* pszURL);
+
+    const std::string& Path() const;
+    int64_t Size() const;
+    int64_t ModifyTime() const;
+    bool Matches(const std::string& strPath, int64_t nSize, int64_t nModifyTime) const;
+
+    /* <strDir>/<hash><pszExtension> */
+    std::string CachePath(const std::string& strDir, const char* pszExtension) const;
+
+    static FILE* OpenFile(const std::string& strPath, const char* pszMode);
+    /* readers see the old cache file or the complete new one, never a partial write */
+    static bool Rename(const std::string& strTempPath, const std::string& strPath);
+    static void Remove(const std::string& strPath);
+
+private:
+    std::string m_strPath;
+    int64_t m_nSize = -1;
+    int64_t m_nModifyTime = 0;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_CACHE_FILE_HPP__
@@ -24,10 +24,77 @@ int CYDecoder::Init(SharePtr<CYMediaContext>& ptrContext, AVCodecContext* pAVCtx
     m_ptrEmptyCond = ptrCond;
     m_nStartPts = AV_NOPTS_VALUE;
     m_nPktSerial = -1;
+    m_nItem = 0;
+    m_nPtsOffset = 0;
+    {
+        UniqueLock locker(m_mutexSwitch);
+        m_nSwitchItem = -1;
+        m_ptrSwitchCtx.reset();
+        m_ptrSwitchItem.reset();
+        m_pSwitchStream = nullptr;
+    }
     m_ptrQueue->Start();
     return 0;
 }
 
+/* demux thread: packets whose opaque carries nItem belong to the next playlist item, they are decoded
+ * by pAVCtx (opened and fed its first packets by the preloader) and shifted by nPtsOffset (AV_TIME_BASE).
+ * A null pAVCtx keeps the current codec, as a loop back to the start of the same file does. ptrItem,
+ * given with a preloaded video decoder, holds the frame pool and thread lease the player takes over */
+void CYDecoder::QueueSwitch(int nItem, AVCodecContext* pAVCtx, AVStream* pStream, int64_t nPtsOffset, SharePtr<CYMediaItem> ptrItem)
+{
+    UniqueLock locker(m_mutexSwitch);
+    /* a switch still pending is dropped with its decoder */
+    if (m_ptrSwitchItem)
+        m_ptrSwitchItem->objThreadLease.Release();
+    m_ptrSwitchCtx.reset(pAVCtx);
+    m_ptrSwitchItem = std::move(ptrItem);
+    m_pSwitchStream = pStream;
+    m_nSwitchOffset = av_rescale_q(nPtsOffset, AV_TIME_BASE_Q, (pAVCtx ? pAVCtx : m_ptrAVCtx.get())->pkt_timebase);
+    m_nSwitchItem = nItem;
+}
+
+/* set before the first DecodeFrame, by the thread that calls it */
+void CYDecoder::SetPacketDropper(std::function<bool(const AVPacket* pPkt, double fPts)> funDrop)
+{
+    m_funDropPacket = std::move(funDrop);
+}
+
+int CYDecoder::GetItem() const
+{
+    return m_nItem;
+}
+
+/* the previous item drained through its null packet, or was flushed by a seek: hand over the codec */
+bool CYDecoder::SwitchItem()
+{
+    UniqueLock locker(m_mutexSwitch);
+    if ((int)(intptr_t)m_ptrPkt->opaque != m_nSwitchItem)
+        return false;
+
+    if (m_ptrSwitchCtx)
+    {
+        m_ptrAVCtx = std::move(m_ptrSwitchCtx);
+        if (m_ptrAVCtx->codec_type == AVMEDIA_TYPE_VIDEO)
+            m_ptrContext->pVideoStream = m_pSwitchStream;
+        else if (m_ptrAVCtx->codec_type == AVMEDIA_TYPE_AUDIO)
+            m_ptrContext->pAudioStream = m_pSwitchStream;
+    }
+    /* the previous decoder is closed, its pool and threads give way to those of the new one */
+    if (m_ptrSwitchItem)
+    {
+        if (m_ptrSwitchItem->ptrFramePool)
+            m_ptrContext->ptrFramePool = std::move(m_ptrSwitchItem->ptrFramePool);
+        m_ptrContext->objThreadLease.Take(m_ptrSwitchItem->objThreadLease);
+        m_ptrSwitchItem.reset();
+    }
+    m_nPtsOffset = m_nSwitchOffset;
+    m_nFinished = 0;
+    m_nItem = m_nSwitchItem.exchange(-1);
+    m_pSwitchStream = nullptr;
+    return true;
+}
+
 int CYDecoder::DecodeFrame(AVFrame* pFrame, AVSubtitle* pSub, int ndecoderReorderPts)
 {
     int ret = AVERROR(EAGAIN);
@@ -55,6 +122,8 @@ int CYDecoder::DecodeFrame(AVFrame* pFrame, AVSubtitle* pSub, int ndecoderReorde
                         {
                             pFrame->pts = pFrame->pkt_dts;
                         }
+                        if (pFrame->pts != AV_NOPTS_VALUE)
+                            pFrame->pts += m_nPtsOffset;
                     }
                     break;
                 case AVMEDIA_TYPE_AUDIO:
@@ -63,7 +132,7 @@ int CYDecoder::DecodeFrame(AVFrame* pFrame, AVSubtitle* pSub, int ndecoderReorde
                     {
                         AVRational tb = { 1, pFrame->sample_rate };
                         if (pFrame->pts != AV_NOPTS_VALUE)
-                            pFrame->pts = av_rescale_q(pFrame->pts, m_ptrAVCtx->pkt_timebase, tb);
+                            pFrame->pts = av_rescale_q(pFrame->pts + m_nPtsOffset, m_ptrAVCtx->pkt_timebase, tb);
                         else if (m_nNextPts != AV_NOPTS_VALUE)
                             pFrame->pts = av_rescale_q(m_nNextPts, m_objNextPtsTb, tb);
                         if (pFrame->pts != AV_NOPTS_VALUE)
@@ -76,7 +145,9 @@ int CYDecoder::DecodeFrame(AVFrame* pFrame, AVSubtitle* pSub, int ndecoderReorde
                 }
                 if (ret == AVERROR_EOF)
                 {
+                    /* the demuxer at the end of the input waits for this to loop or exit */
                     m_nFinished = m_nPktSerial;
+                    m_ptrEmptyCond->NotifyOne();
                     avcodec_flush_buffers(m_ptrAVCtx.get());
                     return 0;
                 }
@@ -87,8 +158,6 @@ int CYDecoder::DecodeFrame(AVFrame* pFrame, AVSubtitle* pSub, int ndecoderReorde
 
         do
         {
-            if (m_ptrQueue->nb_packets == 0)
-                m_ptrEmptyCond->NotifyOne();
             if (m_nPacketPending)
             {
                 m_nPacketPending = 0;
@@ -99,6 +168,10 @@ int CYDecoder::DecodeFrame(AVFrame* pFrame, AVSubtitle* pSub, int ndecoderReorde
                 if (m_ptrQueue->Get(m_ptrPkt, 1, &m_nPktSerial) < 0)
                     return -1;
 
+                /* wake the demuxer once the queue drains below the point it parked for */
+                if (m_ptrQueue->CheckLowWatermark())
+                    m_ptrEmptyCond->NotifyOne();
+
                 if (old_serial != m_nPktSerial)
                 {
                     avcodec_flush_buffers(m_ptrAVCtx.get());
@@ -112,6 +185,21 @@ int CYDecoder::DecodeFrame(AVFrame* pFrame, AVSubtitle* pSub, int ndecoderReorde
             av_packet_unref(m_ptrPkt.get());
         } while (1);
 
+        /* frames the preloader already decoded come out before this packet is sent */
+        if (m_nSwitchItem >= 0 && SwitchItem())
+        {
+            m_nPacketPending = 1;
+            continue;
+        }
+
+        /* too late to be worth decoding, the codec never sees it */
+        if (m_funDropPacket && m_ptrPkt->data && m_ptrPkt->pts != AV_NOPTS_VALUE &&
+            m_funDropPacket(m_ptrPkt.get(), (m_ptrPkt->pts + m_nPtsOffset) * av_q2d(m_ptrAVCtx->pkt_timebase)))
+        {
+            av_packet_unref(m_ptrPkt.get());
+            continue;
+        }
+
         if (m_ptrAVCtx->codec_type == AVMEDIA_TYPE_SUBTITLE)
         {
             int nGotFrame = 0;
@@ -126,6 +214,8 @@ int CYDecoder::DecodeFrame(AVFrame* pFrame, AVSubtitle* pSub, int ndecoderReorde
                 {
                     m_nPacketPending = 1;
                 }
+                if (nGotFrame && pSub->pts != AV_NOPTS_VALUE)
+                    pSub->pts += av_rescale_q(m_nPtsOffset, m_ptrAVCtx->pkt_timebase, AV_TIME_BASE_Q);
                 ret = nGotFrame ? 0 : (m_ptrPkt->data ? AVERROR(EAGAIN) : AVERROR_EOF);
             }
             av_packet_unref(m_ptrPkt.get());
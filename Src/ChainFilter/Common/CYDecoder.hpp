@@ -52,6 +52,7 @@
 CYPLAYER_NAMESPACE_BEGIN
 
 class CYMediaContext;
+struct CYMediaItem;
 class CYDecoder
 {
 public:
@@ -65,6 +66,9 @@ public:
     int  Start(std::function<void()> fun, const char* pThreadName);
     void Abort(CYFrameQueue& objQueue);
     AVCodecContext* GetCodecContent();
+    void QueueSwitch(int nItem, AVCodecContext* pAVCtx, AVStream* pStream, int64_t nPtsOffset, SharePtr<CYMediaItem> ptrItem = nullptr);
+    void SetPacketDropper(std::function<bool(const AVPacket* pPkt, double fPts)> funDrop);
+    int  GetItem() const;
 
     void WaitStart()
     {
@@ -91,6 +95,24 @@ public:
     std::thread m_thread;
     CYCondition m_objStartDecodeCond;
     SharePtr<CYMediaContext> m_ptrContext;
+
+private:
+    bool SwitchItem();
+
+private:
+    /* gapless playlist and loop: the item being decoded, the offset of its timestamps in pkt_timebase,
+       and the codec context, if any, that takes over at the first packet tagged with m_nSwitchItem */
+    std::atomic<int> m_nItem{ 0 };
+    int64_t m_nPtsOffset = 0;
+    std::mutex m_mutexSwitch;
+    std::atomic<int> m_nSwitchItem{ -1 };
+    AVCodecContextPtr m_ptrSwitchCtx;
+    SharePtr<CYMediaItem> m_ptrSwitchItem;
+    AVStream* m_pSwitchStream = nullptr;
+    int64_t m_nSwitchOffset = 0;
+
+    /* decides on the decode thread whether a packet is skipped, fPts in seconds on the playback timeline */
+    std::function<bool(const AVPacket* pPkt, double fPts)> m_funDropPacket;
 };
 
 CYPLAYER_NAMESPACE_END
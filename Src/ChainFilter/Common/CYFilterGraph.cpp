@@ -0,0 +1,33 @@
+#include "ChainFilter/Common/CYFilterGraph.hpp"
+
+#include <cstring>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/* true when every filter maps one input frame to one output frame without looking at the previous ones,
+ * so the graph can be reused across a seek instead of being rebuilt. aresample is not one of them: its
+ * interpolation window holds samples back, which would be played after the seek. */
+bool FilterGraphIsStateless(const AVFilterGraph* pGraph)
+{
+    static const char* arrStateless[] = {
+        "buffer", "buffersink", "abuffer", "abuffersink",
+        "null", "anull", "format", "aformat", "scale", "volume",
+        "transpose", "hflip", "vflip", "rotate", "crop", "pad", "setsar", "setdar", "hwdownload",
+        nullptr
+    };
+
+    if (!pGraph)
+        return false;
+    for (unsigned i = 0; i < pGraph->nb_filters; i++)
+    {
+        const char* pszName = pGraph->filters[i]->filter->name;
+        int j = 0;
+        while (arrStateless[j] && strcmp(arrStateless[j], pszName))
+            j++;
+        if (!arrStateless[j])
+            return false;
+    }
+    return true;
+}
+
+CYPLAYER_NAMESPACE_END
@@ -0,0 +1,258 @@
+#include "ChainFilter/Common/CYFrameBufferPool.hpp"
+
+#include <vector>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "libavutil/imgutils.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#include <sys/mman.h>
+#endif
+
+/* how a plane was allocated, passed to FreePlane as the buffer opaque */
+#define FRAME_POOL_MEM_ALIGNED  ((void*)0)
+#define FRAME_POOL_MEM_HUGE     ((void*)1)
+
+CYPLAYER_NAMESPACE_BEGIN
+
+CYFrameBufferPool::CYFrameBufferPool()
+{
+
+}
+
+CYFrameBufferPool::~CYFrameBufferPool()
+{
+    Reset();
+}
+
+/* must be called before avcodec_open2, frame threads copy the callback on open */
+void CYFrameBufferPool::Install(AVCodecContext* pAVCtx, bool bHugePages)
+{
+    m_bHugePages = bHugePages;
+    pAVCtx->opaque = this;
+    pAVCtx->get_buffer2 = &CYFrameBufferPool::GetBuffer2;
+}
+
+/* allocate and touch nFrames pictures of the opened decoder's coded size, so playback starts without page faults */
+int CYFrameBufferPool::Prewarm(AVCodecContext* pAVCtx, int nFrames)
+{
+    const AVPixFmtDescriptor* pDesc = av_pix_fmt_desc_get(pAVCtx->pix_fmt);
+    int nWidth = FFMAX(pAVCtx->width, AV_CEIL_RSHIFT(pAVCtx->coded_width, pAVCtx->lowres));
+    int nHeight = FFMAX(pAVCtx->height, AV_CEIL_RSHIFT(pAVCtx->coded_height, pAVCtx->lowres));
+    std::vector<AVBufferRef*> vecBuffers;
+    int ret = 0;
+
+    if (!pDesc || pAVCtx->hw_device_ctx || nWidth <= 0 || nHeight <= 0 ||
+        (pDesc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM)))
+        return 0;
+
+    UniqueLock locker(m_mutex);
+    if ((ret = Update(pAVCtx, pAVCtx->pix_fmt, nWidth, nHeight)) < 0)
+        return ret;
+
+    for (int n = 0; n < nFrames; n++)
+    {
+        for (int i = 0; i < 4 && m_arrPools[i]; i++)
+        {
+            AVBufferRef* pBuf = av_buffer_pool_get(m_arrPools[i]);
+            if (!pBuf)
+                break;
+            memset(pBuf->data, 0, pBuf->size);
+            vecBuffers.push_back(pBuf);
+        }
+    }
+
+    for (AVBufferRef*& pBuf : vecBuffers)
+        av_buffer_unref(&pBuf);
+    return 0;
+}
+
+void CYFrameBufferPool::Reset()
+{
+    UniqueLock locker(m_mutex);
+    ResetPools();
+}
+
+/* planes allocated from the system so far, a pool that works stops growing after warm-up */
+int64_t CYFrameBufferPool::Allocations() const
+{
+    return m_nAllocations.load(std::memory_order_relaxed);
+}
+
+int CYFrameBufferPool::GetBuffer2(AVCodecContext* pAVCtx, AVFrame* pFrame, int nFlags)
+{
+    CYFrameBufferPool* pPool = (CYFrameBufferPool*)pAVCtx->opaque;
+    const AVPixFmtDescriptor* pDesc = av_pix_fmt_desc_get((AVPixelFormat)pFrame->format);
+
+    if (!pPool || pAVCtx->codec_type != AVMEDIA_TYPE_VIDEO || pAVCtx->hw_frames_ctx || !pDesc ||
+        (pDesc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM)) ||
+        !pAVCtx->codec || !(pAVCtx->codec->capabilities & AV_CODEC_CAP_DR1))
+        return avcodec_default_get_buffer2(pAVCtx, pFrame, nFlags);
+
+    return pPool->GetBuffer(pAVCtx, pFrame);
+}
+
+AVBufferRef* CYFrameBufferPool::AllocPlane(void* pOpaque, size_t nSize)
+{
+    CYFrameBufferPool* pPool = (CYFrameBufferPool*)pOpaque;
+    uint8_t* pData = nullptr;
+    void* pKind = FRAME_POOL_MEM_ALIGNED;
+    AVBufferRef* pBuf = nullptr;
+
+#ifdef _WIN32
+    if (pPool->m_bHugePages && nSize >= FRAME_POOL_HUGE_PAGE_SIZE && GetLargePageMinimum())
+    {
+        /* needs SeLockMemoryPrivilege, fall back to normal pages without it */
+        size_t nLarge = GetLargePageMinimum();
+        size_t nAlloc = (nSize + nLarge - 1) / nLarge * nLarge;
+        pData = (uint8_t*)VirtualAlloc(nullptr, nAlloc, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (pData)
+            pKind = FRAME_POOL_MEM_HUGE;
+    }
+    if (!pData)
+        pData = (uint8_t*)_aligned_malloc(nSize, FRAME_POOL_ALIGN);
+#else
+    void* pMem = nullptr;
+    if (pPool->m_bHugePages && nSize >= FRAME_POOL_HUGE_PAGE_SIZE)
+    {
+        size_t nAlloc = (nSize + FRAME_POOL_HUGE_PAGE_SIZE - 1) / FRAME_POOL_HUGE_PAGE_SIZE * FRAME_POOL_HUGE_PAGE_SIZE;
+        if (posix_memalign(&pMem, FRAME_POOL_HUGE_PAGE_SIZE, nAlloc) == 0)
+        {
+#ifdef MADV_HUGEPAGE
+            madvise(pMem, nAlloc, MADV_HUGEPAGE);
+#endif
+        }
+        else
+        {
+            pMem = nullptr;
+        }
+    }
+    if (!pMem && posix_memalign(&pMem, FRAME_POOL_ALIGN, nSize) != 0)
+        pMem = nullptr;
+    pData = (uint8_t*)pMem;
+#endif
+
+    if (!pData)
+        return nullptr;
+    if (!(pBuf = av_buffer_create(pData, nSize, &CYFrameBufferPool::FreePlane, pKind, 0)))
+    {
+        FreePlane(pKind, pData);
+        return nullptr;
+    }
+
+    pPool->m_nAllocations.fetch_add(1, std::memory_order_relaxed);
+    return pBuf;
+}
+
+void CYFrameBufferPool::FreePlane(void* pOpaque, uint8_t* pData)
+{
+#ifdef _WIN32
+    if (pOpaque == FRAME_POOL_MEM_HUGE)
+        VirtualFree(pData, 0, MEM_RELEASE);
+    else
+        _aligned_free(pData);
+#else
+    (void)pOpaque;
+    free(pData);
+#endif
+}
+
+int CYFrameBufferPool::GetBuffer(AVCodecContext* pAVCtx, AVFrame* pFrame)
+{
+    int ret = 0;
+    UniqueLock locker(m_mutex);
+
+    if (pFrame->format != m_nFormat || pFrame->width != m_nWidth || pFrame->height != m_nHeight)
+    {
+        if ((ret = Update(pAVCtx, pFrame->format, pFrame->width, pFrame->height)) < 0)
+            return ret;
+    }
+
+    for (int i = 0; i < 4 && m_arrPools[i]; i++)
+    {
+        pFrame->linesize[i] = m_arrLinesize[i];
+        pFrame->buf[i] = av_buffer_pool_get(m_arrPools[i]);
+        if (!pFrame->buf[i])
+        {
+            av_frame_unref(pFrame);
+            return AVERROR(ENOMEM);
+        }
+        pFrame->data[i] = pFrame->buf[i]->data;
+    }
+    pFrame->extended_data = pFrame->data;
+    return 0;
+}
+
+/* must be called with m_mutex held: lay out the planes like avcodec_default_get_buffer2, with FRAME_POOL_ALIGN strides */
+int CYFrameBufferPool::Update(AVCodecContext* pAVCtx, int nFormat, int nWidth, int nHeight)
+{
+    int arrAlign[AV_NUM_DATA_POINTERS];
+    int arrLinesize[4] = { 0 };
+    ptrdiff_t arrLinesize1[4];
+    size_t arrSize[4] = { 0 };
+    int w = nWidth;
+    int h = nHeight;
+    int nUnaligned = 0;
+    int ret = 0;
+
+    avcodec_align_dimensions2(pAVCtx, &w, &h, arrAlign);
+    do
+    {
+        if ((ret = av_image_fill_linesizes(arrLinesize, (AVPixelFormat)nFormat, w)) < 0)
+            return ret;
+        w += w & ~(w - 1);
+
+        nUnaligned = 0;
+        for (int i = 0; i < 4; i++)
+            nUnaligned |= arrLinesize[i] % FRAME_POOL_ALIGN;
+    } while (nUnaligned);
+
+    for (int i = 0; i < 4; i++)
+        arrLinesize1[i] = arrLinesize[i];
+    if ((ret = av_image_fill_plane_sizes(arrSize, (AVPixelFormat)nFormat, h, arrLinesize1)) < 0)
+        return ret;
+
+    /* buffers still held by frames keep the old pools alive until they come back */
+    ResetPools();
+    for (int i = 0; i < 4 && arrSize[i]; i++)
+    {
+        m_arrPools[i] = av_buffer_pool_init2(arrSize[i] + 16 + FRAME_POOL_ALIGN - 1, this, &CYFrameBufferPool::AllocPlane, nullptr);
+        if (!m_arrPools[i])
+        {
+            ResetPools();
+            return AVERROR(ENOMEM);
+        }
+        m_arrLinesize[i] = arrLinesize[i];
+    }
+
+    m_nFormat = nFormat;
+    m_nWidth = nWidth;
+    m_nHeight = nHeight;
+    return 0;
+}
+
+void CYFrameBufferPool::ResetPools()
+{
+    for (int i = 0; i < 4; i++)
+    {
+        av_buffer_pool_uninit(&m_arrPools[i]);
+        m_arrLinesize[i] = 0;
+    }
+    m_nFormat = AV_PIX_FMT_NONE;
+    m_nWidth = 0;
+    m_nHeight = 0;
+}
+
+CYPLAYER_NAMESPACE_END
@@ -0,0 +1,99 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+
+#ifndef __CY_FRAME_BUFFER_POOL_HPP__
+#define __CY_FRAME_BUFFER_POOL_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+
+#include <atomic>
+#include <mutex>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/**
+ * Player-owned picture buffers for software video decoders.
+ *
+ * Installed as AVCodecContext::get_buffer2, it hands out FRAME_POOL_ALIGN aligned planes
+ * from one AVBufferPool per plane. The pools are keyed on format and size only, so they
+ * outlive seeks, serial changes and decoder re-opens; a resolution change starts new pools
+ * while frames still in flight keep the old ones alive until they are unref'd.
+ * Hardware frames, paletted formats and decoders without AV_CODEC_CAP_DR1 fall back to
+ * avcodec_default_get_buffer2.
+ */
+class CYFrameBufferPool
+{
+public:
+    CYFrameBufferPool();
+    virtual ~CYFrameBufferPool();
+
+public:
+    void Install(AVCodecContext* pAVCtx, bool bHugePages);
+    int  Prewarm(AVCodecContext* pAVCtx, int nFrames);
+    void Reset();
+    int64_t Allocations() const;
+
+private:
+    static int GetBuffer2(AVCodecContext* pAVCtx, AVFrame* pFrame, int nFlags);
+    static AVBufferRef* AllocPlane(void* pOpaque, size_t nSize);
+    static void FreePlane(void* pOpaque, uint8_t* pData);
+
+    int  GetBuffer(AVCodecContext* pAVCtx, AVFrame* pFrame);
+    int  Update(AVCodecContext* pAVCtx, int nFormat, int nWidth, int nHeight);
+    void ResetPools();
+
+private:
+    std::mutex m_mutex;
+    AVBufferPool* m_arrPools[4] = { nullptr };
+    int m_arrLinesize[4] = { 0 };
+    int m_nFormat = AV_PIX_FMT_NONE;
+    int m_nWidth = 0;
+    int m_nHeight = 0;
+    bool m_bHugePages = false;
+    std::atomic<int64_t> m_nAllocations{ 0 };
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_FRAME_BUFFER_POOL_HPP__
@@ -0,0 +1,132 @@
+#include "ChainFilter/Common/CYGopCache.hpp"
+
+CYPLAYER_NAMESPACE_BEGIN
+
+CYGopCache::CYGopCache()
+{
+
+}
+
+CYGopCache::~CYGopCache()
+{
+    Clear();
+}
+
+void CYGopCache::Reset(double fEnd, int64_t nCapacity)
+{
+    Clear();
+
+    UniqueLock locker(m_mutex);
+    m_nCapacity = FFMAX(nCapacity, 0);
+    m_nLastGopBytes = 0;
+    m_fStart = fEnd;
+    m_bStartReached = false;
+    m_bAborted = false;
+}
+
+void CYGopCache::SetMemoryAccount(CYMemoryAccount* pAccount)
+{
+    m_pMemAccount = pAccount;
+}
+
+void CYGopCache::Abort()
+{
+    UniqueLock locker(m_mutex);
+    m_bAborted = true;
+    m_cvCond.notify_all();
+}
+
+void CYGopCache::Clear()
+{
+    UniqueLock locker(m_mutex);
+    for (CYCachedFrame& objFrame : m_deqFrames)
+        Drop(objFrame);
+    m_deqFrames.clear();
+    m_nBytes = 0;
+    m_cvCond.notify_all();
+}
+
+bool CYGopCache::WaitForRoom(double* pfEnd)
+{
+    UniqueLock locker(m_mutex);
+    m_cvCond.wait(locker, [this]() { return m_bAborted || m_bStartReached || m_deqFrames.empty() || m_nCapacity - m_nBytes >= m_nLastGopBytes; });
+    if (m_bAborted || m_bStartReached)
+        return false;
+    *pfEnd = m_fStart;
+    return true;
+}
+
+void CYGopCache::Prepend(std::vector<CYCachedFrame>& vecFrames, double fEnd, bool bStreamStart)
+{
+    UniqueLock locker(m_mutex);
+    /* decoded for a run that was reset meanwhile */
+    if (m_bAborted || fEnd != m_fStart)
+        return;
+
+    int64_t nGopBytes = 0;
+    for (const CYCachedFrame& objFrame : vecFrames)
+        nGopBytes += objFrame.nBytes;
+    m_nLastGopBytes = nGopBytes;
+
+    /* the latest pictures are shown first, keep as many of them as fit; an empty run takes one regardless */
+    int nFirst = (int)vecFrames.size();
+    int64_t nBytes = m_nBytes;
+    while (nFirst > 0 && ((m_deqFrames.empty() && nFirst == (int)vecFrames.size()) || nBytes + vecFrames[nFirst - 1].nBytes <= m_nCapacity))
+        nBytes += vecFrames[--nFirst].nBytes;
+
+    for (int i = (int)vecFrames.size() - 1; i >= nFirst; i--)
+    {
+        if (m_pMemAccount)
+            m_pMemAccount->Charge(TYPE_MEMORY_FRAMES, vecFrames[i].nBytes);
+        m_deqFrames.push_front(std::move(vecFrames[i]));
+    }
+    m_nBytes = nBytes;
+    if (!m_deqFrames.empty())
+        m_fStart = m_deqFrames.front().fPts;
+    m_bStartReached = bStreamStart && nFirst == 0;
+    vecFrames.clear();
+    m_cvCond.notify_all();
+}
+
+bool CYGopCache::TakeLast(CYCachedFrame* pFrame)
+{
+    UniqueLock locker(m_mutex);
+    m_cvCond.wait(locker, [this]() { return m_bAborted || m_bStartReached || !m_deqFrames.empty(); });
+    if (m_bAborted || m_deqFrames.empty())
+        return false;
+
+    *pFrame = std::move(m_deqFrames.back());
+    m_deqFrames.pop_back();
+    m_nBytes -= pFrame->nBytes;
+    if (m_pMemAccount)
+        m_pMemAccount->Charge(TYPE_MEMORY_FRAMES, -pFrame->nBytes);
+    m_cvCond.notify_all();
+    return true;
+}
+
+int CYGopCache::Count() const
+{
+    UniqueLock locker(m_mutex);
+    return (int)m_deqFrames.size();
+}
+
+int64_t CYGopCache::Bytes() const
+{
+    UniqueLock locker(m_mutex);
+    return m_nBytes;
+}
+
+double CYGopCache::Start() const
+{
+    UniqueLock locker(m_mutex);
+    return m_fStart;
+}
+
+void CYGopCache::Drop(CYCachedFrame& objFrame)
+{
+    if (m_pMemAccount && objFrame.nBytes)
+        m_pMemAccount->Charge(TYPE_MEMORY_FRAMES, -objFrame.nBytes);
+    objFrame.ptrFrame.reset();
+}
+
+CYPLAYER_NAMESPACE_END
@@ -0,0 +1,122 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_GOP_CACHE_HPP__
+#define __CY_GOP_CACHE_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+#include "Common/Memory/CYMemoryBudget.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/* a decoded picture waiting to be shown backwards, times in seconds on the playback timeline */
+struct CYCachedFrame
+{
+    AVFramePtr ptrFrame;
+    double fPts = NAN;
+    double fDuration = 0;
+    int64_t nPos = -1;
+    int64_t nBytes = 0;
+};
+
+/**
+ * Decoded pictures for reverse playback: one run of them, contiguous in time and sorted by pts.
+ *
+ * A worker decodes the GOP that ends where the run starts and prepends it, the presenter takes
+ * pictures from the end of the run. The worker is let go for the next GOP as soon as one the size
+ * of the last would fit, so the preceding GOP is decoded while the current one is shown. The run
+ * never holds more than the capacity: a GOP that does not fit keeps its latest pictures, and the
+ * rest is decoded again from the same keyframe once those were shown.
+ */
+class CYGopCache
+{
+public:
+    CYGopCache();
+    virtual ~CYGopCache();
+
+public:
+    /* start over with an empty run ending at fEnd, the waits work again after an Abort */
+    void Reset(double fEnd, int64_t nCapacity);
+    /* charge the held pictures to pAccount, set before the first Prepend */
+    void SetMemoryAccount(CYMemoryAccount* pAccount);
+    /* wake both sides and fail their waits until the next Reset */
+    void Abort();
+    void Clear();
+
+    /* worker: wait until the next GOP fits, *pfEnd is where it has to end; false once aborted or at the start */
+    bool WaitForRoom(double* pfEnd);
+    /* worker: pictures decoded from a keyframe up to the fEnd WaitForRoom returned, ascending;
+     * bStreamStart: nothing precedes the keyframe */
+    void Prepend(std::vector<CYCachedFrame>& vecFrames, double fEnd, bool bStreamStart);
+    /* presenter: wait for the latest picture and move it out, false once aborted or nothing precedes it */
+    bool TakeLast(CYCachedFrame* pFrame);
+
+    int Count() const;
+    int64_t Bytes() const;
+    /* pts of the earliest picture held, or the end of the run while it is empty */
+    double Start() const;
+
+private:
+    void Drop(CYCachedFrame& objFrame);
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cvCond;
+    std::deque<CYCachedFrame> m_deqFrames;
+    int64_t m_nBytes = 0;
+    int64_t m_nCapacity = 0;
+    int64_t m_nLastGopBytes = 0;
+    double m_fStart = NAN;
+    bool m_bStartReached = false;
+    bool m_bAborted = false;
+    CYMemoryAccount* m_pMemAccount = nullptr;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_GOP_CACHE_HPP__
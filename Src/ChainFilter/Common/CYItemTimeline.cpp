@@ -0,0 +1,98 @@
+#include "ChainFilter/Common/CYItemTimeline.hpp"
+
+#include <cmath>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+CYItemTimeline::CYItemTimeline()
+{
+    Reset(AV_NOPTS_VALUE, 0);
+}
+
+CYItemTimeline::~CYItemTimeline()
+{
+
+}
+
+void CYItemTimeline::Reset(int64_t nStart, int64_t nDuration)
+{
+    LockGuard locker(m_mutex);
+    CYTimelineItem objItem;
+    objItem.nStart = nStart;
+    objItem.nDuration = nDuration;
+    m_deqItems.clear();
+    m_deqItems.push_back(objItem);
+}
+
+void CYItemTimeline::Queue(const CYTimelineItem& objItem)
+{
+    LockGuard locker(m_mutex);
+    m_deqItems.push_back(objItem);
+}
+
+void CYItemTimeline::Return()
+{
+    LockGuard locker(m_mutex);
+    if (m_deqItems.size() > 1)
+        m_deqItems.pop_back();
+}
+
+int CYItemTimeline::Locate(int64_t nTarget, CYTimelineItem* pItem) const
+{
+    LockGuard locker(m_mutex);
+    size_t nItems = m_deqItems.size();
+    if (nItems < 2 || m_deqItems[nItems - 1].nStart == AV_NOPTS_VALUE || nTarget >= m_deqItems[nItems - 1].nStart)
+        return ITEM_READ;
+    if (nItems > 2 && nTarget < m_deqItems[nItems - 2].nStart)
+        return ITEM_GONE;
+    *pItem = m_deqItems[nItems - 2];
+    return ITEM_PREVIOUS;
+}
+
+CYTimelineItem CYItemTimeline::Read() const
+{
+    LockGuard locker(m_mutex);
+    return m_deqItems.back();
+}
+
+bool CYItemTimeline::Present(double fClock)
+{
+    LockGuard locker(m_mutex);
+    bool bChanged = false;
+    while (m_deqItems.size() > 1 && !isnan(fClock) && fClock * AV_TIME_BASE >= m_deqItems[1].nStart)
+    {
+        m_deqItems.pop_front();
+        bChanged |= !m_deqItems.front().bLoop;
+    }
+    return bChanged;
+}
+
+bool CYItemTimeline::Pending() const
+{
+    LockGuard locker(m_mutex);
+    return m_deqItems.size() > 1;
+}
+
+int64_t CYItemTimeline::Offset() const
+{
+    LockGuard locker(m_mutex);
+    return m_deqItems.front().nOffset;
+}
+
+int64_t CYItemTimeline::Duration() const
+{
+    LockGuard locker(m_mutex);
+    return m_deqItems.front().nDuration;
+}
+
+int64_t CYItemTimeline::SeekTarget(int64_t nMilliSeconds) const
+{
+    LockGuard locker(m_mutex);
+    const CYTimelineItem& objItem = m_deqItems.front();
+    int64_t nTarget = (int64_t)(nMilliSeconds / 1000.0 * AV_TIME_BASE) + objItem.nOffset;
+    if (objItem.nStart != AV_NOPTS_VALUE && nTarget < objItem.nStart)
+        nTarget = objItem.nStart;
+    return nTarget;
+}
+
+CYPLAYER_NAMESPACE_END
@@ -0,0 +1,113 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+
+
+#ifndef __CY_ITEM_TIMELINE_HPP__
+#define __CY_ITEM_TIMELINE_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+
+#include <deque>
+#include <mutex>
+#include <stdint.h>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/* one playlist item, or one round of a loop, on the playback timeline */
+struct CYTimelineItem
+{
+    int64_t nStart = AV_NOPTS_VALUE;    /* where it starts, AV_TIME_BASE */
+    int64_t nOffset = 0;                /* added to its own timestamps, AV_TIME_BASE */
+    int64_t nDuration = 0;              /* of its file, milliseconds */
+    bool bLoop = false;                 /* another round of the file before it */
+};
+
+/**
+ * Where the items of a gapless playlist sit on the playback timeline, which runs on through
+ * every item and every round of a loop.
+ *
+ * The demuxer reads the next item as soon as the previous one is read to its end and queues it
+ * here; the item on screen only changes once the master clock reaches the start of the next one
+ * (Present), until then the screen shows the tail of an earlier item. Positions and API seeks
+ * are within the item on screen. The demuxer looks a seek target up against the items it read
+ * (Locate): one before the start of the item being read is in the tail on screen, and reading
+ * has to go back to that item (Return) before seeking in it.
+ */
+class CYItemTimeline
+{
+public:
+    CYItemTimeline();
+    virtual ~CYItemTimeline();
+
+public:
+    enum
+    {
+        ITEM_READ,      /* in the item being read, or before the start of the first */
+        ITEM_PREVIOUS,  /* in the item read before, which is on screen */
+        ITEM_GONE,      /* in an item further back that is still on screen */
+    };
+
+    /* the first item, nDuration in milliseconds */
+    void Reset(int64_t nStart, int64_t nDuration);
+
+    /* demux thread: the item read from now on */
+    void Queue(const CYTimelineItem& objItem);
+    /* demux thread: reading went back to the item before the one being read */
+    void Return();
+    /* demux thread: which item nTarget lies in, *pItem is the previous one for ITEM_PREVIOUS */
+    int  Locate(int64_t nTarget, CYTimelineItem* pItem) const;
+    CYTimelineItem Read() const;
+
+    /* render thread: the master clock is at fClock seconds, true when an item other than another
+       round of a loop went on screen */
+    bool Present(double fClock);
+    /* the screen still shows an item before the one being read */
+    bool Pending() const;
+
+    /* the item on screen */
+    int64_t Offset() const;
+    int64_t Duration() const;
+    /* API milliseconds within the item on screen to the playback timeline, not before its start */
+    int64_t SeekTarget(int64_t nMilliSeconds) const;
+
+private:
+    mutable std::mutex m_mutex;
+    /* from the item on screen to the item being read */
+    std::deque<CYTimelineItem> m_deqItems;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_ITEM_TIMELINE_HPP__
@@ -0,0 +1,223 @@
+#include "ChainFilter/Common/CYKeyframeIndex.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+
+#include <algorithm>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+#define KEYFRAME_INDEX_MAGIC   0x494b5943 /* "CYKI" */
+#define KEYFRAME_INDEX_VERSION 1
+#define KEYFRAME_INDEX_EXT     ".cyki"
+
+/* sidecar layout: header, path bytes, entries; native byte order, the file is a local cache */
+struct CYKeyframeIndexHeader
+{
+    uint32_t nMagic;
+    uint32_t nVersion;
+    int64_t nSize;
+    int64_t nModifyTime;
+    int32_t nStreamIndex;
+    int32_t nCodecId;
+    uint32_t nPathLength;
+    uint32_t nCount;
+    uint32_t bComplete;
+    uint32_t nReserved;
+};
+
+CYKeyframeIndex::CYKeyframeIndex()
+{
+
+}
+
+CYKeyframeIndex::~CYKeyframeIndex()
+{
+
+}
+
+bool CYKeyframeIndex::Init(const char* pszURL, int nStreamIndex, int nCodecId)
+{
+    Reset();
+    if (nStreamIndex < 0 || !m_objFile.Query(pszURL))
+        return false;
+    m_nStreamIndex = nStreamIndex;
+    m_nCodecId = nCodecId;
+    m_bValid = true;
+    return true;
+}
+
+void CYKeyframeIndex::Reset()
+{
+    m_vecEntries.clear();
+    m_nStreamIndex = -1;
+    m_nCodecId = 0;
+    m_nLastTimestamp = INT64_MIN;
+    m_bComplete = false;
+    m_bDirty = false;
+    m_bValid = false;
+}
+
+bool CYKeyframeIndex::Load(const std::string& strDir)
+{
+    if (!m_bValid || strDir.empty())
+        return false;
+
+    FILE* pFile = CYCacheFile::OpenFile(m_objFile.CachePath(strDir, KEYFRAME_INDEX_EXT), "rb");
+    if (!pFile)
+        return false;
+
+    CYKeyframeIndexHeader objHeader;
+    std::string strPath;
+    std::vector<Entry> vecEntries;
+    bool bOk = fread(&objHeader, sizeof(objHeader), 1, pFile) == 1 &&
+        objHeader.nMagic == KEYFRAME_INDEX_MAGIC && objHeader.nVersion == KEYFRAME_INDEX_VERSION &&
+        objHeader.nStreamIndex == m_nStreamIndex && objHeader.nCodecId == m_nCodecId &&
+        objHeader.nPathLength == m_objFile.Path().size() && objHeader.nCount <= INT_MAX / sizeof(Entry);
+    if (bOk)
+    {
+        strPath.resize(objHeader.nPathLength);
+        vecEntries.resize(objHeader.nCount);
+        bOk = (!objHeader.nPathLength || fread(&strPath[0], objHeader.nPathLength, 1, pFile) == 1) &&
+            m_objFile.Matches(strPath, objHeader.nSize, objHeader.nModifyTime) &&
+            (!objHeader.nCount || fread(vecEntries.data(), sizeof(Entry), objHeader.nCount, pFile) == objHeader.nCount);
+    }
+    fclose(pFile);
+
+    for (size_t i = 1; bOk && i < vecEntries.size(); i++)
+        bOk = vecEntries[i - 1].nTimestamp < vecEntries[i].nTimestamp;
+    if (!bOk)
+        return false;
+
+    m_vecEntries.swap(vecEntries);
+    m_bComplete = !!objHeader.bComplete;
+    m_bDirty = false;
+    av_log(nullptr, AV_LOG_INFO, "loaded %d keyframes of stream %d for %s\n", Size(), m_nStreamIndex, m_objFile.Path().c_str());
+    return true;
+}
+
+bool CYKeyframeIndex::Save(const std::string& strDir)
+{
+    if (!m_bValid || !m_bDirty || strDir.empty() || m_vecEntries.empty())
+        return false;
+
+    std::string strPath = m_objFile.CachePath(strDir, KEYFRAME_INDEX_EXT);
+    std::string strTempPath = strPath + ".tmp";
+    FILE* pFile = CYCacheFile::OpenFile(strTempPath, "wb");
+    if (!pFile)
+    {
+        av_log(nullptr, AV_LOG_WARNING, "Could not write keyframe index %s\n", strTempPath.c_str());
+        return false;
+    }
+
+    CYKeyframeIndexHeader objHeader = {};
+    objHeader.nMagic = KEYFRAME_INDEX_MAGIC;
+    objHeader.nVersion = KEYFRAME_INDEX_VERSION;
+    objHeader.nSize = m_objFile.Size();
+    objHeader.nModifyTime = m_objFile.ModifyTime();
+    objHeader.nStreamIndex = m_nStreamIndex;
+    objHeader.nCodecId = m_nCodecId;
+    objHeader.nPathLength = (uint32_t)m_objFile.Path().size();
+    objHeader.nCount = (uint32_t)m_vecEntries.size();
+    objHeader.bComplete = m_bComplete;
+
+    bool bOk = fwrite(&objHeader, sizeof(objHeader), 1, pFile) == 1 &&
+        (!objHeader.nPathLength || fwrite(m_objFile.Path().data(), objHeader.nPathLength, 1, pFile) == 1) &&
+        fwrite(m_vecEntries.data(), sizeof(Entry), m_vecEntries.size(), pFile) == m_vecEntries.size();
+    bOk = fclose(pFile) == 0 && bOk;
+    if (!bOk || !CYCacheFile::Rename(strTempPath, strPath))
+    {
+        CYCacheFile::Remove(strTempPath);
+        av_log(nullptr, AV_LOG_WARNING, "Could not write keyframe index %s\n", strPath.c_str());
+        return false;
+    }
+    m_bDirty = false;
+    return true;
+}
+
+void CYKeyframeIndex::Add(int64_t nTimestamp, int64_t nPos, bool bLinked)
+{
+    if (!m_bValid || nTimestamp == AV_NOPTS_VALUE || nPos < 0)
+        return;
+
+    /* a continuous read going back in time is a discontinuity or a wrap, the timestamps
+       no longer map to one position each */
+    if (bLinked && m_nLastTimestamp != INT64_MIN && nTimestamp < m_nLastTimestamp)
+    {
+        av_log(nullptr, AV_LOG_WARNING, "timestamp discontinuity in %s, not indexing keyframes\n", m_objFile.Path().c_str());
+        m_vecEntries.clear();
+        m_bValid = false;
+        return;
+    }
+    m_nLastTimestamp = nTimestamp;
+
+    auto it = std::lower_bound(m_vecEntries.begin(), m_vecEntries.end(), nTimestamp,
+        [](const Entry& objEntry, int64_t nValue) { return objEntry.nTimestamp < nValue; });
+    if (it != m_vecEntries.end() && it->nTimestamp == nTimestamp)
+    {
+        if (bLinked && !it->bLinked)
+        {
+            it->bLinked = 1;
+            m_bDirty = true;
+        }
+        return;
+    }
+
+    /* a keyframe new to a span read before means that span was not what we thought */
+    if (it != m_vecEntries.end())
+        it->bLinked = 0;
+    else
+        m_bComplete = false;
+    m_vecEntries.insert(it, Entry{ nTimestamp, nPos, bLinked ? 1 : 0, 0 });
+    m_bDirty = true;
+}
+
+void CYKeyframeIndex::MarkComplete()
+{
+    if (m_bValid && !m_bComplete && !m_vecEntries.empty())
+    {
+        m_bComplete = true;
+        m_bDirty = true;
+    }
+}
+
+bool CYKeyframeIndex::Lookup(int64_t nTarget, int64_t* pPos, int64_t* pTimestamp) const
+{
+    if (!m_bValid)
+        return false;
+
+    auto it = std::upper_bound(m_vecEntries.begin(), m_vecEntries.end(), nTarget,
+        [](int64_t nValue, const Entry& objEntry) { return nValue < objEntry.nTimestamp; });
+    if (it == m_vecEntries.begin())
+        return false;
+    /* the keyframe after the target must have been reached without a gap, or there is none */
+    if (it == m_vecEntries.end() ? !m_bComplete : !it->bLinked)
+        return false;
+
+    --it;
+    *pPos = it->nPos;
+    if (pTimestamp)
+        *pTimestamp = it->nTimestamp;
+    return true;
+}
+
+void CYKeyframeIndex::AddToStream(AVStream* st) const
+{
+    for (const Entry& objEntry : m_vecEntries)
+        av_add_index_entry(st, objEntry.nPos, av_rescale_q(objEntry.nTimestamp, AV_TIME_BASE_Q, st->time_base), 0, 0, AVINDEX_KEYFRAME);
+}
+
+bool CYKeyframeIndex::Valid() const
+{
+    return m_bValid;
+}
+
+int CYKeyframeIndex::StreamIndex() const
+{
+    return m_nStreamIndex;
+}
+
+int CYKeyframeIndex::Size() const
+{
+    return (int)m_vecEntries.size();
+}
+
+CYPLAYER_NAMESPACE_END
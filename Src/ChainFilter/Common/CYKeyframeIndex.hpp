@@ -0,0 +1,119 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_KEYFRAME_INDEX_HPP__
+#define __CY_KEYFRAME_INDEX_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+#include "ChainFilter/Common/CYCacheFile.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+
+#include <vector>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/**
+ * Keyframe positions of one stream, learnt while demuxing and kept in a sidecar file.
+ *
+ * Containers without an index (MPEG-TS, raw streams, MKV without cues) make
+ * avformat_seek_file bisect or scan the file. The demuxer records the timestamp and byte
+ * offset of every keyframe it reads, and a later seek into a span it has demuxed end to
+ * end goes straight to the byte offset of the keyframe at or before the target. That byte
+ * seek is only used for formats with timestamp discontinuities (MPEG-TS/PS), which resync
+ * at any packet boundary as ffplay's seek by bytes relies on; for other containers the
+ * entries are added to the stream's own index and the seek stays a timestamp seek.
+ *
+ * Each entry remembers whether the span from the previous entry was read without a seek
+ * in between; only then is it certain that no keyframe in it is missing. The index is
+ * saved under the cache directory keyed by path, size and modification time, and loaded
+ * by the next open of the same file. Used by the demux thread only.
+ */
+class CYKeyframeIndex
+{
+public:
+    CYKeyframeIndex();
+    virtual ~CYKeyframeIndex();
+
+public:
+    /* start an empty index for nStreamIndex of pszURL, false when it is not a local file */
+    bool Init(const char* pszURL, int nStreamIndex, int nCodecId);
+    /* replace the entries with the sidecar in strDir if one matches the file and stream */
+    bool Load(const std::string& strDir);
+    /* write the entries to strDir when they changed since Init/Load */
+    bool Save(const std::string& strDir);
+    void Reset();
+
+    /* nTimestamp in AV_TIME_BASE; bLinked when nothing was skipped since the last Add */
+    void Add(int64_t nTimestamp, int64_t nPos, bool bLinked);
+    /* the last Add was followed by the end of the file */
+    void MarkComplete();
+    /* byte offset and timestamp of the keyframe at or before nTarget, if the span is known */
+    bool Lookup(int64_t nTarget, int64_t* pPos, int64_t* pTimestamp) const;
+    /* add every entry to the index of st, which avformat_seek_file searches */
+    void AddToStream(AVStream* st) const;
+
+    bool Valid() const;
+    int  StreamIndex() const;
+    int  Size() const;
+
+private:
+    struct Entry
+    {
+        int64_t nTimestamp;
+        int64_t nPos;
+        int32_t bLinked;
+        int32_t nReserved;
+    };
+
+    CYCacheFile m_objFile;
+    int m_nStreamIndex = -1;
+    int m_nCodecId = 0;
+    std::vector<Entry> m_vecEntries;
+    int64_t m_nLastTimestamp = 0;
+    bool m_bComplete = false;
+    bool m_bDirty = false;
+    bool m_bValid = false;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_KEYFRAME_INDEX_HPP__
@@ -0,0 +1,240 @@
+#include "ChainFilter/Common/CYMappedFileIO.hpp"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+CYPLAYER_NAMESPACE_BEGIN
+
+CYMappedFileIO::CYMappedFileIO()
+{
+
+}
+
+CYMappedFileIO::~CYMappedFileIO()
+{
+    Close();
+}
+
+/* a plain path or a file: URL, anything with another scheme goes through its protocol */
+bool CYMappedFileIO::IsLocalFile(const char* pszURL)
+{
+    if (!pszURL || !*pszURL)
+        return false;
+    if (!strncmp(pszURL, "file:", 5))
+        return true;
+    if (!strcmp(pszURL, "-") || !strncmp(pszURL, "pipe:", 5))
+        return false;
+#ifdef _WIN32
+    /* drive letters look like a one letter scheme */
+    if (((pszURL[0] >= 'a' && pszURL[0] <= 'z') || (pszURL[0] >= 'A' && pszURL[0] <= 'Z')) && pszURL[1] == ':')
+        return true;
+#endif
+    return !strchr(pszURL, ':');
+}
+
+int CYMappedFileIO::Open(const char* pszURL)
+{
+    uint8_t* pBuffer = nullptr;
+
+    Close();
+    if (!IsLocalFile(pszURL))
+        return AVERROR(EINVAL);
+    av_strstart(pszURL, "file:", &pszURL);
+
+#ifdef _WIN32
+    int nLen = MultiByteToWideChar(CP_UTF8, 0, pszURL, -1, nullptr, 0);
+    if (nLen <= 0)
+        return AVERROR(EINVAL);
+    wchar_t* pszWide = (wchar_t*)av_malloc_array(nLen, sizeof(wchar_t));
+    if (!pszWide)
+        return AVERROR(ENOMEM);
+    MultiByteToWideChar(CP_UTF8, 0, pszURL, -1, pszWide, nLen);
+    HANDLE hFile = CreateFileW(pszWide, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    av_free(pszWide);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return AVERROR(ENOENT);
+    m_hFile = hFile;
+
+    LARGE_INTEGER objSize;
+    if (!GetFileSizeEx(hFile, &objSize) || objSize.QuadPart <= 0 || (uint64_t)objSize.QuadPart > SIZE_MAX)
+        goto fail;
+    m_nSize = objSize.QuadPart;
+    if (!(m_hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr)))
+        goto fail;
+    if (!(m_pData = (const uint8_t*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0)))
+        goto fail;
+#else
+    struct stat objStat;
+    void* pMap;
+    if ((m_nFd = open(pszURL, O_RDONLY | O_CLOEXEC)) < 0)
+        return AVERROR(errno);
+    if (fstat(m_nFd, &objStat) < 0 || !S_ISREG(objStat.st_mode) || objStat.st_size <= 0 || (uint64_t)objStat.st_size > SIZE_MAX)
+        goto fail;
+    m_nSize = objStat.st_size;
+    pMap = mmap(nullptr, (size_t)m_nSize, PROT_READ, MAP_SHARED, m_nFd, 0);
+    if (pMap == MAP_FAILED)
+        goto fail;
+    m_pData = (const uint8_t*)pMap;
+    madvise(pMap, (size_t)m_nSize, MADV_SEQUENTIAL);
+#endif
+
+    if (!(pBuffer = (uint8_t*)av_malloc(MAPPED_IO_BUFFER_SIZE)))
+        goto fail;
+    if (!(m_pAVIO = avio_alloc_context(pBuffer, MAPPED_IO_BUFFER_SIZE, 0, this, &CYMappedFileIO::ReadPacket, nullptr, &CYMappedFileIO::Seek)))
+    {
+        av_free(pBuffer);
+        goto fail;
+    }
+    /* payload reads bypass the buffer and copy straight out of the mapping */
+    m_pAVIO->direct = 1;
+    m_pAVIO->seekable = AVIO_SEEKABLE_NORMAL;
+
+    m_nPos = 0;
+    m_nPrefetched = 0;
+    Prefetch(0);
+    return 0;
+
+fail:
+    Close();
+    return AVERROR(EIO);
+}
+
+void CYMappedFileIO::Close()
+{
+    if (m_pAVIO)
+    {
+        av_freep(&m_pAVIO->buffer);
+        avio_context_free(&m_pAVIO);
+    }
+
+#ifdef _WIN32
+    if (m_pData)
+        UnmapViewOfFile(m_pData);
+    if (m_hMapping)
+        CloseHandle(m_hMapping);
+    if (m_hFile)
+        CloseHandle(m_hFile);
+    m_hMapping = nullptr;
+    m_hFile = nullptr;
+#else
+    if (m_pData)
+        munmap((void*)m_pData, (size_t)m_nSize);
+    if (m_nFd >= 0)
+        close(m_nFd);
+    m_nFd = -1;
+    m_bChanged = false;
+#endif
+
+    m_pData = nullptr;
+    m_nSize = 0;
+    m_nPos = 0;
+    m_nPrefetched = 0;
+}
+
+AVIOContext* CYMappedFileIO::Context() const
+{
+    return m_pAVIO;
+}
+
+int64_t CYMappedFileIO::Size() const
+{
+    return m_nSize;
+}
+
+int CYMappedFileIO::ReadPacket(void* pOpaque, uint8_t* pBuf, int nBufSize)
+{
+    CYMappedFileIO* pIO = (CYMappedFileIO*)pOpaque;
+#ifndef _WIN32
+    /* Windows refuses to truncate a mapped file, elsewhere a changed file is no longer copied from */
+    struct stat objStat;
+    if (!pIO->m_bChanged && (fstat(pIO->m_nFd, &objStat) < 0 || objStat.st_size != pIO->m_nSize))
+    {
+        av_log(nullptr, AV_LOG_WARNING, "mapped file changed size during playback, reading it instead\n");
+        pIO->m_bChanged = true;
+    }
+    if (pIO->m_bChanged)
+    {
+        ssize_t nRead = pread(pIO->m_nFd, pBuf, nBufSize, pIO->m_nPos);
+        if (nRead < 0)
+            return AVERROR(errno);
+        if (nRead == 0)
+            return AVERROR_EOF;
+        pIO->m_nPos += nRead;
+        return (int)nRead;
+    }
+#endif
+    int64_t nLeft = pIO->m_nSize - pIO->m_nPos;
+    if (nLeft <= 0)
+        return AVERROR_EOF;
+
+    int nRead = (int)FFMIN((int64_t)nBufSize, nLeft);
+    memcpy(pBuf, pIO->m_pData + pIO->m_nPos, nRead);
+    pIO->m_nPos += nRead;
+
+    /* keep the readahead window MAPPED_IO_PREFETCH_SIZE ahead, refreshed every half window */
+    if (pIO->m_nPos + MAPPED_IO_PREFETCH_SIZE / 2 > pIO->m_nPrefetched)
+        pIO->Prefetch(pIO->m_nPos);
+    return nRead;
+}
+
+int64_t CYMappedFileIO::Seek(void* pOpaque, int64_t nOffset, int nWhence)
+{
+    CYMappedFileIO* pIO = (CYMappedFileIO*)pOpaque;
+    int64_t nPos;
+
+    switch (nWhence & ~AVSEEK_FORCE)
+    {
+    case AVSEEK_SIZE:
+        return pIO->m_nSize;
+    case SEEK_SET:
+        nPos = nOffset;
+        break;
+    case SEEK_CUR:
+        nPos = pIO->m_nPos + nOffset;
+        break;
+    case SEEK_END:
+        nPos = pIO->m_nSize + nOffset;
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+    if (nPos < 0)
+        return AVERROR(EINVAL);
+
+    /* past the end is allowed like lseek, reads there return EOF */
+    if (nPos < pIO->m_nPrefetched - MAPPED_IO_PREFETCH_SIZE || nPos > pIO->m_nPrefetched)
+        pIO->Prefetch(nPos);
+    pIO->m_nPos = nPos;
+    return nPos;
+}
+
+/* ask the kernel to page in [nPos, nPos + MAPPED_IO_PREFETCH_SIZE) in the background */
+void CYMappedFileIO::Prefetch(int64_t nPos)
+{
+    if (nPos >= m_nSize)
+        return;
+    int64_t nEnd = FFMIN(nPos + MAPPED_IO_PREFETCH_SIZE, m_nSize);
+
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY objRange;
+    objRange.VirtualAddress = (PVOID)(m_pData + nPos);
+    objRange.NumberOfBytes = (SIZE_T)(nEnd - nPos);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &objRange, 0);
+#else
+    static const int64_t nPage = sysconf(_SC_PAGESIZE);
+    int64_t nStart = nPos / nPage * nPage;
+    madvise((void*)(m_pData + nStart), (size_t)(nEnd - nStart), MADV_WILLNEED);
+#endif
+    m_nPrefetched = nEnd;
+}
+
+CYPLAYER_NAMESPACE_END
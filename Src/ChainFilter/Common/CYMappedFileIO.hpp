@@ -0,0 +1,106 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_MAPPED_FILE_IO_HPP__
+#define __CY_MAPPED_FILE_IO_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/**
+ * AVIOContext over a read-only memory mapping of a whole local file.
+ *
+ * The context is opened with direct set, so the large reads a demuxer does for packet
+ * payloads are served with a single memcpy from the page cache into the packet, without
+ * a read() call or a pass through the AVIOContext buffer. The mapping is advised
+ * sequential and the next MAPPED_IO_PREFETCH_SIZE bytes are requested ahead of the read
+ * position, again after every seek.
+ *
+ * Only plain paths and file: URLs are mapped; Open fails for anything else, for empty
+ * files and when the mapping does not fit the address space, and the caller falls back
+ * to the file protocol. The object must outlive the AVFormatContext using Context().
+ *
+ * Copying from pages a truncation removed raises SIGBUS instead of a read error, so every
+ * read checks the file size first and, once it changed, reads with pread() as the file
+ * protocol would. A truncation between that check and the copy still faults: the mapping
+ * is meant for files that are not rewritten while they play.
+ */
+class CYMappedFileIO
+{
+public:
+    CYMappedFileIO();
+    virtual ~CYMappedFileIO();
+
+public:
+    static bool IsLocalFile(const char* pszURL);
+
+    int  Open(const char* pszURL);
+    void Close();
+    AVIOContext* Context() const;
+    int64_t Size() const;
+
+private:
+    static int ReadPacket(void* pOpaque, uint8_t* pBuf, int nBufSize);
+    static int64_t Seek(void* pOpaque, int64_t nOffset, int nWhence);
+
+    void Prefetch(int64_t nPos);
+
+private:
+    const uint8_t* m_pData = nullptr;
+    int64_t m_nSize = 0;
+    int64_t m_nPos = 0;
+    int64_t m_nPrefetched = 0;
+    AVIOContext* m_pAVIO = nullptr;
+#ifdef _WIN32
+    void* m_hFile = nullptr;
+    void* m_hMapping = nullptr;
+#else
+    int m_nFd = -1;
+    bool m_bChanged = false;
+#endif
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_MAPPED_FILE_IO_HPP__
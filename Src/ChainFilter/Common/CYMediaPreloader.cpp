@@ -0,0 +1,254 @@
+#include "ChainFilter/Common/CYMediaPreloader.hpp"
+#include "ChainFilter/Common/CYStreamInfoCache.hpp"
+#include "ChainFilter/Context/CYMediaContext.hpp"
+
+#if __cplusplus
+extern "C" {
+#endif
+#include "ChainFilter/Common/cmdutils.h"
+#if __cplusplus
+}
+#endif
+
+CYPLAYER_NAMESPACE_BEGIN
+
+int DecodeInterruptCallBack(void* ctx);
+int OpenCodecContext(SharePtr<CYMediaContext>& ptrContext, AVFormatContext* pIC, int nStreamIndex, AVCodecContextPtr& ptrAVCtx, CYThreadLease& objLease, CYFrameBufferPool* pFramePool);
+
+int CYMediaItem::InterruptCallBack(void* pOpaque)
+{
+    CYMediaItem* pItem = (CYMediaItem*)pOpaque;
+    if (pItem->bCancel)
+        return 1;
+    return pItem->bPlaying ? DecodeInterruptCallBack(pItem->pContext) : pItem->pContext->bAbortRequest;
+}
+
+CYMediaPreloader::CYMediaPreloader()
+{
+
+}
+
+CYMediaPreloader::~CYMediaPreloader()
+{
+    Cancel();
+}
+
+void CYMediaPreloader::Start(SharePtr<CYMediaContext>& ptrContext, SharePtr<EPlayerParam>& ptrParam, const std::string& strURL)
+{
+    Cancel();
+
+    m_ptrContext = ptrContext;
+    m_ptrParam = ptrParam;
+    m_strURL = strURL;
+    m_ptrItem = MakeShared<CYMediaItem>();
+    m_ptrItem->strURL = strURL;
+    m_ptrItem->pContext = ptrContext.get();
+    m_bOpened = false;
+    m_nState = PRELOAD_RUNNING;
+    m_thread = std::thread(&CYMediaPreloader::OnEntry, this);
+}
+
+void CYMediaPreloader::Cancel()
+{
+    if (m_ptrItem)
+        m_ptrItem->bCancel = true;
+    if (m_thread.joinable())
+        m_thread.join();
+    m_ptrItem.reset();
+    m_nState = PRELOAD_IDLE;
+}
+
+bool CYMediaPreloader::Busy() const
+{
+    return m_nState != PRELOAD_IDLE;
+}
+
+bool CYMediaPreloader::Done() const
+{
+    return m_nState == PRELOAD_DONE;
+}
+
+SharePtr<CYMediaItem> CYMediaPreloader::Take()
+{
+    if (m_thread.joinable())
+        m_thread.join();
+
+    SharePtr<CYMediaItem> ptrItem;
+    if (m_bOpened)
+        ptrItem = m_ptrItem;
+    m_ptrItem.reset();
+    m_nState = PRELOAD_IDLE;
+    return ptrItem;
+}
+
+const std::string& CYMediaPreloader::URL() const
+{
+    return m_strURL;
+}
+
+void CYMediaPreloader::OnEntry()
+{
+    int64_t nStartTime = av_gettime_relative();
+    int ret = Open(m_ptrItem.get());
+    if (ret >= 0)
+        ret = PreDecode(m_ptrItem.get());
+
+    m_bOpened = ret >= 0;
+    if (m_bOpened)
+        av_log(nullptr, AV_LOG_INFO, "preloaded %s in %.1f ms\n", m_strURL.c_str(), (av_gettime_relative() - nStartTime) / 1000.0);
+    else if (!m_ptrItem->bCancel)
+        av_log(nullptr, AV_LOG_WARNING, "%s: could not preload the playlist item\n", m_strURL.c_str());
+    m_nState = PRELOAD_DONE;
+    /* the demux thread may be at the end of the previous item, waiting for this one */
+    if (m_ptrContext->ptrReadCond)
+        m_ptrContext->ptrReadCond->NotifyOne();
+}
+
+/* the open sequence of the demuxer, on an AVFormatContext of its own */
+int CYMediaPreloader::Open(CYMediaItem* pItem)
+{
+    const char* pszURL = pItem->strURL.c_str();
+    AVDictionary* pFormatOpts = nullptr;
+    AVFormatContext* pIC = nullptr;
+    int i, ret;
+
+    pIC = avformat_alloc_context();
+    if (!pIC)
+        return AVERROR(ENOMEM);
+    pIC->interrupt_callback.callback = CYMediaItem::InterruptCallBack;
+    pIC->interrupt_callback.opaque = pItem;
+
+    /* the demux thread keeps using the shared options, this open consumes a copy */
+    av_dict_copy(&pFormatOpts, format_opts, 0);
+    av_dict_set(&pFormatOpts, "scan_all_pmts", "1", AV_DICT_DONT_OVERWRITE);
+
+    if (m_ptrContext->bMappedFileIO && CYMappedFileIO::IsLocalFile(pszURL))
+    {
+        SharePtr<CYMappedFileIO> ptrMappedIO = MakeShared<CYMappedFileIO>();
+        if (ptrMappedIO->Open(pszURL) >= 0)
+        {
+            pIC->pb = ptrMappedIO->Context();
+            pItem->ptrMappedIO = ptrMappedIO;
+        }
+    }
+    if (!pIC->pb && m_ptrContext->nReadAheadSize > 0 && !(m_ptrContext->iformat && (m_ptrContext->iformat->flags & AVFMT_NOFILE)))
+    {
+        SharePtr<CYReadAheadIO> ptrReadAheadIO = MakeShared<CYReadAheadIO>();
+        if (ptrReadAheadIO->Open(pszURL, &pIC->interrupt_callback, pFormatOpts, m_ptrContext->nReadAheadSize, &m_ptrContext->objMemAccount) >= 0)
+        {
+            pIC->pb = ptrReadAheadIO->Context();
+            pItem->ptrReadAheadIO = ptrReadAheadIO;
+        }
+    }
+    ret = avformat_open_input(&pIC, pszURL, m_ptrContext->iformat, &pFormatOpts);
+    av_dict_free(&pFormatOpts);
+    if (ret < 0)
+    {
+        print_error(pszURL, ret);
+        return ret;
+    }
+    pItem->ptrIC.reset(pIC);
+
+    if (m_ptrParam->bAutoGenPTS)
+        pIC->flags |= AVFMT_FLAG_GENPTS;
+
+    if (m_ptrParam->bFindStreamInfo && !(m_ptrContext->bStreamInfoCache &&
+        CYStreamInfoCache::Instance().Apply(pIC, pszURL, m_ptrContext->szCacheDir)))
+    {
+        AVDictionary** opts = nullptr;
+        int orig_nb_streams = pIC->nb_streams;
+
+        ret = setup_find_stream_info_opts(pIC, codec_opts, &opts);
+        if (ret < 0)
+            return ret;
+
+        ret = avformat_find_stream_info(pIC, opts);
+
+        for (i = 0; i < orig_nb_streams; i++)
+            av_dict_free(&opts[i]);
+        av_freep(&opts);
+
+        if (ret < 0)
+        {
+            av_log(nullptr, AV_LOG_WARNING, "%s: could not find codec parameters\n", pszURL);
+            return ret;
+        }
+        if (m_ptrContext->bStreamInfoCache)
+            CYStreamInfoCache::Instance().Store(pIC, pszURL, m_ptrContext->szCacheDir);
+    }
+
+    if (pIC->pb)
+        pIC->pb->eof_reached = 0;
+
+    for (i = 0; i < (int)pIC->nb_streams; i++)
+        pIC->streams[i]->discard = AVDISCARD_ALL;
+
+    if (!m_ptrParam->bDisableVideo)
+        pItem->nVideoStreamIndex = FFMAX(av_find_best_stream(pIC, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0), -1);
+    if (!m_ptrParam->bDisableAudio)
+        pItem->nAudioStreamIndex = FFMAX(av_find_best_stream(pIC, AVMEDIA_TYPE_AUDIO, -1, pItem->nVideoStreamIndex, nullptr, 0), -1);
+
+    /* like the demuxer, a stream whose decoder does not open is left out. The video decoder gets its
+       own frame pool and thread lease while the current item's decoder still holds the player's,
+       they pass to the player when it takes over (CYDecoder::SwitchItem) */
+    if (m_ptrContext->bFrameBufferPool)
+        pItem->ptrFramePool = MakeShared<CYFrameBufferPool>();
+    if (pItem->nVideoStreamIndex >= 0 &&
+        OpenCodecContext(m_ptrContext, pIC, pItem->nVideoStreamIndex, pItem->ptrVideoCtx, pItem->objThreadLease, pItem->ptrFramePool.get()) < 0)
+        pItem->nVideoStreamIndex = -1;
+    if (pItem->nAudioStreamIndex >= 0 &&
+        OpenCodecContext(m_ptrContext, pIC, pItem->nAudioStreamIndex, pItem->ptrAudioCtx, pItem->objThreadLease, nullptr) < 0)
+        pItem->nAudioStreamIndex = -1;
+    if (pItem->nVideoStreamIndex < 0 && pItem->nAudioStreamIndex < 0)
+        return AVERROR_STREAM_NOT_FOUND;
+
+    if (pItem->nVideoStreamIndex >= 0)
+        pIC->streams[pItem->nVideoStreamIndex]->discard = AVDISCARD_DEFAULT;
+    if (pItem->nAudioStreamIndex >= 0)
+        pIC->streams[pItem->nAudioStreamIndex]->discard = AVDISCARD_DEFAULT;
+    return 0;
+}
+
+/* read up to the first packet of each stream and send it to its decoder, so the first frames are
+ * decoded by the time the demuxer switches to the item; a video stream starting without a keyframe
+ * and everything read meanwhile are kept for the demuxer to queue */
+int CYMediaPreloader::PreDecode(CYMediaItem* pItem)
+{
+    AVFormatContext* pIC = pItem->ptrIC.get();
+    bool bVideoSent = pItem->nVideoStreamIndex < 0 || (pIC->streams[pItem->nVideoStreamIndex]->disposition & AV_DISPOSITION_ATTACHED_PIC);
+    bool bAudioSent = pItem->nAudioStreamIndex < 0;
+
+    while (!(bVideoSent && bAudioSent) && (int)pItem->vecPackets.size() < PRELOAD_MAX_PACKETS && !pItem->bCancel)
+    {
+        AVPacketPtr ptrPkt = AVPacketPtrCreate();
+        if (!ptrPkt)
+            return AVERROR(ENOMEM);
+        /* errors and the end of a very short item show up again when the demuxer reads it */
+        if (av_read_frame(pIC, ptrPkt.get()) < 0)
+            break;
+
+        AVCodecContext* pAVCtx = nullptr;
+        if (ptrPkt->stream_index == pItem->nVideoStreamIndex && !bVideoSent)
+        {
+            bVideoSent = true;
+            if (ptrPkt->flags & AV_PKT_FLAG_KEY)
+                pAVCtx = pItem->ptrVideoCtx.get();
+        }
+        else if (ptrPkt->stream_index == pItem->nAudioStreamIndex && !bAudioSent)
+        {
+            bAudioSent = true;
+            pAVCtx = pItem->ptrAudioCtx.get();
+        }
+        else if (ptrPkt->stream_index != pItem->nVideoStreamIndex && ptrPkt->stream_index != pItem->nAudioStreamIndex)
+        {
+            continue;
+        }
+
+        if (pAVCtx && avcodec_send_packet(pAVCtx, ptrPkt.get()) >= 0)
+            continue;
+        pItem->vecPackets.push_back(std::move(ptrPkt));
+    }
+    return pItem->bCancel ? AVERROR_EXIT : 0;
+}
+
+CYPLAYER_NAMESPACE_END
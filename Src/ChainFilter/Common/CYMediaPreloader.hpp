@@ -0,0 +1,145 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_MEDIA_PRELOADER_HPP__
+#define __CY_MEDIA_PRELOADER_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+#include "Common/Thread/CYThreadBudget.hpp"
+#include "ChainFilter/Common/CYFrameBufferPool.hpp"
+#include "ChainFilter/Common/CYMappedFileIO.hpp"
+#include "ChainFilter/Common/CYReadAheadIO.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+class CYMediaContext;
+
+/**
+ * A playlist item opened ahead of its turn, and later the item being read or one that is retired.
+ * The custom I/O is declared before the format context it feeds so that it is released last.
+ */
+struct CYMediaItem
+{
+    static int InterruptCallBack(void* pOpaque);
+
+    std::string strURL;
+    CYMediaContext* pContext = nullptr;
+    /* set while cancelled, and once the item is read by the demuxer so a newer seek interrupts it */
+    std::atomic_bool bCancel{ false };
+    std::atomic_bool bPlaying{ false };
+
+    SharePtr<CYMappedFileIO> ptrMappedIO;
+    SharePtr<CYReadAheadIO> ptrReadAheadIO;
+    AVFormatContextPtr ptrIC;
+
+    /* offset of its timestamps on the playback timeline, set once the demuxer reads it */
+    int64_t nOffset = 0;
+
+    int nVideoStreamIndex = -1;
+    int nAudioStreamIndex = -1;
+    AVCodecContextPtr ptrVideoCtx;
+    AVCodecContextPtr ptrAudioCtx;
+    /* held by the video decoder until it replaces the player's, which then takes them over */
+    SharePtr<CYFrameBufferPool> ptrFramePool;
+    CYThreadLease objThreadLease;
+    /* packets read while looking for the first frame of each stream, the demuxer queues them first */
+    std::vector<AVPacketPtr> vecPackets;
+};
+
+/**
+ * Opens the next item of a gapless playlist on its own thread while the current one plays.
+ *
+ * The item goes through the same steps as the demuxer's open: custom I/O, avformat_open_input,
+ * the stream info cache or avformat_find_stream_info, then the best video and audio streams get
+ * their decoders opened with the player's codec options. The first packets are read and the
+ * first audio packet and video keyframe are sent to the decoders, so their first frames are being
+ * decoded before the demuxer takes the item. Take hands the result over once Done.
+ */
+class CYMediaPreloader
+{
+public:
+    CYMediaPreloader();
+    virtual ~CYMediaPreloader();
+
+public:
+    void Start(SharePtr<CYMediaContext>& ptrContext, SharePtr<EPlayerParam>& ptrParam, const std::string& strURL);
+    /* abandon a preload in progress and drop its result */
+    void Cancel();
+    /* an item was started and not taken yet */
+    bool Busy() const;
+    /* the open finished, successfully or not */
+    bool Done() const;
+    /* the opened item, nullptr when the open failed */
+    SharePtr<CYMediaItem> Take();
+    const std::string& URL() const;
+
+private:
+    void OnEntry();
+    int  Open(CYMediaItem* pItem);
+    int  PreDecode(CYMediaItem* pItem);
+
+private:
+    enum
+    {
+        PRELOAD_IDLE,
+        PRELOAD_RUNNING,
+        PRELOAD_DONE,
+    };
+
+    std::atomic<int> m_nState{ PRELOAD_IDLE };
+    std::thread m_thread;
+    std::string m_strURL;
+    SharePtr<CYMediaContext> m_ptrContext;
+    SharePtr<EPlayerParam> m_ptrParam;
+    SharePtr<CYMediaItem> m_ptrItem;
+    bool m_bOpened = false;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_MEDIA_PRELOADER_HPP__
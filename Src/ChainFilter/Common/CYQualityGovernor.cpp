@@ -0,0 +1,102 @@
+#include "ChainFilter/Common/CYQualityGovernor.hpp"
+
+#include <cmath>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+CYQualityGovernor::CYQualityGovernor()
+{
+
+}
+
+CYQualityGovernor::~CYQualityGovernor()
+{
+
+}
+
+void CYQualityGovernor::Reset(bool bEnabled)
+{
+    m_bEnabled = bEnabled;
+    m_nLevel = TYPE_DECODE_QUALITY_FULL;
+    m_nDrops = 0;
+    m_nSamples = 0;
+    m_fDecodeTime = 0;
+    m_nCalmIntervals = 0;
+    m_nCalmNeeded = QUALITY_GOVERNOR_CALM_INTERVALS;
+    m_bJustRaised = false;
+}
+
+void CYQualityGovernor::ReportDecodeTime(double fSeconds, double fFrameDuration)
+{
+    if (!m_bEnabled || isnan(fSeconds) || fSeconds < 0)
+        return;
+
+    m_fDecodeTime += fSeconds;
+    if (++m_nSamples >= QUALITY_GOVERNOR_INTERVAL)
+    {
+        Evaluate(fFrameDuration);
+        m_nSamples = 0;
+        m_fDecodeTime = 0;
+    }
+}
+
+void CYQualityGovernor::ReportDrop()
+{
+    if (m_bEnabled)
+        m_nDrops.fetch_add(1, std::memory_order_relaxed);
+}
+
+EDecodeQuality CYQualityGovernor::Level() const
+{
+    return (EDecodeQuality)m_nLevel.load(std::memory_order_relaxed);
+}
+
+/* behind: late drops while the decoder is busy, or decoding slower than real time. Headroom:
+ * no drops and decoding in well under the frame duration */
+void CYQualityGovernor::Evaluate(double fFrameDuration)
+{
+    int nDrops = m_nDrops.exchange(0);
+    if (fFrameDuration <= 0 || isnan(fFrameDuration))
+        return;
+
+    double fLoad = m_fDecodeTime / m_nSamples / fFrameDuration;
+    int nLevel = m_nLevel;
+    bool bBehind = (nDrops >= QUALITY_GOVERNOR_DROPS && fLoad > QUALITY_GOVERNOR_LOW_LOAD) || fLoad > QUALITY_GOVERNOR_HIGH_LOAD;
+
+    if (bBehind)
+    {
+        m_nCalmIntervals = 0;
+        if (m_bJustRaised)
+            m_nCalmNeeded = FFMIN(m_nCalmNeeded * 2, QUALITY_GOVERNOR_CALM_INTERVALS_MAX);
+        m_bJustRaised = false;
+        if (nLevel < TYPE_DECODE_QUALITY_NO_NONREF)
+        {
+            m_nLevel = nLevel + 1;
+            av_log(nullptr, AV_LOG_INFO, "decode quality %d -> %d (load %.2f, late drops %d)\n", nLevel, nLevel + 1, fLoad, nDrops);
+        }
+        return;
+    }
+
+    m_bJustRaised = false;
+    if (nDrops || fLoad >= QUALITY_GOVERNOR_LOW_LOAD)
+    {
+        m_nCalmIntervals = 0;
+        return;
+    }
+
+    if (nLevel > TYPE_DECODE_QUALITY_FULL && ++m_nCalmIntervals >= m_nCalmNeeded)
+    {
+        m_nCalmIntervals = 0;
+        m_bJustRaised = true;
+        m_nLevel = nLevel - 1;
+        av_log(nullptr, AV_LOG_INFO, "decode quality %d -> %d (load %.2f)\n", nLevel, nLevel - 1, fLoad);
+    }
+    else if (nLevel == TYPE_DECODE_QUALITY_FULL && m_nCalmIntervals++ >= QUALITY_GOVERNOR_CALM_INTERVALS_MAX)
+    {
+        /* long stable at full quality, a later step down starts from the short wait again */
+        m_nCalmNeeded = QUALITY_GOVERNOR_CALM_INTERVALS;
+        m_nCalmIntervals = 0;
+    }
+}
+
+CYPLAYER_NAMESPACE_END
@@ -0,0 +1,97 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_QUALITY_GOVERNOR_HPP__
+#define __CY_QUALITY_GOVERNOR_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+
+#include <atomic>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/**
+ * Decode load governor of a player's video decoder.
+ *
+ * Dropping late frames saves the display but not the decode, which is already paid for. The
+ * governor watches how long pictures take to decode against their duration, and how many are
+ * dropped as late, over QUALITY_GOVERNOR_INTERVAL pictures. When the decoder keeps up only by
+ * dropping, or not at all, it steps down one EDecodeQuality level, and the decode filter makes
+ * the codec skip more work (fast flags, deblocking, IDCT, then non-reference frames). It steps
+ * back up after QUALITY_GOVERNOR_CALM_INTERVALS intervals with headroom and no drops; a level
+ * that had to be left again right away needs twice as long before the next try.
+ */
+class CYQualityGovernor
+{
+public:
+    CYQualityGovernor();
+    virtual ~CYQualityGovernor();
+
+public:
+    /* back to full quality, adapting only when bEnabled */
+    void Reset(bool bEnabled);
+    /* decode thread: one picture took fSeconds to decode while packets were waiting */
+    void ReportDecodeTime(double fSeconds, double fFrameDuration);
+    /* any thread: a picture was dropped because it was late */
+    void ReportDrop();
+    EDecodeQuality Level() const;
+
+private:
+    void Evaluate(double fFrameDuration);
+
+private:
+    std::atomic_bool m_bEnabled{ false };
+    std::atomic<int> m_nLevel{ TYPE_DECODE_QUALITY_FULL };
+    std::atomic<int> m_nDrops{ 0 };
+
+    /* decode thread only */
+    int m_nSamples = 0;
+    double m_fDecodeTime = 0;
+    int m_nCalmIntervals = 0;
+    int m_nCalmNeeded = QUALITY_GOVERNOR_CALM_INTERVALS;
+    bool m_bJustRaised = false;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_QUALITY_GOVERNOR_HPP__
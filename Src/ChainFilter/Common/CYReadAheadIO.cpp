@@ -0,0 +1,239 @@
+#include "ChainFilter/Common/CYReadAheadIO.hpp"
+
+#include <chrono>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+CYReadAheadIO::CYReadAheadIO()
+{
+
+}
+
+CYReadAheadIO::~CYReadAheadIO()
+{
+    Close();
+}
+
+int CYReadAheadIO::Open(const char* pszURL, const AVIOInterruptCB* pInterrupt, AVDictionary* pOptions, int64_t nCacheSize, CYMemoryAccount* pAccount)
+{
+    AVDictionary* pOpts = nullptr;
+    AVIOInterruptCB objInner = { &CYReadAheadIO::InnerInterrupt, this };
+    uint8_t* pBuffer = nullptr;
+    int ret = 0;
+
+    Close();
+    if (pInterrupt)
+        m_objInterrupt = *pInterrupt;
+
+    /* protocol options are consumed from a copy, the demuxer still gets the originals */
+    av_dict_copy(&pOpts, pOptions, 0);
+    ret = avio_open2(&m_pInner, pszURL, AVIO_FLAG_READ, &objInner, &pOpts);
+    av_dict_free(&pOpts);
+    if (ret < 0)
+        return ret;
+
+    m_nSize = avio_size(m_pInner);
+    m_nCacheSize = FFMAX(nCacheSize, (int64_t)READ_AHEAD_CHUNK_SIZE);
+    m_vecCache.resize((size_t)m_nCacheSize);
+    m_objCacheMem.Bind(pAccount, TYPE_MEMORY_PACKETS);
+    m_objCacheMem.Set(m_nCacheSize);
+
+    if (!(pBuffer = (uint8_t*)av_malloc(READ_AHEAD_BUFFER_SIZE)) ||
+        !(m_pAVIO = avio_alloc_context(pBuffer, READ_AHEAD_BUFFER_SIZE, 0, this, &CYReadAheadIO::ReadPacket, nullptr, &CYReadAheadIO::Seek)))
+    {
+        av_free(pBuffer);
+        Close();
+        return AVERROR(ENOMEM);
+    }
+    /* large reads copy straight from the cache into the packet, seeks are cheap in the cache */
+    m_pAVIO->direct = 1;
+    m_pAVIO->seekable = m_pInner->seekable;
+
+    m_nStart = m_nFillPos = m_nReadPos = avio_tell(m_pInner);
+    m_bStop = false;
+    m_thread = std::thread(&CYReadAheadIO::OnEntry, this);
+    return 0;
+}
+
+void CYReadAheadIO::Close()
+{
+    {
+        UniqueLock locker(m_mutex);
+        m_bStop = true;
+        m_cvCond.notify_all();
+    }
+    if (m_thread.joinable())
+        m_thread.join();
+
+    if (m_pAVIO)
+    {
+        av_freep(&m_pAVIO->buffer);
+        avio_context_free(&m_pAVIO);
+    }
+    avio_closep(&m_pInner);
+
+    m_vecCache.clear();
+    m_vecCache.shrink_to_fit();
+    m_objCacheMem.Set(0);
+    m_nCacheSize = 0;
+    m_nSize = -1;
+    m_nStart = m_nFillPos = m_nReadPos = 0;
+    m_nSeekTarget = -1;
+    m_nError = 0;
+    m_bEof = false;
+}
+
+AVIOContext* CYReadAheadIO::Context() const
+{
+    return m_pAVIO;
+}
+
+int CYReadAheadIO::ReadPacket(void* pOpaque, uint8_t* pBuf, int nBufSize)
+{
+    CYReadAheadIO* pIO = (CYReadAheadIO*)pOpaque;
+    UniqueLock locker(pIO->m_mutex);
+
+    while (pIO->m_nReadPos >= pIO->m_nFillPos)
+    {
+        if (pIO->m_nError)
+            return pIO->m_nError;
+        if (pIO->m_bEof)
+            return AVERROR_EOF;
+        if (pIO->Interrupted())
+            return AVERROR_EXIT;
+        pIO->m_cvCond.wait_for(locker, std::chrono::milliseconds(READ_AHEAD_WAIT_MS));
+    }
+
+    /* the I/O thread only writes past m_nFillPos, over bytes already behind m_nReadPos,
+     * so the range copied here cannot change under us */
+    size_t nIndex = (size_t)(pIO->m_nReadPos % pIO->m_nCacheSize);
+    int nRead = (int)FFMIN(FFMIN((int64_t)nBufSize, pIO->m_nFillPos - pIO->m_nReadPos), pIO->m_nCacheSize - (int64_t)nIndex);
+    locker.unlock();
+    memcpy(pBuf, pIO->m_vecCache.data() + nIndex, nRead);
+    locker.lock();
+
+    pIO->m_nReadPos += nRead;
+    pIO->m_cvCond.notify_all();
+    return nRead;
+}
+
+int64_t CYReadAheadIO::Seek(void* pOpaque, int64_t nOffset, int nWhence)
+{
+    CYReadAheadIO* pIO = (CYReadAheadIO*)pOpaque;
+    UniqueLock locker(pIO->m_mutex);
+    int64_t nPos;
+
+    switch (nWhence & ~AVSEEK_FORCE)
+    {
+    case AVSEEK_SIZE:
+        return pIO->m_nSize;
+    case SEEK_SET:
+        nPos = nOffset;
+        break;
+    case SEEK_CUR:
+        nPos = pIO->m_nReadPos + nOffset;
+        break;
+    case SEEK_END:
+        if (pIO->m_nSize < 0)
+            return AVERROR(ENOSYS);
+        nPos = pIO->m_nSize + nOffset;
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+    if (nPos < 0)
+        return AVERROR(EINVAL);
+
+    /* already cached (or about to be read next): no I/O at all */
+    if (nPos >= pIO->m_nStart && nPos <= pIO->m_nFillPos)
+    {
+        pIO->m_nReadPos = nPos;
+        pIO->m_cvCond.notify_all();
+        return nPos;
+    }
+    if (!(pIO->m_pAVIO->seekable & AVIO_SEEKABLE_NORMAL))
+        return AVERROR(ESPIPE);
+
+    /* restart the I/O thread at nPos, a read it has in flight is dropped by the generation check */
+    pIO->m_nGeneration++;
+    pIO->m_nSeekTarget = nPos;
+    pIO->m_nStart = pIO->m_nFillPos = pIO->m_nReadPos = nPos;
+    pIO->m_nError = 0;
+    pIO->m_bEof = false;
+    pIO->m_cvCond.notify_all();
+    return nPos;
+}
+
+/* the underlying protocol gives up when the player aborts or the cache is closed */
+int CYReadAheadIO::InnerInterrupt(void* pOpaque)
+{
+    CYReadAheadIO* pIO = (CYReadAheadIO*)pOpaque;
+    return pIO->m_bStop || pIO->Interrupted();
+}
+
+bool CYReadAheadIO::Interrupted() const
+{
+    return m_objInterrupt.callback && m_objInterrupt.callback(m_objInterrupt.opaque);
+}
+
+void CYReadAheadIO::OnEntry()
+{
+    UniqueLock locker(m_mutex);
+    while (!m_bStop)
+    {
+        if (m_nSeekTarget >= 0)
+        {
+            int64_t nTarget = m_nSeekTarget;
+            int nGeneration = m_nGeneration;
+            m_nSeekTarget = -1;
+            locker.unlock();
+            int64_t ret = avio_seek(m_pInner, nTarget, SEEK_SET);
+            locker.lock();
+            if (ret == AVERROR_EXIT && !m_bStop && nGeneration == m_nGeneration)
+            {
+                m_nSeekTarget = nTarget;
+                m_cvCond.wait_for(locker, std::chrono::milliseconds(READ_AHEAD_WAIT_MS));
+            }
+            else if (ret < 0 && nGeneration == m_nGeneration)
+            {
+                m_nError = (int)ret;
+                m_cvCond.notify_all();
+            }
+            continue;
+        }
+
+        int64_t nAhead = m_nFillPos - m_nReadPos;
+        if (m_bEof || m_nError || nAhead >= m_nCacheSize)
+        {
+            m_cvCond.wait(locker);
+            continue;
+        }
+
+        /* one contiguous piece of the ring, never over bytes the demuxer has not read yet */
+        size_t nIndex = (size_t)(m_nFillPos % m_nCacheSize);
+        int nChunk = (int)FFMIN(FFMIN(m_nCacheSize - nAhead, m_nCacheSize - (int64_t)nIndex), (int64_t)READ_AHEAD_CHUNK_SIZE);
+        int nGeneration = m_nGeneration;
+        /* the bytes about to be overwritten are no longer a valid seek target */
+        m_nStart = FFMAX(m_nStart, m_nFillPos + nChunk - m_nCacheSize);
+        locker.unlock();
+        int nRead = avio_read_partial(m_pInner, m_vecCache.data() + nIndex, nChunk);
+        if (nRead == 0 && avio_feof(m_pInner))
+            nRead = AVERROR_EOF;
+        locker.lock();
+
+        if (nGeneration != m_nGeneration)
+            continue;
+        if (nRead == AVERROR_EOF)
+            m_bEof = true;
+        else if (nRead == AVERROR_EXIT && !m_bStop)
+            /* the player interrupted a seek for a newer one, not an I/O failure: retry shortly */
+            m_cvCond.wait_for(locker, std::chrono::milliseconds(READ_AHEAD_WAIT_MS));
+        else if (nRead < 0)
+            m_nError = nRead;
+        else
+            m_nFillPos += nRead;
+        m_cvCond.notify_all();
+    }
+}
+
+CYPLAYER_NAMESPACE_END
@@ -0,0 +1,116 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_READ_AHEAD_IO_HPP__
+#define __CY_READ_AHEAD_IO_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+#include "Common/Memory/CYMemoryBudget.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/**
+ * AVIOContext that reads ahead of the demuxer on its own thread.
+ *
+ * The I/O thread keeps reading the underlying protocol into a circular byte cache until it
+ * is full, so a slow NFS or disk read stalls that thread instead of the demux loop. The cache
+ * holds the bytes [m_nStart, m_nFillPos) of the input: seeks inside it only move the read
+ * position, seeks outside it drop the cache and restart the I/O thread at the new offset.
+ *
+ * While the demuxer waits for data it polls the player's interrupt callback every
+ * READ_AHEAD_WAIT_MS and gives up with AVERROR_EXIT, like a blocking protocol read would;
+ * the underlying context is opened with the same callback so the I/O thread is released too.
+ */
+class CYReadAheadIO
+{
+public:
+    CYReadAheadIO();
+    virtual ~CYReadAheadIO();
+
+public:
+    int  Open(const char* pszURL, const AVIOInterruptCB* pInterrupt, AVDictionary* pOptions, int64_t nCacheSize, CYMemoryAccount* pAccount);
+    void Close();
+    AVIOContext* Context() const;
+
+private:
+    static int ReadPacket(void* pOpaque, uint8_t* pBuf, int nBufSize);
+    static int64_t Seek(void* pOpaque, int64_t nOffset, int nWhence);
+    static int InnerInterrupt(void* pOpaque);
+
+    void OnEntry();
+    bool Interrupted() const;
+
+private:
+    AVIOContext* m_pAVIO = nullptr;
+    AVIOContext* m_pInner = nullptr;
+    AVIOInterruptCB m_objInterrupt = { nullptr, nullptr };
+    int64_t m_nSize = -1;
+
+    std::vector<uint8_t> m_vecCache;
+    int64_t m_nCacheSize = 0;
+    CYMemoryCharge m_objCacheMem;
+
+    /* guarded by m_mutex */
+    int64_t m_nStart = 0;
+    int64_t m_nFillPos = 0;
+    int64_t m_nReadPos = 0;
+    int64_t m_nSeekTarget = -1;
+    int m_nGeneration = 0;
+    int m_nError = 0;
+    bool m_bEof = false;
+
+    std::atomic_bool m_bStop{ false };
+    std::mutex m_mutex;
+    std::condition_variable m_cvCond;
+    std::thread m_thread;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_READ_AHEAD_IO_HPP__
@@ -0,0 +1,359 @@
+#include "ChainFilter/Common/CYReversePlayback.hpp"
+#include "ChainFilter/Common/CYStreamInfoCache.hpp"
+#include "ChainFilter/Common/CYVideoFilters.hpp"
+#include "ChainFilter/Context/CYMediaContext.hpp"
+
+#if __cplusplus
+extern "C" {
+#endif
+#include "ChainFilter/Common/cmdutils.h"
+#include "libavutil/hwcontext.h"
+#if __cplusplus
+}
+#endif
+
+CYPLAYER_NAMESPACE_BEGIN
+
+int OpenCodecContext(SharePtr<CYMediaContext>& ptrContext, AVFormatContext* pIC, int nStreamIndex, AVCodecContextPtr& ptrAVCtx, CYThreadLease& objLease, CYFrameBufferPool* pFramePool);
+
+CYReversePlayback::CYReversePlayback()
+{
+
+}
+
+CYReversePlayback::~CYReversePlayback()
+{
+    Close();
+}
+
+int CYReversePlayback::InterruptCallBack(void* pOpaque)
+{
+    CYReversePlayback* pThis = (CYReversePlayback*)pOpaque;
+    return pThis->m_bStop || pThis->m_ptrContext->bAbortRequest;
+}
+
+void CYReversePlayback::Start(SharePtr<CYMediaContext>& ptrContext, double fEnd, double fItemOffset)
+{
+    Stop();
+
+    /* a playlist item or a stream change needs an input of its own */
+    if (m_strURL != ptrContext->ptrIC->url || m_nStreamIndex != ptrContext->nVideoStreamIndex)
+        Close();
+
+    m_ptrContext = ptrContext;
+    m_strURL = ptrContext->ptrIC->url;
+    m_nStreamIndex = ptrContext->nVideoStreamIndex;
+    m_fItemOffset = fItemOffset;
+    m_nSerial = ptrContext->ptrVideoQueue->serial;
+    m_fPosition = fEnd;
+    m_objCache.SetMemoryAccount(&ptrContext->objMemAccount);
+    m_objCache.Reset(fEnd, ptrContext->nReverseCacheSize);
+
+    m_bStop = false;
+    m_bRunning = true;
+    m_threadDecode = std::thread(&CYReversePlayback::DecodeEntry, this);
+    m_threadPresent = std::thread(&CYReversePlayback::PresentEntry, this);
+}
+
+void CYReversePlayback::Stop()
+{
+    m_bStop = true;
+    m_objCache.Abort();
+    if (m_ptrContext)
+        m_ptrContext->pictq.WakeWriters();
+    if (m_threadDecode.joinable())
+        m_threadDecode.join();
+    if (m_threadPresent.joinable())
+        m_threadPresent.join();
+    m_objCache.Clear();
+    m_bRunning = false;
+}
+
+void CYReversePlayback::Close()
+{
+    Stop();
+    avfilter_graph_free(&m_pGraph);
+    m_pFilterSrc = nullptr;
+    m_pFilterSink = nullptr;
+    m_nGraphFormat = AV_PIX_FMT_NONE;
+    m_ptrAVCtx.reset();
+    m_objThreadLease.Release();
+    m_ptrIC.reset();
+    m_ptrFrame.reset();
+    m_ptrPkt.reset();
+    m_strURL.clear();
+    m_nStreamIndex = -1;
+}
+
+bool CYReversePlayback::Running() const
+{
+    return m_bRunning;
+}
+
+double CYReversePlayback::Position() const
+{
+    return m_fPosition;
+}
+
+void CYReversePlayback::DecodeEntry()
+{
+    int ret = m_ptrIC ? 0 : Open();
+    if (ret < 0 && !m_bStop)
+        av_log(nullptr, AV_LOG_ERROR, "%s: could not open the input for reverse playback\n", m_strURL.c_str());
+
+    double fEnd = NAN;
+    std::vector<CYCachedFrame> vecFrames;
+    while (ret >= 0 && !m_bStop && m_objCache.WaitForRoom(&fEnd))
+    {
+        bool bStreamStart = false;
+        ret = DecodeGop(fEnd, vecFrames, &bStreamStart);
+        if (ret >= 0)
+            m_objCache.Prepend(vecFrames, fEnd, bStreamStart);
+        vecFrames.clear();
+    }
+
+    if (ret < 0 && !m_bStop)
+    {
+        /* the presenter shows what is cached and stops there, as at the start of the item */
+        av_log(nullptr, AV_LOG_WARNING, "reverse playback stopped at %.3f: %s\n", fEnd, av_err2str(ret));
+        m_objCache.Prepend(vecFrames, m_objCache.Start(), true);
+    }
+}
+
+/* the picture queue is written under mutexPictWriter, which keeps out a video decoder still finishing
+ * a frame from before reversing started; a full queue is waited for outside it, Stop wakes that wait */
+void CYReversePlayback::PresentEntry()
+{
+    CYCachedFrame objFrame;
+    while (!m_bStop && m_objCache.TakeLast(&objFrame))
+    {
+        CYFrame* vp = nullptr;
+        while (!m_bStop)
+        {
+            UniqueLock locker(m_ptrContext->mutexPictWriter);
+            if ((vp = m_ptrContext->pictq.TryPeekWritable()))
+            {
+                vp->sar = objFrame.ptrFrame->sample_aspect_ratio;
+                vp->uploaded = 0;
+                vp->width = objFrame.ptrFrame->width;
+                vp->height = objFrame.ptrFrame->height;
+                vp->format = objFrame.ptrFrame->format;
+                vp->pts = objFrame.fPts;
+                vp->duration = objFrame.fDuration;
+                vp->pos = objFrame.nPos;
+                vp->serial = m_nSerial;
+                av_frame_move_ref(vp->pFrame, objFrame.ptrFrame.get());
+                m_ptrContext->pictq.Push();
+                m_fPosition = objFrame.fPts;
+                break;
+            }
+            locker.unlock();
+            if (!m_ptrContext->pictq.WaitWritable(m_bStop))
+                return;
+        }
+        objFrame.ptrFrame.reset();
+    }
+}
+
+/* the item being played, opened again: the streams are the demuxer's, only the video decoder is opened */
+int CYReversePlayback::Open()
+{
+    const char* pszURL = m_strURL.c_str();
+    AVDictionary* pFormatOpts = nullptr;
+    AVFormatContext* pIC = nullptr;
+    int i, ret;
+
+    pIC = avformat_alloc_context();
+    if (!pIC)
+        return AVERROR(ENOMEM);
+    pIC->interrupt_callback.callback = InterruptCallBack;
+    pIC->interrupt_callback.opaque = this;
+
+    av_dict_copy(&pFormatOpts, format_opts, 0);
+    ret = avformat_open_input(&pIC, pszURL, m_ptrContext->iformat, &pFormatOpts);
+    av_dict_free(&pFormatOpts);
+    if (ret < 0)
+        return ret;
+    m_ptrIC.reset(pIC);
+
+    if (!(m_ptrContext->bStreamInfoCache && CYStreamInfoCache::Instance().Apply(pIC, pszURL, m_ptrContext->szCacheDir)) &&
+        (ret = avformat_find_stream_info(pIC, nullptr)) < 0)
+        return ret;
+    if (m_nStreamIndex < 0 || m_nStreamIndex >= (int)pIC->nb_streams ||
+        pIC->streams[m_nStreamIndex]->codecpar->codec_type != AVMEDIA_TYPE_VIDEO)
+        return AVERROR_STREAM_NOT_FOUND;
+
+    for (i = 0; i < (int)pIC->nb_streams; i++)
+        pIC->streams[i]->discard = i == m_nStreamIndex ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+
+    if ((ret = OpenCodecContext(m_ptrContext, pIC, m_nStreamIndex, m_ptrAVCtx, m_objThreadLease, nullptr)) < 0)
+        return ret;
+
+    m_ptrFrame = AVFramePtrCreate();
+    m_ptrPkt = AVPacketPtrCreate();
+    if (!m_ptrFrame || !m_ptrPkt)
+        return AVERROR(ENOMEM);
+    return 0;
+}
+
+/* the pictures from the keyframe at or before fEnd up to fEnd; when that keyframe yields none (seeking
+ * landed on a later one, or its pictures all start at fEnd) look further back, until the start */
+int CYReversePlayback::DecodeGop(double fEnd, std::vector<CYCachedFrame>& vecFrames, bool* pbStreamStart)
+{
+    AVFormatContext* pIC = m_ptrIC.get();
+    AVStream* st = pIC->streams[m_nStreamIndex];
+    int64_t nStart = st->start_time != AV_NOPTS_VALUE ? av_rescale_q(st->start_time, st->time_base, AV_TIME_BASE_Q) :
+        pIC->start_time != AV_NOPTS_VALUE ? pIC->start_time : 0;
+    int64_t nEnd = (int64_t)((fEnd - m_fItemOffset) * AV_TIME_BASE);
+    int64_t nBackoff = 1;
+    int ret;
+
+    *pbStreamStart = false;
+    while (!m_bStop)
+    {
+        int64_t nTarget = nEnd - nBackoff;
+        /* no keyframe before the target is the start too */
+        if (avformat_seek_file(pIC, -1, INT64_MIN, nTarget, nTarget, 0) < 0)
+        {
+            *pbStreamStart = true;
+            return 0;
+        }
+        avcodec_flush_buffers(m_ptrAVCtx.get());
+
+        if ((ret = DecodeUntil(fEnd, vecFrames)) < 0)
+            return ret;
+        if (!vecFrames.empty() || nTarget <= nStart)
+        {
+            *pbStreamStart = vecFrames.empty() || (int64_t)((m_fKeyPts - m_fItemOffset) * AV_TIME_BASE) <= nStart;
+            return 0;
+        }
+        nBackoff = FFMAX(nBackoff * 2, AV_TIME_BASE / 2);
+    }
+    return AVERROR_EXIT;
+}
+
+/* decode from where the input was seeked to until a picture at fEnd or later comes out */
+int CYReversePlayback::DecodeUntil(double fEnd, std::vector<CYCachedFrame>& vecFrames)
+{
+    AVRational tb = m_ptrIC->streams[m_nStreamIndex]->time_base;
+    AVCodecContext* pAVCtx = m_ptrAVCtx.get();
+    AVFrame* pFrame = m_ptrFrame.get();
+    AVPacket* pPkt = m_ptrPkt.get();
+    bool bDone = false, bDraining = false;
+    int ret = 0;
+
+    m_fKeyPts = NAN;
+    while (!bDone && !m_bStop)
+    {
+        if (!bDraining)
+        {
+            ret = av_read_frame(m_ptrIC.get(), pPkt);
+            if (ret == AVERROR_EOF)
+                bDraining = true;
+            else if (ret < 0)
+                return ret;
+            else if (pPkt->stream_index != m_nStreamIndex)
+            {
+                av_packet_unref(pPkt);
+                continue;
+            }
+            /* a damaged packet costs a picture, as in the decoder */
+            avcodec_send_packet(pAVCtx, bDraining ? nullptr : pPkt);
+            av_packet_unref(pPkt);
+        }
+
+        while (!bDone && (ret = avcodec_receive_frame(pAVCtx, pFrame)) >= 0)
+        {
+            pFrame->pts = pFrame->best_effort_timestamp;
+            double fPts = pFrame->pts == AV_NOPTS_VALUE ? NAN : pFrame->pts * av_q2d(tb) + m_fItemOffset;
+            /* pictures before the keyframe, and the leading pictures of an open GOP, belong to the previous GOP */
+            if (isnan(m_fKeyPts) && (pFrame->flags & AV_FRAME_FLAG_KEY))
+                m_fKeyPts = fPts;
+            if (isnan(fPts) || isnan(m_fKeyPts) || fPts < m_fKeyPts)
+            {
+                av_frame_unref(pFrame);
+                continue;
+            }
+            if (fPts >= fEnd)
+            {
+                bDone = true;
+                av_frame_unref(pFrame);
+                break;
+            }
+            ret = FilterFrame(pFrame, fEnd, vecFrames);
+            av_frame_unref(pFrame);
+            if (ret < 0)
+                return ret;
+        }
+        if (bDraining)
+            break;
+    }
+    return m_bStop ? AVERROR_EXIT : 0;
+}
+
+/* hardware pictures are downloaded, the decoder's surface pool is far smaller than a GOP cache; the graph
+ * is the decoder's one (autorotate, -vf, the texture formats) and rebuilt when the picture changes */
+int CYReversePlayback::FilterFrame(AVFrame* pFrame, double fEnd, std::vector<CYCachedFrame>& vecFrames)
+{
+    int ret;
+    if (pFrame->hw_frames_ctx)
+    {
+        AVFramePtr ptrSwFrame = AVFramePtrCreate();
+        if (!ptrSwFrame)
+            return AVERROR(ENOMEM);
+        if ((ret = av_hwframe_transfer_data(ptrSwFrame.get(), pFrame, 0)) < 0 ||
+            (ret = av_frame_copy_props(ptrSwFrame.get(), pFrame)) < 0)
+            return ret;
+        av_frame_unref(pFrame);
+        av_frame_move_ref(pFrame, ptrSwFrame.get());
+    }
+
+    if (!m_pGraph || m_nGraphWidth != pFrame->width || m_nGraphHeight != pFrame->height ||
+        m_nGraphFormat != pFrame->format || m_nGraphVFilter != m_ptrContext->nVFilterIndex)
+    {
+        avfilter_graph_free(&m_pGraph);
+        m_pGraph = avfilter_graph_alloc();
+        if (!m_pGraph)
+            return AVERROR(ENOMEM);
+        m_pGraph->nb_threads = FILTER_NB_THREADS;
+        if ((ret = ConfigureVideoFilters(m_pGraph, m_ptrContext, m_ptrContext->pVfiltersList ? m_ptrContext->pVfiltersList[m_ptrContext->nVFilterIndex] : nullptr,
+            pFrame, &m_pFilterSrc, &m_pFilterSink)) < 0)
+        {
+            avfilter_graph_free(&m_pGraph);
+            return ret;
+        }
+        m_nGraphWidth = pFrame->width;
+        m_nGraphHeight = pFrame->height;
+        m_nGraphFormat = pFrame->format;
+        m_nGraphVFilter = m_ptrContext->nVFilterIndex;
+        AVRational objFrameRate = av_buffersink_get_frame_rate(m_pFilterSink);
+        m_fFrameDuration = objFrameRate.num && objFrameRate.den ? av_q2d(AVRational{ objFrameRate.den, objFrameRate.num }) : 0;
+    }
+
+    if ((ret = av_buffersrc_add_frame(m_pFilterSrc, pFrame)) < 0)
+        return ret;
+
+    AVRational tb = av_buffersink_get_time_base(m_pFilterSink);
+    for (;;)
+    {
+        CYCachedFrame objFrame;
+        objFrame.ptrFrame = AVFramePtrCreate();
+        if (!objFrame.ptrFrame)
+            return AVERROR(ENOMEM);
+        ret = av_buffersink_get_frame_flags(m_pFilterSink, objFrame.ptrFrame.get(), 0);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
+            return 0;
+        if (ret < 0)
+            return ret;
+
+        AVFrame* pOut = objFrame.ptrFrame.get();
+        objFrame.fPts = pOut->pts == AV_NOPTS_VALUE ? NAN : pOut->pts * av_q2d(tb) + m_fItemOffset;
+        objFrame.fDuration = pOut->duration > 0 ? pOut->duration * av_q2d(tb) : m_fFrameDuration;
+        for (int i = 0; i < AV_NUM_DATA_POINTERS && pOut->buf[i]; i++)
+            objFrame.nBytes += pOut->buf[i]->size;
+        if (!isnan(objFrame.fPts) && objFrame.fPts < fEnd)
+            vecFrames.push_back(std::move(objFrame));
+    }
+}
+
+CYPLAYER_NAMESPACE_END
@@ -0,0 +1,134 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_REVERSE_PLAYBACK_HPP__
+#define __CY_REVERSE_PLAYBACK_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+#include "Common/Thread/CYThreadBudget.hpp"
+#include "ChainFilter/Common/CYGopCache.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+class CYMediaContext;
+
+/**
+ * Feeds the picture queue backwards, for SetSpeed(REVERSE_PLAY_SPEED) and StepBack.
+ *
+ * A worker thread reads the item being played through an AVFormatContext and a decoder of its
+ * own, so the demuxer's position and the video decoder's state are left alone. The decoder claims
+ * its threads on a lease of its own and allocates outside the player's frame pool, whose buffers
+ * the cache would otherwise hold beyond what the pool was sized for. For every GOP it
+ * seeks to the keyframe before the earliest picture cached, decodes up to that picture, runs the
+ * result through a video filter graph like the decoder's and prepends it to a CYGopCache.
+ * A second thread takes the pictures from the end of the cache and queues them for the renderer
+ * under the serial the video queue had when reversing started.
+ */
+class CYReversePlayback
+{
+public:
+    CYReversePlayback();
+    virtual ~CYReversePlayback();
+
+public:
+    /* show the pictures before fEnd (seconds on the playback timeline) backwards, from the item being
+     * read, which the demuxer first takes back to the one fEnd is in; fItemOffset is that item's offset */
+    void Start(SharePtr<CYMediaContext>& ptrContext, double fEnd, double fItemOffset);
+    void Stop();
+    /* Stop, and release the input and decoder that are otherwise kept for the next Start */
+    void Close();
+    bool Running() const;
+    /* the last picture queued for the renderer, or the start position before the first */
+    double Position() const;
+
+private:
+    static int InterruptCallBack(void* pOpaque);
+
+    void DecodeEntry();
+    void PresentEntry();
+    int  Open();
+    int  DecodeGop(double fEnd, std::vector<CYCachedFrame>& vecFrames, bool* pbStreamStart);
+    int  DecodeUntil(double fEnd, std::vector<CYCachedFrame>& vecFrames);
+    int  FilterFrame(AVFrame* pFrame, double fEnd, std::vector<CYCachedFrame>& vecFrames);
+
+private:
+    SharePtr<CYMediaContext> m_ptrContext;
+    CYGopCache m_objCache;
+    std::thread m_threadDecode;
+    std::thread m_threadPresent;
+    std::atomic_bool m_bStop{ false };
+    std::atomic_bool m_bRunning{ false };
+    std::atomic<double> m_fPosition{ NAN };
+    double m_fItemOffset = 0;
+    int m_nSerial = 0;
+
+    /* kept open between runs on the same item */
+    std::string m_strURL;
+    int m_nStreamIndex = -1;
+    AVFormatContextPtr m_ptrIC;
+    AVCodecContextPtr m_ptrAVCtx;
+    CYThreadLease m_objThreadLease;
+    AVFramePtr m_ptrFrame;
+    AVPacketPtr m_ptrPkt;
+
+    /* the filter graph and what it was configured for */
+    AVFilterGraph* m_pGraph = nullptr;
+    AVFilterContext* m_pFilterSrc = nullptr;
+    AVFilterContext* m_pFilterSink = nullptr;
+    int m_nGraphWidth = 0;
+    int m_nGraphHeight = 0;
+    int m_nGraphFormat = AV_PIX_FMT_NONE;
+    int m_nGraphVFilter = -1;
+    double m_fFrameDuration = 0;
+    /* pts of the keyframe the GOP being decoded starts at */
+    double m_fKeyPts = NAN;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_REVERSE_PLAYBACK_HPP__
@@ -0,0 +1,107 @@
+#include "ChainFilter/Common/CYSeekRequest.hpp"
+
+CYPLAYER_NAMESPACE_BEGIN
+
+CYSeekRequest::CYSeekRequest()
+{
+
+}
+
+CYSeekRequest::~CYSeekRequest()
+{
+
+}
+
+uint64_t CYSeekRequest::Post(int64_t nPos, int64_t nRel, bool bByBytes, bool bAccurate)
+{
+    LockGuard locker(m_mutex);
+    m_objPending.nPos = nPos;
+    m_objPending.nRel = nRel;
+    m_objPending.bByBytes = bByBytes;
+    m_objPending.bAccurate = bAccurate;
+    m_objPending.nGeneration = m_nPosted.load(std::memory_order_relaxed) + 1;
+    m_objPending.nRequestTime = Now();
+    m_nPosted.store(m_objPending.nGeneration, std::memory_order_release);
+    return m_objPending.nGeneration;
+}
+
+bool CYSeekRequest::Take(CYSeekTarget* pTarget)
+{
+    if (!Pending())
+        return false;
+
+    LockGuard locker(m_mutex);
+    *pTarget = m_objPending;
+    m_nTaken.store(m_objPending.nGeneration, std::memory_order_release);
+    return true;
+}
+
+bool CYSeekRequest::Pending() const
+{
+    return m_nPosted.load(std::memory_order_acquire) != m_nTaken.load(std::memory_order_acquire);
+}
+
+bool CYSeekRequest::Superseded(uint64_t nGeneration) const
+{
+    return m_nPosted.load(std::memory_order_acquire) > nGeneration;
+}
+
+void CYSeekRequest::Reset()
+{
+    LockGuard locker(m_mutex);
+    m_objPending = CYSeekTarget();
+    m_nPosted = 0;
+    m_nTaken = 0;
+    ClearDecodeTarget();
+    m_nWatchSerial = -1;
+}
+
+void CYSeekRequest::SetDecodeTarget(int64_t nTarget, int nVideoSerial, int nAudioSerial, uint64_t nGeneration)
+{
+    /* invalidate first so a decoder never pairs the new serials with the old target */
+    m_nVideoSerial = -1;
+    m_nAudioSerial = -1;
+    m_nDecodeTarget = nTarget;
+    m_nDecodeGeneration = nGeneration;
+    m_nVideoSerial = nVideoSerial;
+    m_nAudioSerial = nAudioSerial;
+}
+
+void CYSeekRequest::ClearDecodeTarget()
+{
+    m_nVideoSerial = -1;
+    m_nAudioSerial = -1;
+    m_nDecodeTarget = INT64_MIN;
+    m_nDecodeGeneration = 0;
+}
+
+bool CYSeekRequest::SkipFrame(bool bAudio, int nSerial, int64_t nEnd) const
+{
+    if (nSerial < 0 || nSerial != (bAudio ? m_nAudioSerial : m_nVideoSerial).load())
+        return false;
+    if (Superseded(m_nDecodeGeneration))
+        return true;
+    return nEnd <= m_nDecodeTarget;
+}
+
+void CYSeekRequest::WatchDisplay(int nVideoSerial, int64_t nRequestTime)
+{
+    m_nWatchSerial = -1;
+    m_nWatchTime = nRequestTime;
+    m_nWatchSerial = nVideoSerial;
+}
+
+int64_t CYSeekRequest::FrameDisplayed(int nSerial)
+{
+    int nWatched = nSerial;
+    if (nSerial < 0 || !m_nWatchSerial.compare_exchange_strong(nWatched, -1))
+        return -1;
+    return Now() - m_nWatchTime;
+}
+
+int64_t CYSeekRequest::Now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+CYPLAYER_NAMESPACE_END
@@ -0,0 +1,121 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_SEEK_REQUEST_HPP__
+#define __CY_SEEK_REQUEST_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/* one seek as posted by the API or the render thread */
+struct CYSeekTarget
+{
+    int64_t nPos = 0;
+    int64_t nRel = 0;
+    bool bByBytes = false;
+    bool bAccurate = false;
+    uint64_t nGeneration = 0;
+    int64_t nRequestTime = 0;   /* CYSeekRequest::Now() when posted */
+};
+
+/**
+ * Latest-wins seek slot shared by the posting threads, the demux thread and the decoders.
+ *
+ * Every Post overwrites the slot and bumps the generation, so a burst of seeks collapses
+ * into the newest one and the demux thread only ever executes what the user asked for
+ * last. Once a seek was executed, SetDecodeTarget tells the decoders which serials belong
+ * to it; they drop frames ending before an accurate target, and drop everything of that
+ * seek as soon as a newer one is posted instead of finishing work nobody will see.
+ */
+class CYSeekRequest
+{
+public:
+    CYSeekRequest();
+    virtual ~CYSeekRequest();
+
+public:
+    /* any thread: replace the pending target, returns its generation */
+    uint64_t Post(int64_t nPos, int64_t nRel, bool bByBytes, bool bAccurate);
+    /* demux thread: move the newest target out of the slot, false when none is pending */
+    bool Take(CYSeekTarget* pTarget);
+    bool Pending() const;
+    /* a target newer than nGeneration was posted */
+    bool Superseded(uint64_t nGeneration) const;
+    void Reset();
+
+    /* demux thread: the executed seek restarted the queues at these serials, INT64_MIN when any frame will do */
+    void SetDecodeTarget(int64_t nTarget, int nVideoSerial, int nAudioSerial, uint64_t nGeneration);
+    void ClearDecodeTarget();
+    /* decoders: a frame of nSerial ending at nEnd (AV_TIME_BASE) is before the target or outdated */
+    bool SkipFrame(bool bAudio, int nSerial, int64_t nEnd) const;
+
+    /* demux thread: time the first frame of nVideoSerial reaching the screen */
+    void WatchDisplay(int nVideoSerial, int64_t nRequestTime);
+    /* render thread: a frame of nSerial was presented, returns the seek latency in microseconds once, -1 otherwise */
+    int64_t FrameDisplayed(int nSerial);
+
+    /* monotonic clock in microseconds */
+    static int64_t Now();
+
+private:
+    mutable std::mutex m_mutex;
+    CYSeekTarget m_objPending;
+    std::atomic<uint64_t> m_nPosted{ 0 };
+    std::atomic<uint64_t> m_nTaken{ 0 };
+
+    std::atomic<int64_t> m_nDecodeTarget{ INT64_MIN };
+    std::atomic<int> m_nVideoSerial{ -1 };
+    std::atomic<int> m_nAudioSerial{ -1 };
+    std::atomic<uint64_t> m_nDecodeGeneration{ 0 };
+
+    std::atomic<int> m_nWatchSerial{ -1 };
+    std::atomic<int64_t> m_nWatchTime{ 0 };
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_SEEK_REQUEST_HPP__
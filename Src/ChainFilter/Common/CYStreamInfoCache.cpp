@@ -0,0 +1,342 @@
+#include "ChainFilter/Common/CYStreamInfoCache.hpp"
+#include "ChainFilter/Common/CYCacheFile.hpp"
+
+#include <vector>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+#define STREAM_INFO_MAGIC   0x49535943 /* "CYSI" */
+#define STREAM_INFO_VERSION 1
+#define STREAM_INFO_EXT     ".cysi"
+
+/* entry layout: header, path, format name, then per stream the fields below and its extradata.
+ * native byte order, the entry is a local cache */
+struct CYStreamInfoHeader
+{
+    uint32_t nMagic;
+    uint32_t nVersion;
+    int64_t nSize;
+    int64_t nModifyTime;
+    int64_t nStartTime;
+    int64_t nDuration;
+    int64_t nBitRate;
+    uint32_t nPathLength;
+    uint32_t nFormatLength;
+    uint32_t nStreams;
+    uint32_t nReserved;
+};
+
+struct CYStreamInfoEntry
+{
+    int32_t nCodecType;
+    int32_t nCodecId;
+    uint32_t nCodecTag;
+    int32_t nFormat;
+    int64_t nBitRate;
+    int32_t nBitsPerCodedSample;
+    int32_t nBitsPerRawSample;
+    int32_t nProfile;
+    int32_t nLevel;
+    int32_t nWidth;
+    int32_t nHeight;
+    AVRational objSampleAspectRatio;
+    AVRational objFrameRate;
+    int32_t nFieldOrder;
+    int32_t nColorRange;
+    int32_t nColorPrimaries;
+    int32_t nColorTrc;
+    int32_t nColorSpace;
+    int32_t nChromaLocation;
+    int32_t nVideoDelay;
+    int32_t nChannelOrder;
+    int32_t nChannels;
+    int32_t nSampleRate;
+    uint64_t nChannelMask;
+    int32_t nBlockAlign;
+    int32_t nFrameSize;
+    int32_t nInitialPadding;
+    int32_t nTrailingPadding;
+    int32_t nSeekPreroll;
+    int32_t nDisposition;
+    AVRational objTimeBase;
+    AVRational objAvgFrameRate;
+    AVRational objRealFrameRate;
+    AVRational objStreamAspectRatio;
+    int64_t nStartTime;
+    int64_t nDuration;
+    int64_t nFrames;
+    int32_t nExtradataSize;
+    int32_t nReserved;
+};
+
+static void Append(std::string& strBlob, const void* pData, size_t nSize)
+{
+    strBlob.append((const char*)pData, nSize);
+}
+
+static bool Take(const std::string& strBlob, size_t& nOffset, void* pData, size_t nSize)
+{
+    if (nSize > strBlob.size() - nOffset)
+        return false;
+    memcpy(pData, strBlob.data() + nOffset, nSize);
+    nOffset += nSize;
+    return true;
+}
+
+CYStreamInfoCache& CYStreamInfoCache::Instance()
+{
+    static CYStreamInfoCache s_objCache;
+    return s_objCache;
+}
+
+CYStreamInfoCache::CYStreamInfoCache()
+{
+
+}
+
+CYStreamInfoCache::~CYStreamInfoCache()
+{
+
+}
+
+bool CYStreamInfoCache::Apply(AVFormatContext* pIC, const char* pszURL, const char* pszDir)
+{
+    CYCacheFile objFile;
+    std::string strBlob;
+    if (!pIC->iformat || !objFile.Query(pszURL))
+        return false;
+    std::string strKey = objFile.CachePath(pszDir ? pszDir : "", STREAM_INFO_EXT);
+    if (!Find(strKey, &strBlob))
+        return false;
+
+    CYStreamInfoHeader objHeader;
+    std::string strPath, strFormat;
+    size_t nOffset = 0;
+    if (!Take(strBlob, nOffset, &objHeader, sizeof(objHeader)) ||
+        objHeader.nMagic != STREAM_INFO_MAGIC || objHeader.nVersion != STREAM_INFO_VERSION ||
+        objHeader.nPathLength > strBlob.size() || objHeader.nFormatLength > strBlob.size() ||
+        objHeader.nStreams != pIC->nb_streams)
+        return false;
+    strPath.resize(objHeader.nPathLength);
+    strFormat.resize(objHeader.nFormatLength);
+    if (!Take(strBlob, nOffset, &strPath[0], strPath.size()) || !Take(strBlob, nOffset, &strFormat[0], strFormat.size()) ||
+        !objFile.Matches(strPath, objHeader.nSize, objHeader.nModifyTime) || strFormat != pIC->iformat->name)
+        return false;
+
+    /* check every stream before touching any */
+    std::vector<CYStreamInfoEntry> vecEntries(pIC->nb_streams);
+    std::vector<std::string> vecExtradata(pIC->nb_streams);
+    for (unsigned i = 0; i < pIC->nb_streams; i++)
+    {
+        CYStreamInfoEntry& objEntry = vecEntries[i];
+        AVStream* st = pIC->streams[i];
+        if (!Take(strBlob, nOffset, &objEntry, sizeof(objEntry)) || objEntry.nExtradataSize < 0)
+            return false;
+        vecExtradata[i].resize(objEntry.nExtradataSize);
+        if (!Take(strBlob, nOffset, &vecExtradata[i][0], vecExtradata[i].size()))
+            return false;
+        if (objEntry.nCodecType != st->codecpar->codec_type || objEntry.nCodecId != st->codecpar->codec_id ||
+            av_cmp_q(objEntry.objTimeBase, st->time_base))
+            return false;
+        /* a damaged or foreign entry: only layouts without a channel map are stored, see Store */
+        if ((objEntry.nChannelOrder != AV_CHANNEL_ORDER_NATIVE && objEntry.nChannelOrder != AV_CHANNEL_ORDER_UNSPEC &&
+            objEntry.nChannelOrder != AV_CHANNEL_ORDER_AMBISONIC) ||
+            objEntry.nChannels < 0 || objEntry.nWidth < 0 || objEntry.nHeight < 0 || objEntry.nSampleRate < 0)
+            return false;
+    }
+
+    for (unsigned i = 0; i < pIC->nb_streams; i++)
+    {
+        const CYStreamInfoEntry& objEntry = vecEntries[i];
+        AVStream* st = pIC->streams[i];
+        AVCodecParameters* par = st->codecpar;
+
+        if (!vecExtradata[i].empty())
+        {
+            uint8_t* pExtradata = (uint8_t*)av_mallocz(vecExtradata[i].size() + AV_INPUT_BUFFER_PADDING_SIZE);
+            if (!pExtradata)
+                return false;
+            memcpy(pExtradata, vecExtradata[i].data(), vecExtradata[i].size());
+            av_freep(&par->extradata);
+            par->extradata = pExtradata;
+            par->extradata_size = (int)vecExtradata[i].size();
+        }
+        par->codec_tag = objEntry.nCodecTag;
+        par->format = objEntry.nFormat;
+        par->bit_rate = objEntry.nBitRate;
+        par->bits_per_coded_sample = objEntry.nBitsPerCodedSample;
+        par->bits_per_raw_sample = objEntry.nBitsPerRawSample;
+        par->profile = objEntry.nProfile;
+        par->level = objEntry.nLevel;
+        par->width = objEntry.nWidth;
+        par->height = objEntry.nHeight;
+        par->sample_aspect_ratio = objEntry.objSampleAspectRatio;
+        par->framerate = objEntry.objFrameRate;
+        par->field_order = (AVFieldOrder)objEntry.nFieldOrder;
+        par->color_range = (AVColorRange)objEntry.nColorRange;
+        par->color_primaries = (AVColorPrimaries)objEntry.nColorPrimaries;
+        par->color_trc = (AVColorTransferCharacteristic)objEntry.nColorTrc;
+        par->color_space = (AVColorSpace)objEntry.nColorSpace;
+        par->chroma_location = (AVChromaLocation)objEntry.nChromaLocation;
+        par->video_delay = objEntry.nVideoDelay;
+        av_channel_layout_uninit(&par->ch_layout);
+        par->ch_layout.order = (AVChannelOrder)objEntry.nChannelOrder;
+        par->ch_layout.nb_channels = objEntry.nChannels;
+        par->ch_layout.u.mask = objEntry.nChannelMask;
+        par->sample_rate = objEntry.nSampleRate;
+        par->block_align = objEntry.nBlockAlign;
+        par->frame_size = objEntry.nFrameSize;
+        par->initial_padding = objEntry.nInitialPadding;
+        par->trailing_padding = objEntry.nTrailingPadding;
+        par->seek_preroll = objEntry.nSeekPreroll;
+
+        st->disposition = objEntry.nDisposition;
+        st->avg_frame_rate = objEntry.objAvgFrameRate;
+        st->r_frame_rate = objEntry.objRealFrameRate;
+        st->sample_aspect_ratio = objEntry.objStreamAspectRatio;
+        st->start_time = objEntry.nStartTime;
+        st->duration = objEntry.nDuration;
+        st->nb_frames = objEntry.nFrames;
+    }
+    pIC->start_time = objHeader.nStartTime;
+    pIC->duration = objHeader.nDuration;
+    pIC->bit_rate = objHeader.nBitRate;
+    av_log(nullptr, AV_LOG_INFO, "%s: stream info from cache, probe skipped\n", objFile.Path().c_str());
+    return true;
+}
+
+void CYStreamInfoCache::Store(const AVFormatContext* pIC, const char* pszURL, const char* pszDir)
+{
+    CYCacheFile objFile;
+    if (!pIC->iformat || !pIC->nb_streams || !objFile.Query(pszURL))
+        return;
+
+    CYStreamInfoHeader objHeader = {};
+    objHeader.nMagic = STREAM_INFO_MAGIC;
+    objHeader.nVersion = STREAM_INFO_VERSION;
+    objHeader.nSize = objFile.Size();
+    objHeader.nModifyTime = objFile.ModifyTime();
+    objHeader.nStartTime = pIC->start_time;
+    objHeader.nDuration = pIC->duration;
+    objHeader.nBitRate = pIC->bit_rate;
+    objHeader.nPathLength = (uint32_t)objFile.Path().size();
+    objHeader.nFormatLength = (uint32_t)strlen(pIC->iformat->name);
+    objHeader.nStreams = pIC->nb_streams;
+
+    std::string strBlob;
+    Append(strBlob, &objHeader, sizeof(objHeader));
+    Append(strBlob, objFile.Path().data(), objHeader.nPathLength);
+    Append(strBlob, pIC->iformat->name, objHeader.nFormatLength);
+    for (unsigned i = 0; i < pIC->nb_streams; i++)
+    {
+        const AVStream* st = pIC->streams[i];
+        const AVCodecParameters* par = st->codecpar;
+        if (par->ch_layout.order == AV_CHANNEL_ORDER_CUSTOM)
+            return;
+
+        CYStreamInfoEntry objEntry = {};
+        objEntry.nCodecType = par->codec_type;
+        objEntry.nCodecId = par->codec_id;
+        objEntry.nCodecTag = par->codec_tag;
+        objEntry.nFormat = par->format;
+        objEntry.nBitRate = par->bit_rate;
+        objEntry.nBitsPerCodedSample = par->bits_per_coded_sample;
+        objEntry.nBitsPerRawSample = par->bits_per_raw_sample;
+        objEntry.nProfile = par->profile;
+        objEntry.nLevel = par->level;
+        objEntry.nWidth = par->width;
+        objEntry.nHeight = par->height;
+        objEntry.objSampleAspectRatio = par->sample_aspect_ratio;
+        objEntry.objFrameRate = par->framerate;
+        objEntry.nFieldOrder = par->field_order;
+        objEntry.nColorRange = par->color_range;
+        objEntry.nColorPrimaries = par->color_primaries;
+        objEntry.nColorTrc = par->color_trc;
+        objEntry.nColorSpace = par->color_space;
+        objEntry.nChromaLocation = par->chroma_location;
+        objEntry.nVideoDelay = par->video_delay;
+        objEntry.nChannelOrder = par->ch_layout.order;
+        objEntry.nChannels = par->ch_layout.nb_channels;
+        objEntry.nChannelMask = par->ch_layout.u.mask;
+        objEntry.nSampleRate = par->sample_rate;
+        objEntry.nBlockAlign = par->block_align;
+        objEntry.nFrameSize = par->frame_size;
+        objEntry.nInitialPadding = par->initial_padding;
+        objEntry.nTrailingPadding = par->trailing_padding;
+        objEntry.nSeekPreroll = par->seek_preroll;
+        objEntry.nDisposition = st->disposition;
+        objEntry.objTimeBase = st->time_base;
+        objEntry.objAvgFrameRate = st->avg_frame_rate;
+        objEntry.objRealFrameRate = st->r_frame_rate;
+        objEntry.objStreamAspectRatio = st->sample_aspect_ratio;
+        objEntry.nStartTime = st->start_time;
+        objEntry.nDuration = st->duration;
+        objEntry.nFrames = st->nb_frames;
+        objEntry.nExtradataSize = par->extradata ? par->extradata_size : 0;
+        Append(strBlob, &objEntry, sizeof(objEntry));
+        Append(strBlob, par->extradata, objEntry.nExtradataSize);
+    }
+
+    std::string strKey = objFile.CachePath(pszDir ? pszDir : "", STREAM_INFO_EXT);
+    Insert(strKey, strBlob);
+    if (!pszDir || !*pszDir)
+        return;
+
+    std::string strTempPath = strKey + ".tmp";
+    FILE* pFile = CYCacheFile::OpenFile(strTempPath, "wb");
+    bool bOk = pFile && fwrite(strBlob.data(), strBlob.size(), 1, pFile) == 1;
+    bOk = pFile && fclose(pFile) == 0 && bOk;
+    if (!bOk || !CYCacheFile::Rename(strTempPath, strKey))
+    {
+        CYCacheFile::Remove(strTempPath);
+        av_log(nullptr, AV_LOG_WARNING, "Could not write stream info cache %s\n", strKey.c_str());
+    }
+}
+
+void CYStreamInfoCache::Clear()
+{
+    UniqueLock locker(m_mutex);
+    m_mapEntries.clear();
+}
+
+/* the in-memory entry, or the cache file loaded into memory */
+bool CYStreamInfoCache::Find(const std::string& strKey, std::string* pBlob)
+{
+    {
+        UniqueLock locker(m_mutex);
+        auto it = m_mapEntries.find(strKey);
+        if (it != m_mapEntries.end())
+        {
+            *pBlob = it->second;
+            return true;
+        }
+    }
+
+    /* a key without a directory has no file behind it */
+    if (strKey.find_first_of("/\\") == std::string::npos)
+        return false;
+    FILE* pFile = CYCacheFile::OpenFile(strKey, "rb");
+    if (!pFile)
+        return false;
+    char szBuffer[4096];
+    size_t nRead;
+    pBlob->clear();
+    while ((nRead = fread(szBuffer, 1, sizeof(szBuffer), pFile)) > 0 && pBlob->size() < STREAM_INFO_CACHE_MAX_BYTES)
+        pBlob->append(szBuffer, nRead);
+    bool bOk = !ferror(pFile) && pBlob->size() < STREAM_INFO_CACHE_MAX_BYTES;
+    fclose(pFile);
+    if (bOk)
+        Insert(strKey, *pBlob);
+    return bOk;
+}
+
+/* entries are a few hundred bytes plus extradata, when full one is dropped to make room */
+void CYStreamInfoCache::Insert(const std::string& strKey, const std::string& strBlob)
+{
+    UniqueLock locker(m_mutex);
+    if (m_mapEntries.size() >= STREAM_INFO_CACHE_ENTRIES && !m_mapEntries.count(strKey))
+        m_mapEntries.erase(m_mapEntries.begin());
+    m_mapEntries[strKey] = strBlob;
+}
+
+CYPLAYER_NAMESPACE_END
@@ -0,0 +1,97 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_STREAM_INFO_CACHE_HPP__
+#define __CY_STREAM_INFO_CACHE_HPP__
+
+#include "CYPlayerPrivDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/**
+ * Process-wide cache of what avformat_find_stream_info found for a local file.
+ *
+ * The probe decodes frames of every stream, and for some containers reads the end of the
+ * file to estimate the duration, which makes it the bulk of the open time. Store keeps the
+ * codec parameters, stream timing and format duration of a probed file, keyed by path,
+ * size and modification time, in memory and optionally as a file under a cache directory.
+ * Apply writes them back into a context fresh out of avformat_open_input, so the open can
+ * go straight to the stream components.
+ *
+ * Apply only accepts an entry when the demuxer opened the same format with the same
+ * streams, codec ids and time bases; anything else is left to the probe. Files with a
+ * custom channel order are not cached.
+ */
+class CYStreamInfoCache
+{
+public:
+    static CYStreamInfoCache& Instance();
+
+public:
+    /* fill the streams of pIC from the cached probe of pszURL, false on a miss */
+    bool Apply(AVFormatContext* pIC, const char* pszURL, const char* pszDir);
+    /* remember the probe result of pIC, in memory and under pszDir when it is not empty */
+    void Store(const AVFormatContext* pIC, const char* pszURL, const char* pszDir);
+    /* forget the in-memory entries, files under a cache directory stay */
+    void Clear();
+
+private:
+    CYStreamInfoCache();
+    virtual ~CYStreamInfoCache();
+
+    bool Find(const std::string& strKey, std::string* pBlob);
+    void Insert(const std::string& strKey, const std::string& strBlob);
+
+private:
+    std::mutex m_mutex;
+    /* cache file name -> serialized entry */
+    std::unordered_map<std::string, std::string> m_mapEntries;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_STREAM_INFO_CACHE_HPP__
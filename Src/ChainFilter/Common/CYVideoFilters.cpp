@@ -72,7 +72,8 @@ void SetDefaultWindowSize(SharePtr<CYMediaContext>& ptrContext, int nWidth, int
     ptrContext->nDefaultHeight = rect.h;
 }
 
-int ConfigureVideoFilters(AVFilterGraph* graph, SharePtr<CYMediaContext>& ptrContext, const char* vfilters, AVFrame* pFrame)
+int ConfigureVideoFilters(AVFilterGraph* graph, SharePtr<CYMediaContext>& ptrContext, const char* vfilters, AVFrame* pFrame,
+    AVFilterContext** ppSrc, AVFilterContext** ppSink)
 {
     enum AVPixelFormat pix_fmts[FF_ARRAY_ELEMS(sdl_texture_format_map)];
     char sws_flags_str[512] = "";
@@ -219,8 +220,16 @@ int ConfigureVideoFilters(AVFilterGraph* graph, SharePtr<CYMediaContext>& ptrCon
     if ((ret = ConfigureFilterGraph(graph, vfilters, filt_src, last_filter)) < 0)
         goto fail;
 
-    ptrContext->pInVideoFilter = filt_src;
-    ptrContext->pOutVideoFilter = filt_out;
+    if (ppSrc && ppSink)
+    {
+        *ppSrc = filt_src;
+        *ppSink = filt_out;
+    }
+    else
+    {
+        ptrContext->pInVideoFilter = filt_src;
+        ptrContext->pOutVideoFilter = filt_out;
+    }
 
 fail:
     av_freep(&par);
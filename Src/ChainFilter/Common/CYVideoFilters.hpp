@@ -58,7 +58,9 @@ struct TextureFormatEntry
 
 extern struct TextureFormatEntry sdl_texture_format_map[20];
 
-int ConfigureVideoFilters(AVFilterGraph* pGraph, SharePtr<CYMediaContext>& ptrContext, const char* pVFilters, AVFrame* pFrame);
+/* the source and sink end up in pInVideoFilter/pOutVideoFilter, or in ppSrc/ppSink for a graph other than the decoder's */
+int ConfigureVideoFilters(AVFilterGraph* pGraph, SharePtr<CYMediaContext>& ptrContext, const char* pVFilters, AVFrame* pFrame,
+    AVFilterContext** ppSrc = nullptr, AVFilterContext** ppSink = nullptr);
 void SetDefaultWindowSize(SharePtr<CYMediaContext>& ptrContext, int nWidth, int nHeight, AVRational objSar);
 void CalculateDisplayRect(SDL_Rect* pRect, int nScrXleft, int nScrYtop, int nScrWidth, int nScrHeight, int nPicWidth, int nPicHeight, AVRational objPicSar);
 
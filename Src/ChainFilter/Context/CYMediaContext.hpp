@@ -53,8 +53,19 @@
 #include "Common/Thread/CYCondition.hpp"
 #include "Common/Queue/CYFrameQueue.hpp"
 #include "Common/Queue/CYPacketQueue.hpp"
+#include "Common/Memory/CYMemoryBudget.hpp"
+#include "Common/Thread/CYThreadBudget.hpp"
 #include "ChainFilter/Common/CYMediaClock.hpp"
 #include "ChainFilter/Common/CYDecoder.hpp"
+#include "ChainFilter/Common/CYFrameBufferPool.hpp"
+#include "ChainFilter/Common/CYItemTimeline.hpp"
+#include "ChainFilter/Common/CYMappedFileIO.hpp"
+#include "ChainFilter/Common/CYMediaPreloader.hpp"
+#include "ChainFilter/Common/CYQualityGovernor.hpp"
+#include "ChainFilter/Common/CYReadAheadIO.hpp"
+#include "ChainFilter/Common/CYSeekRequest.hpp"
+
+#include <deque>
 
 CYPLAYER_NAMESPACE_BEGIN
 
@@ -67,6 +78,21 @@ enum ShowMode
     SHOW_MODE_NB
 };
 
+enum ScrubMode
+{
+    SCRUB_MODE_NONE = 0,
+    SCRUB_MODE_KEYFRAMES,           // decode keyframes only
+    SCRUB_MODE_KEYFRAMES_FAST,      // keyframes only, without the in-loop deblocking filter
+};
+
+enum TrickMode
+{
+    TRICK_MODE_NONE = 0,            // every video packet decoded
+    TRICK_MODE_NONREF,              // non-reference video packets dropped before decoding
+    TRICK_MODE_KEYFRAMES,           // keyframes only, read from keyframe to keyframe
+    TRICK_MODE_REVERSE,             // backwards, pictures come from CYReversePlayback instead of the decoder
+};
+
 class CYMediaContext
 {
 public:
@@ -74,6 +100,11 @@ public:
     virtual ~CYMediaContext();
 
 public:
+    /* declared first so every queue and charge below is released before it goes away */
+    CYMemoryAccount objMemAccount;
+    /* codec threads of the video decoder under the process thread budget */
+    CYThreadLease objThreadLease;
+
     const AVInputFormat* iformat = nullptr;
 
     std::mutex AbortMutex;
@@ -82,12 +113,34 @@ public:
     bool bPaused = false;
     int nLastPaused = 0;
     int nQueueAttachmentsReq = 0;
-    bool bSeekReq = false;
+    /* latest requested seek, and the one the demux thread is executing below */
+    CYSeekRequest objSeekReq;
+    std::atomic_bool bSeeking{ false };
+    std::atomic<int> nScrubMode{ SCRUB_MODE_NONE };
+    /* SetSpeed: the rate the clocks run at, and what is decoded to keep up with it */
+    std::atomic<double> fPlaybackSpeed{ 1.0 };
+    std::atomic<int> nTrickMode{ TRICK_MODE_NONE };
+    /* StepBack requests not taken by the demux thread yet, and whether CYReversePlayback feeds pictq */
+    std::atomic<int> nStepBackReq{ 0 };
+    std::atomic_bool bReversing{ false };
+    /* held by whoever writes pictq: the video decoder, or reverse playback while bReversing */
+    std::mutex mutexPictWriter;
     bool bAccurate = false;
     int nSeekFlags = 0;
     int64_t nSeekPos = 0;
     int64_t nSeekRel = 0;
     int nReadPauseReturn = 0;
+    /* gapless playlist: URLs still to play, and whether ClearPlaylist asked to drop a preload */
+    std::mutex mutexPlaylist;
+    std::deque<std::string> deqPlaylist;
+    std::atomic_bool bPlaylistCleared{ false };
+    /* the playlist item being read, and earlier ones whose streams the decoders may still use;
+       declared before the I/O so they outlive it */
+    SharePtr<CYMediaItem> ptrPlaylistItem;
+    std::vector<SharePtr<CYMediaItem>> vecRetiredItems;
+    /* declared before ptrIC so the custom I/O outlives the format context reading it */
+    SharePtr<CYMappedFileIO> ptrMappedIO;
+    SharePtr<CYReadAheadIO> ptrReadAheadIO;
     AVFormatContextPtr ptrIC;
 
     bool bRealTime = false;
@@ -125,17 +178,26 @@ public:
     unsigned int nAudioBuf1Size = 0;
     int nAudioBufIndex = 0; /* in bytes */
     int nAudioWriteBufSize = 0;
+    CYMemoryCharge objAudioBufMem{ &objMemAccount, TYPE_MEMORY_AUDIO };
     int nAudioVolume = 100;
     bool bMuted = false;
     struct CYAudioParams objAudioSrc = {};
     struct CYAudioParams objAudioFilterSrc = {};
     struct CYAudioParams objAudioTgt = {};
     SwrContextPtr ptrSwrCtx;
+    /* video drops by reason: packets skipped before decoding, decoded pictures already late,
+       pictures late at display */
+    int nPacketDropsLate = 0;
     int nFrameDropsEarly = 0;
     int nFrameDropsLate = 0;
+    CYQualityGovernor objQualityGovernor;
 
     enum ShowMode eShowMode = SHOW_MODE_NONE;
-    int16_t arraySample[SAMPLE_ARRAY_SIZE] = { 0 };
+    /* SAMPLE_ARRAY_SIZE samples, allocated by the renderer the first time it draws waves/RDFT;
+     * the audio callback only feeds it while bAudioDisplay is set */
+    AVFreePtr<int16_t> ptrSampleArray;
+    std::atomic_bool bAudioDisplay{ false };
+    CYMemoryCharge objSampleArrayMem{ &objMemAccount, TYPE_MEMORY_AUDIO };
     int nSampleArrayIndex = 0;
     int nLastIStart = 0;
     AVTXContext* pRdftContext = nullptr;
@@ -148,6 +210,9 @@ public:
     SDL_Texture* vis_texture = nullptr;
     SDL_Texture* sub_texture = nullptr;
     SDL_Texture* vid_texture = nullptr;
+    CYMemoryCharge objVisTextureMem{ &objMemAccount, TYPE_MEMORY_TEXTURES };
+    CYMemoryCharge objSubTextureMem{ &objMemAccount, TYPE_MEMORY_TEXTURES };
+    CYMemoryCharge objVidTextureMem{ &objMemAccount, TYPE_MEMORY_TEXTURES };
 
     int nSubtitleStreamIndex = 0;
     AVStream* pSubTitleStream = nullptr;
@@ -219,6 +284,23 @@ public:
     char szForceSubtitleCodecName[256] = { 0 };
     char szForceVideoCodecName[256] = { 0 };
     char szHWAccel[256] = { 0 };
+    int nVideoQueueDepth = VIDEO_PICTURE_QUEUE_SIZE;
+    int nAudioQueueDepth = SAMPLE_QUEUE_SIZE;
+    int nSubtitleQueueDepth = SUBPICTURE_QUEUE_SIZE;
+    bool bAdaptiveVideoQueue = false;
+    int nVideoQueueMinDepth = 2;
+    int nVideoQueueMaxDepth = 16;
+    bool bFrameBufferPool = true;
+    bool bHugePageFrames = false;
+    bool bMappedFileIO = false;
+    int64_t nReadAheadSize = 0;
+    bool bKeyframeIndex = false;
+    bool bStreamInfoCache = false;
+    char szCacheDir[256] = { 0 };
+    int nDecodePriority = 1;
+    bool bAdaptiveQuality = false;
+    int64_t nReverseCacheSize = REVERSE_GOP_CACHE_SIZE;
+    SharePtr<CYFrameBufferPool> ptrFramePool;
 
     int nSampleRate = 0;
     int64_t nAudioCallbackTime = 0;
@@ -233,7 +315,8 @@ public:
     int nDefaultWidth = 640;
     int nDefaultHeight = 480;
 
-    int64_t nFileDuration = 0;
+    /* the playlist items and loop rounds from the one on screen to the one being read */
+    CYItemTimeline objTimeline;
     FunEventCallback funEventCallBack = nullptr;
     FunStateCallBack funStateCallBack = nullptr;
     FunPositionCallBack funPositionCallBack = nullptr;
@@ -1,5 +1,6 @@
 #include "ChainFilter/DecodeFilter/CYAudioDecodeFilter.hpp"
 #include "ChainFilter/Common/CYAudioFilters.hpp"
+#include "ChainFilter/Common/CYFilterGraph.hpp"
 
 CYPLAYER_NAMESPACE_BEGIN
 
@@ -78,6 +79,8 @@ void CYAudioDecodeFilter::OnEntry()
     CYFrame* af = nullptr;
     int last_serial = -1;
     int reconfigure;
+    bool bKeepGraph = false;
+    double fTempo = 1.0;
     int got_frame = 0;
     AVRational tb;
     int ret = 0;
@@ -93,12 +96,24 @@ void CYAudioDecodeFilter::OnEntry()
         if ((got_frame = m_ptrContext->auddec.DecodeFrame(pFrame, nullptr, m_ptrContext->nDecoderReorderPTS)) < 0)
             goto the_end;
 
-        if (got_frame)
+        /* before the target of an accurate seek, or the seek was replaced by a newer one */
+        if (got_frame && pFrame->pts != AV_NOPTS_VALUE &&
+            m_ptrContext->objSeekReq.SkipFrame(true, m_ptrContext->auddec.m_nPktSerial,
+                av_rescale_q(pFrame->pts + pFrame->nb_samples, { 1, pFrame->sample_rate }, AV_TIME_BASE_Q)))
+        {
+            av_frame_unref(pFrame);
+        }
+        else if (got_frame)
         {
             tb = { 1, pFrame->sample_rate };
 
+            /* a seek only changes the serial: a graph without state is kept */
+            if (bKeepGraph && m_ptrContext->auddec.m_nPktSerial != last_serial)
+                last_serial = m_ptrContext->auddec.m_nPktSerial;
+
             reconfigure = CmpAudioFmts(m_ptrContext->objAudioFilterSrc.fmt, m_ptrContext->objAudioFilterSrc.ch_layout.nb_channels, (AVSampleFormat)pFrame->format, pFrame->ch_layout.nb_channels) ||
-                av_channel_layout_compare(&m_ptrContext->objAudioFilterSrc.ch_layout, &pFrame->ch_layout) || m_ptrContext->objAudioFilterSrc.freq != pFrame->sample_rate || m_ptrContext->auddec.m_nPktSerial != last_serial;
+                av_channel_layout_compare(&m_ptrContext->objAudioFilterSrc.ch_layout, &pFrame->ch_layout) || m_ptrContext->objAudioFilterSrc.freq != pFrame->sample_rate || m_ptrContext->auddec.m_nPktSerial != last_serial ||
+                AudioTempo(m_ptrContext) != fTempo;
 
             if (reconfigure)
             {
@@ -115,9 +130,11 @@ void CYAudioDecodeFilter::OnEntry()
                     goto the_end;
                 m_ptrContext->objAudioFilterSrc.freq = pFrame->sample_rate;
                 last_serial = m_ptrContext->auddec.m_nPktSerial;
+                fTempo = AudioTempo(m_ptrContext);
 
                 if ((ret = ConfigureAudioFilters(m_ptrContext, m_ptrContext->pAFilters, 1)) < 0)
                     goto the_end;
+                bKeepGraph = FilterGraphIsStateless(m_ptrContext->ptrAgraph.get());
             }
 
             if ((ret = av_buffersrc_add_frame(m_ptrContext->pInAudioFilter, pFrame)) < 0)
@@ -139,7 +156,12 @@ void CYAudioDecodeFilter::OnEntry()
                 m_ptrContext->sampq.Push();
 
                 if (m_ptrContext->ptrAudioQueue->serial != m_ptrContext->auddec.m_nPktSerial)
+                {
+                    /* the rest of this output is stale, the graph itself may be kept for the next serial */
+                    while (av_buffersink_get_frame_flags(m_ptrContext->pOutAudioFilter, pFrame, 0) >= 0)
+                        av_frame_unref(pFrame);
                     break;
+                }
             }
             if (ret == AVERROR_EOF)
                 m_ptrContext->auddec.m_nFinished = m_ptrContext->auddec.m_nPktSerial;
@@ -154,30 +176,10 @@ the_end:
     return;
 }
 
-/* return the number of undisplayed frames in the queue */
-int FrameQueueNbRemaining(CYFrameQueue* f)
-{
-    return f->size - f->rindex_shown;
-}
-
-CYFrame* FrameQueuePeekReadable(CYFrameQueue* f)
-{
-    /* wait until we have a readable a new frame */
-    UniqueLock locker(f->m_mutex);
-    while (f->size - f->rindex_shown <= 0 &&
-        !f->ptrQueue->bAbortRequest)
-    {
-        f->m_cvCond.wait(locker);
-    }
-
-    if (f->ptrQueue->bAbortRequest)
-        return NULL;
-
-    return &f->m_lstQueue[(f->rindex + f->rindex_shown) % f->max_size];
-}
-
 static int GetMasterSyncType(SharePtr<CYMediaContext>& ptrContext)
 {
+    if (ptrContext->fPlaybackSpeed != 1.0)
+        return TYPE_SYNC_CLOCK_EXTERNAL;
     if (ptrContext->nAVSyncType == TYPE_SYNC_CLOCK_VIDEO)
     {
         if (ptrContext->pVideoStream)
@@ -287,14 +289,14 @@ int AudioDecodeFrame(SharePtr<CYMediaContext>& ptrContext)
     do
     {
 #if defined(_WIN32)
-        while (FrameQueueNbRemaining(&ptrContext->sampq) == 0)
+        while (ptrContext->sampq.NbRemaining() == 0)
         {
             if ((av_gettime_relative() - ptrContext->nAudioCallbackTime) > 1000000LL * ptrContext->nAudioHWBufSize / ptrContext->objAudioTgt.bytes_per_sec / 2)
                 return -1;
             av_usleep(1000);
         }
 #endif
-        if (!(af = FrameQueuePeekReadable(&ptrContext->sampq)))
+        if (!(af = ptrContext->sampq.PeekReadable()))
             return -1;
 
         //frame_queue_next(&ptrContext->sampq);
@@ -378,6 +380,7 @@ int AudioDecodeFrame(SharePtr<CYMediaContext>& ptrContext)
             return AVERROR(ENOMEM);
 
         ptrContext->ptrAudioBuffer1.reset(audio_buf1);
+        ptrContext->objAudioBufMem.Set(ptrContext->nAudioBuf1Size);
         len2 = swr_convert(ptrContext->ptrSwrCtx.get(), out, out_count, in, af->pFrame->nb_samples);
         if (len2 < 0)
         {
@@ -403,7 +406,7 @@ int AudioDecodeFrame(SharePtr<CYMediaContext>& ptrContext)
     audio_clock0 = ptrContext->fAudioClock;
     /* update the audio clock with the pts */
     if (!isnan(af->pts))
-        ptrContext->fAudioClock = af->pts + (double)af->pFrame->nb_samples / af->pFrame->sample_rate;
+        ptrContext->fAudioClock = af->pts + (double)af->pFrame->nb_samples / af->pFrame->sample_rate * AudioTempo(ptrContext);
     else
         ptrContext->fAudioClock = NAN;
     ptrContext->nAudioClockSerial = af->serial;
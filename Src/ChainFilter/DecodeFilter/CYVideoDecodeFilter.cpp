@@ -1,8 +1,122 @@
 #include "ChainFilter/DecodeFilter/CYVideoDecodeFilter.hpp"
+#include "ChainFilter/Common/CYFilterGraph.hpp"
 #include "ChainFilter/Common/CYVideoFilters.hpp"
 
 CYPLAYER_NAMESPACE_BEGIN
 
+double GetMasterClock(SharePtr<CYMediaContext>& ptrContext);
+
+/* -1 for a NAL unit that is not a slice, otherwise whether its picture is not used for reference;
+ * nMaxTemporalId is the highest HEVC sub-layer, -1 when unknown */
+static int NalDisposable(AVCodecID eCodecId, const uint8_t* pNal, int64_t nSize, int nMaxTemporalId)
+{
+    if (nSize < 1)
+        return -1;
+
+    if (eCodecId == AV_CODEC_ID_H264)
+    {
+        int nType = pNal[0] & 0x1f;
+        if (nType < 1 || nType > 5)
+            return -1;
+        return !(pNal[0] & 0x60);
+    }
+
+    /* HEVC: VCL types below 16 with an even number are sub-layer non-reference pictures, which pictures
+       of higher sub-layers may still reference: only those of the highest sub-layer are disposable */
+    int nType = (pNal[0] >> 1) & 0x3f;
+    if (nType > 31)
+        return -1;
+    if (nSize < 2 || nMaxTemporalId < 0)
+        return 0;
+    int nTemporalId = (pNal[1] & 7) - 1;
+    return nType < 16 && !(nType & 1) && nTemporalId == nMaxTemporalId;
+}
+
+/* sps_max_sub_layers_minus1 of the first HEVC SPS in the extradata, hvcC or with start codes; -1 without one */
+static int HevcMaxTemporalId(const AVCodecContext* pAVCtx)
+{
+    const uint8_t* p = pAVCtx->extradata;
+    const uint8_t* pEnd = pAVCtx->extradata + pAVCtx->extradata_size;
+    if (!p || pAVCtx->extradata_size < 4)
+        return -1;
+
+    if (p[0] == 1)
+    {
+        /* hvcC: 22 bytes of configuration, then arrays of NAL units of one type, each length prefixed */
+        if (pEnd - p < 23)
+            return -1;
+        int nArrays = p[22];
+        p += 23;
+        for (int i = 0; i < nArrays && pEnd - p >= 3; i++)
+        {
+            int nType = p[0] & 0x3f;
+            int nNalus = (p[1] << 8) | p[2];
+            p += 3;
+            for (int j = 0; j < nNalus && pEnd - p >= 2; j++)
+            {
+                int nLength = (p[0] << 8) | p[1];
+                p += 2;
+                if (nLength > pEnd - p)
+                    return -1;
+                if (nType == 33 && nLength >= 3) /* SPS */
+                    return (p[2] >> 1) & 7;
+                p += nLength;
+            }
+        }
+        return -1;
+    }
+
+    for (; pEnd - p > 5; p++)
+    {
+        if (!p[0] && !p[1] && p[2] == 1 && ((p[3] >> 1) & 0x3f) == 33) /* SPS */
+            return (p[5] >> 1) & 7;
+    }
+    return -1;
+}
+
+/* whether no other picture references the one in pPkt: flagged by the demuxer, or for H.264/HEVC
+ * read from its first slice, length prefixed (avcC/hvcC extradata) or with start codes */
+static bool PacketIsDisposable(const AVPacket* pPkt, const AVCodecContext* pAVCtx, int nMaxTemporalId)
+{
+    if (pPkt->flags & AV_PKT_FLAG_DISPOSABLE)
+        return true;
+    if ((pPkt->flags & AV_PKT_FLAG_KEY) || (pAVCtx->codec_id != AV_CODEC_ID_H264 && pAVCtx->codec_id != AV_CODEC_ID_HEVC))
+        return false;
+
+    const uint8_t* p = pPkt->data;
+    const uint8_t* pEnd = pPkt->data + pPkt->size;
+    if (pAVCtx->extradata_size > 0 && pAVCtx->extradata[0] == 1)
+    {
+        int nLengthOffset = pAVCtx->codec_id == AV_CODEC_ID_H264 ? 4 : 21;
+        int nLengthSize = pAVCtx->extradata_size > nLengthOffset ? (pAVCtx->extradata[nLengthOffset] & 3) + 1 : 4;
+        while (pEnd - p > nLengthSize)
+        {
+            uint32_t nLength = 0;
+            for (int i = 0; i < nLengthSize; i++)
+                nLength = (nLength << 8) | p[i];
+            p += nLengthSize;
+            if (nLength > (uint32_t)(pEnd - p))
+                return false;
+            int nRet = NalDisposable(pAVCtx->codec_id, p, nLength, nMaxTemporalId);
+            if (nRet >= 0)
+                return nRet;
+            p += nLength;
+        }
+        return false;
+    }
+
+    for (; pEnd - p > 3; p++)
+    {
+        if (p[0] || p[1] || p[2] != 1)
+            continue;
+        int nRet = NalDisposable(pAVCtx->codec_id, p + 3, pEnd - p - 3, nMaxTemporalId);
+        if (nRet >= 0)
+            return nRet;
+        p += 2;
+    }
+    return false;
+}
+
 CYVideoDecodeFilter::CYVideoDecodeFilter()
     : CYBaseFilter()
 {
@@ -62,6 +176,8 @@ int16_t CYVideoDecodeFilter::ProcessFrame(SharePtr<CYMediaContext>& ptrContext,
 
 int CYVideoDecodeFilter::GetMasterSyncType(SharePtr<CYMediaContext>& ptrContext)
 {
+    if (ptrContext->fPlaybackSpeed != 1.0)
+        return TYPE_SYNC_CLOCK_EXTERNAL;
     if (ptrContext->nAVSyncType == TYPE_SYNC_CLOCK_VIDEO)
     {
         if (ptrContext->pVideoStream)
@@ -82,13 +198,71 @@ int CYVideoDecodeFilter::GetMasterSyncType(SharePtr<CYMediaContext>& ptrContext)
     }
 }
 
+/* set what the codec skips from the keyframe-only preview of a scrub or of fast trick play and the
+ * quality level of the load governor, on top of the settings the codec was opened with */
+void CYVideoDecodeFilter::ApplyDecodeSettings()
+{
+    AVCodecContext* pAVCtx = m_ptrContext->viddec.GetCodecContent();
+    int nMode = m_ptrContext->nScrubMode;
+    int nTrickMode = m_ptrContext->nTrickMode;
+    int nLevel = m_ptrContext->objQualityGovernor.Level();
+    if (pAVCtx == m_pTunedCtx && nMode == m_nScrubMode && nTrickMode == m_nTrickMode && nLevel == m_nQualityLevel)
+        return;
+
+    /* a playlist item brings a new codec context */
+    if (pAVCtx != m_pTunedCtx)
+    {
+        m_eSkipFrame = pAVCtx->skip_frame;
+        m_eSkipLoopFilter = pAVCtx->skip_loop_filter;
+        m_eSkipIdct = pAVCtx->skip_idct;
+        m_nFlags2 = pAVCtx->flags2;
+        m_pTunedCtx = pAVCtx;
+    }
+
+    int eSkipFrame = m_eSkipFrame, eSkipLoopFilter = m_eSkipLoopFilter, eSkipIdct = m_eSkipIdct;
+    int nFlags2 = m_nFlags2;
+    if (nLevel >= TYPE_DECODE_QUALITY_FAST)
+    {
+        nFlags2 |= AV_CODEC_FLAG2_FAST;
+        eSkipLoopFilter = FFMAX(eSkipLoopFilter, AVDISCARD_NONREF);
+    }
+    if (nLevel >= TYPE_DECODE_QUALITY_NO_DEBLOCK)
+        eSkipLoopFilter = AVDISCARD_ALL;
+    if (nLevel >= TYPE_DECODE_QUALITY_NO_IDCT)
+        eSkipIdct = FFMAX(eSkipIdct, AVDISCARD_NONREF);
+    if (nLevel >= TYPE_DECODE_QUALITY_NO_NONREF)
+        eSkipFrame = FFMAX(eSkipFrame, AVDISCARD_NONREF);
+    if (nMode != SCRUB_MODE_NONE || nTrickMode == TRICK_MODE_KEYFRAMES)
+        eSkipFrame = AVDISCARD_NONKEY;
+    if (nMode == SCRUB_MODE_KEYFRAMES_FAST)
+        eSkipLoopFilter = AVDISCARD_ALL;
+
+    pAVCtx->skip_frame = (AVDiscard)eSkipFrame;
+    pAVCtx->skip_loop_filter = (AVDiscard)eSkipLoopFilter;
+    pAVCtx->skip_idct = (AVDiscard)eSkipIdct;
+    pAVCtx->flags2 = nFlags2;
+    m_nScrubMode = nMode;
+    m_nTrickMode = nTrickMode;
+    m_nQualityLevel = nLevel;
+}
+
 int CYVideoDecodeFilter::GetVideoFrame(AVFrame* pFrame)
 {
     int got_picture;
 
+    ApplyDecodeSettings();
+
+    /* only time decodes that had packets waiting, not waits for the demuxer, and not keyframe previews */
+    bool bBacklog = m_ptrContext->nScrubMode == SCRUB_MODE_NONE && m_ptrContext->nTrickMode != TRICK_MODE_KEYFRAMES &&
+        m_ptrContext->ptrVideoQueue->NbPackets() > 0;
+    int64_t nDecodeStart = av_gettime_relative();
+
     if ((got_picture = m_ptrContext->viddec.DecodeFrame(pFrame, nullptr, m_ptrContext->nDecoderReorderPTS)) < 0)
         return -1;
 
+    if (got_picture && bBacklog)
+        m_ptrContext->objQualityGovernor.ReportDecodeTime((av_gettime_relative() - nDecodeStart) / 1000000.0, m_fFrameDuration / m_ptrContext->fPlaybackSpeed);
+
     if (got_picture)
     {
         double dpts = NAN;
@@ -98,17 +272,27 @@ int CYVideoDecodeFilter::GetVideoFrame(AVFrame* pFrame)
 
         pFrame->sample_aspect_ratio = av_guess_sample_aspect_ratio(m_ptrContext->ptrIC.get(), m_ptrContext->pVideoStream, pFrame);
 
+        /* before the target of an accurate seek, or the seek was replaced by a newer one */
+        if (pFrame->pts != AV_NOPTS_VALUE &&
+            m_ptrContext->objSeekReq.SkipFrame(false, m_ptrContext->viddec.m_nPktSerial,
+                av_rescale_q(pFrame->pts + FFMAX(pFrame->duration, 1), m_ptrContext->pVideoStream->time_base, AV_TIME_BASE_Q)))
+        {
+            av_frame_unref(pFrame);
+            return 0;
+        }
+
         if (m_ptrParam->nFrameDrop > 0 || (m_ptrParam->nFrameDrop && GetMasterSyncType(m_ptrContext) != TYPE_SYNC_CLOCK_VIDEO))
         {
             if (pFrame->pts != AV_NOPTS_VALUE)
             {
-                double fDiff = dpts - GetMasterSyncType(m_ptrContext);
+                double fDiff = dpts - GetMasterClock(m_ptrContext);
                 if (!isnan(fDiff) && fabs(fDiff) < AV_NOSYNC_THRESHOLD &&
                     fDiff - m_ptrContext->fFrameLastFilterDelay < 0 &&
                     m_ptrContext->viddec.m_nPktSerial == m_ptrContext->vidclk.m_fSerial &&
-                    m_ptrContext->ptrVideoQueue->nb_packets)
+                    m_ptrContext->ptrVideoQueue->NbPackets())
                 {
                     m_ptrContext->nFrameDropsEarly++;
+                    m_ptrContext->objQualityGovernor.ReportDrop();
                     av_frame_unref(pFrame);
                     got_picture = 0;
                 }
@@ -119,6 +303,48 @@ int CYVideoDecodeFilter::GetVideoFrame(AVFrame* pFrame)
     return got_picture;
 }
 
+/* decode thread: skip a packet nothing references once its picture is behind the master clock by more
+ * than EARLY_PACKET_DROP_THRESHOLD, under the same conditions as dropping a decoded picture */
+bool CYVideoDecodeFilter::DropLatePacket(const AVPacket* pPkt, double fPts)
+{
+    if (!(m_ptrParam->nFrameDrop > 0 || (m_ptrParam->nFrameDrop && GetMasterSyncType(m_ptrContext) != TYPE_SYNC_CLOCK_VIDEO)))
+        return false;
+    if (m_ptrContext->nScrubMode != SCRUB_MODE_NONE || m_ptrContext->viddec.m_nPktSerial != m_ptrContext->vidclk.m_fSerial)
+        return false;
+
+    double fDiff = fPts - GetMasterClock(m_ptrContext);
+    if (isnan(fDiff) || fabs(fDiff) >= AV_NOSYNC_THRESHOLD || fDiff > -EARLY_PACKET_DROP_THRESHOLD)
+        return false;
+    if (!IsDisposable(pPkt))
+        return false;
+
+    m_ptrContext->nPacketDropsLate++;
+    m_ptrContext->objQualityGovernor.ReportDrop();
+    return true;
+}
+
+/* decode thread: from TRICK_PLAY_NONREF_SPEED on, packets nothing references are not decoded at all */
+bool CYVideoDecodeFilter::DropTrickPacket(const AVPacket* pPkt)
+{
+    if (m_ptrContext->nTrickMode != TRICK_MODE_NONREF || m_ptrContext->nScrubMode != SCRUB_MODE_NONE)
+        return false;
+    return IsDisposable(pPkt);
+}
+
+/* decode thread: PacketIsDisposable with the HEVC sub-layers of the codec in use */
+bool CYVideoDecodeFilter::IsDisposable(const AVPacket* pPkt)
+{
+    AVCodecContext* pAVCtx = m_ptrContext->viddec.GetCodecContent();
+    int nItem = m_ptrContext->viddec.GetItem();
+    if (pAVCtx != m_pDisposableCtx || nItem != m_nDisposableItem)
+    {
+        m_pDisposableCtx = pAVCtx;
+        m_nDisposableItem = nItem;
+        m_nMaxTemporalId = pAVCtx->codec_id == AV_CODEC_ID_HEVC ? HevcMaxTemporalId(pAVCtx) : -1;
+    }
+    return PacketIsDisposable(pPkt, pAVCtx, m_nMaxTemporalId);
+}
+
 int CYVideoDecodeFilter::QueuePicture(AVFrame* pSrcFrame, double pts, double duration, int64_t pos, int serial)
 {
     CYFrame* vp;
@@ -128,8 +354,25 @@ int CYVideoDecodeFilter::QueuePicture(AVFrame* pSrcFrame, double pts, double dur
         av_get_picture_type_char(pSrcFrame->pict_type), pts);
 #endif
 
-    if (!(vp = m_ptrContext->pictq.PeekWritable()))
-        return -1;
+    int64_t nNow = av_gettime_relative();
+    if (m_nLastQueueSerial == serial)
+        m_ptrContext->pictq.ReportProduceTime((nNow - m_nLastQueueTime) / 1000000.0, duration);
+
+    /* over budget even with minimal read-ahead: hold only the shown frame and the next one */
+    m_ptrContext->pictq.LimitDepth(m_ptrContext->objMemAccount.Pressure() >= TYPE_MEMORY_PRESSURE_FRAMES ? 2 : 0);
+
+    /* wait without the lock, reverse playback may start meanwhile and write the queue itself */
+    UniqueLock locker(m_ptrContext->mutexPictWriter, std::defer_lock);
+    do
+    {
+        if (locker.owns_lock())
+            locker.unlock();
+        if (!m_ptrContext->pictq.PeekWritable())
+            return -1;
+        locker.lock();
+        if (m_ptrContext->bReversing)
+            return 0;
+    } while (!(vp = m_ptrContext->pictq.TryPeekWritable()));
 
     vp->sar = pSrcFrame->sample_aspect_ratio;
     vp->uploaded = 0;
@@ -147,6 +390,9 @@ int CYVideoDecodeFilter::QueuePicture(AVFrame* pSrcFrame, double pts, double dur
 
     av_frame_move_ref(vp->pFrame, pSrcFrame);
     m_ptrContext->pictq.Push();
+
+    m_nLastQueueTime = av_gettime_relative();
+    m_nLastQueueSerial = serial;
     return 0;
 }
 
@@ -156,12 +402,16 @@ void CYVideoDecodeFilter::OnEntry()
 
     if (m_bStop) return;
 
+    m_ptrContext->viddec.SetPacketDropper([this](const AVPacket* pPkt, double fPts) { return DropTrickPacket(pPkt) || DropLatePacket(pPkt, fPts); });
+
     AVFrame* pFrame = av_frame_alloc();
     double pts = 0;
     double duration = 0;
     int ret = 0;
     AVRational tb = m_ptrContext->pVideoStream->time_base;
     AVRational frame_rate = av_guess_frame_rate(m_ptrContext->ptrIC.get(), m_ptrContext->pVideoStream, nullptr);
+    m_fFrameDuration = frame_rate.num && frame_rate.den ? av_q2d(AVRational{ frame_rate.den, frame_rate.num }) : 0;
+    m_pTunedCtx = nullptr;
 
     AVFilterGraph* graph = nullptr;
     AVFilterContext* filt_out = nullptr, * filt_in = nullptr;
@@ -170,6 +420,8 @@ void CYVideoDecodeFilter::OnEntry()
     enum AVPixelFormat last_format = (AVPixelFormat)-2;
     int last_serial = -1;
     int last_vfilter_idx = 0;
+    AVStream* last_stream = nullptr;
+    bool bKeepGraph = false;
 
     if (!pFrame)
     {
@@ -186,11 +438,16 @@ void CYVideoDecodeFilter::OnEntry()
         if (!ret)
             continue;
 
+        /* a seek only changes the serial: a graph without state is kept, rebuilding it costs a frame time at 1080p */
+        if (bKeepGraph && last_serial != m_ptrContext->viddec.m_nPktSerial)
+            last_serial = m_ptrContext->viddec.m_nPktSerial;
+
         if (last_w != pFrame->width
             || last_h != pFrame->height
             || last_format != pFrame->format
             || last_serial != m_ptrContext->viddec.m_nPktSerial
-            || last_vfilter_idx != m_ptrContext->nVFilterIndex)
+            || last_vfilter_idx != m_ptrContext->nVFilterIndex
+            || last_stream != m_ptrContext->pVideoStream)    /* a playlist item brings its own time base, a loop does not */
         {
             av_log(nullptr, AV_LOG_DEBUG,
                 "Video frame changed from size:%dx%d format:%s serial:%d to size:%dx%d format:%s serial:%d\n",
@@ -221,7 +478,9 @@ void CYVideoDecodeFilter::OnEntry()
             last_format = (AVPixelFormat)pFrame->format;
             last_serial = m_ptrContext->viddec.m_nPktSerial;
             last_vfilter_idx = m_ptrContext->nVFilterIndex;
+            last_stream = m_ptrContext->pVideoStream;
             frame_rate = av_buffersink_get_frame_rate(filt_out);
+            bKeepGraph = FilterGraphIsStateless(graph);
         }
 
         ret = av_buffersrc_add_frame(filt_in, pFrame);
@@ -257,7 +516,12 @@ void CYVideoDecodeFilter::OnEntry()
             ret = QueuePicture(pFrame, pts, duration, fd ? fd->pkt_pos : -1, m_ptrContext->viddec.m_nPktSerial);
             av_frame_unref(pFrame);
             if (m_ptrContext->ptrVideoQueue->serial != m_ptrContext->viddec.m_nPktSerial)
+            {
+                /* the rest of this output is stale, the graph itself may be kept for the next serial */
+                while (av_buffersink_get_frame_flags(filt_out, pFrame, 0) >= 0)
+                    av_frame_unref(pFrame);
                 break;
+            }
         }
 
         if (ret < 0)
@@ -69,14 +69,38 @@ public:
 private:
     void OnEntry();
     int GetVideoFrame(AVFrame* frame);
+    bool DropLatePacket(const AVPacket* pPkt, double fPts);
+    bool DropTrickPacket(const AVPacket* pPkt);
+    bool IsDisposable(const AVPacket* pPkt);
     int QueuePicture(AVFrame* pSrcFrame, double pts, double duration, int64_t pos, int serial);
     int GetMasterSyncType(SharePtr<CYMediaContext>& ptrContext);
+    void ApplyDecodeSettings();
 
 private:
     std::atomic_bool m_bStop = false;
     std::thread m_thread;
     SharePtr<EPlayerParam> m_ptrParam;
     SharePtr<CYMediaContext> m_ptrContext;
+
+    /* end of the previous QueuePicture, to time how long the next picture took to produce */
+    int64_t m_nLastQueueTime = 0;
+    int m_nLastQueueSerial = -1;
+
+    /* scrub mode, trick mode and quality level m_pTunedCtx is set up for, and the settings it was opened with */
+    AVCodecContext* m_pTunedCtx = nullptr;
+    int m_nScrubMode = SCRUB_MODE_NONE;
+    int m_nTrickMode = TRICK_MODE_NONE;
+    int m_nQualityLevel = TYPE_DECODE_QUALITY_FULL;
+    AVDiscard m_eSkipFrame = AVDISCARD_DEFAULT;
+    AVDiscard m_eSkipLoopFilter = AVDISCARD_DEFAULT;
+    AVDiscard m_eSkipIdct = AVDISCARD_DEFAULT;
+    int m_nFlags2 = 0;
+    /* nominal picture duration of the stream, in seconds, 0 when unknown */
+    double m_fFrameDuration = 0;
+    /* the codec and item the HEVC sub-layer count was read for, and its highest TemporalId, -1 when unknown */
+    const AVCodecContext* m_pDisposableCtx = nullptr;
+    int m_nDisposableItem = -1;
+    int m_nMaxTemporalId = -1;
 };
 
 CYPLAYER_NAMESPACE_END
@@ -3,8 +3,13 @@
 #include "ChainFilter/Common/CYAudioFilters.hpp"
 #include "ChainFilter/Common/CYVideoFilters.hpp"
 #include "ChainFilter/Common/CYHWAccel.hpp"
+#include "ChainFilter/Common/CYKeyframeIndex.hpp"
+#include "ChainFilter/Common/CYStreamInfoCache.hpp"
 #include "ChainFilter/Common/CYDecoder.hpp"
 #include "Common/CYFFmpegDefine.hpp"
+#include "Common/Thread/CYThreadBudget.hpp"
+
+#include <algorithm>
 
 #if __cplusplus
 extern "C" {
@@ -51,6 +56,8 @@ int16_t CYDemuxFilter::Start(SharePtr<CYMediaContext>& ptrContext)
 int16_t CYDemuxFilter::Stop(SharePtr<CYMediaContext>& ptrContext)
 {
     m_bRunning = false;
+    if (m_ptrContext && m_ptrContext->ptrReadCond)
+        m_ptrContext->ptrReadCond->NotifyOne();
     if (m_thread.joinable())
         m_thread.join();
 
@@ -80,7 +87,8 @@ int16_t CYDemuxFilter::ProcessFrame(SharePtr<CYMediaContext>& ptrContext, AVFram
 int DecodeInterruptCallBack(void* ctx)
 {
     CYMediaContext* pContext = (CYMediaContext*)ctx;
-    return pContext->bAbortRequest;
+    /* a seek in progress is abandoned as soon as a newer target is posted */
+    return pContext->bAbortRequest || (pContext->bSeeking && pContext->objSeekReq.Pending());
 }
 
 int CYDemuxFilter::IsRealtime(AVFormatContext* s)
@@ -114,6 +122,16 @@ void CYDemuxFilter::OnEntry()
 
     memset(st_index, -1, sizeof(st_index));
     m_ptrContext->bEof = false;
+    m_nItem = 0;
+    m_nItemOffset = 0;
+    m_nItemEnd = AV_NOPTS_VALUE;
+    m_bLoopSeekFailed = false;
+    m_fTrickSpeed = 1.0;
+    m_nTrickMode = TRICK_MODE_NONE;
+    m_pTrickIC = nullptr;
+    m_nTrickNext = AV_NOPTS_VALUE;
+    m_nTrickLastKey = AV_NOPTS_VALUE;
+    m_nTrickKeyGap = 0;
 
     ptrPkt = AVPacketPtrCreate();
     if (!ptrPkt)
@@ -136,10 +154,40 @@ void CYDemuxFilter::OnEntry()
         av_dict_set(&format_opts, "scan_all_pmts", "1", AV_DICT_DONT_OVERWRITE);
         scan_all_pmts_set = 1;
     }
+    if (m_ptrContext->bMappedFileIO && CYMappedFileIO::IsLocalFile(m_ptrContext->pszFileName))
+    {
+        /* on failure the file protocol opens it as usual */
+        SharePtr<CYMappedFileIO> ptrMappedIO = MakeShared<CYMappedFileIO>();
+        if (ptrMappedIO->Open(m_ptrContext->pszFileName) >= 0)
+        {
+            pIC->pb = ptrMappedIO->Context();
+            m_ptrContext->ptrMappedIO = ptrMappedIO;
+        }
+        else
+        {
+            av_log(nullptr, AV_LOG_WARNING, "Could not map %s, falling back to the file protocol\n", m_ptrContext->pszFileName);
+        }
+    }
+    if (!pIC->pb && m_ptrContext->nReadAheadSize > 0 && !(m_ptrContext->iformat && (m_ptrContext->iformat->flags & AVFMT_NOFILE)))
+    {
+        /* reads block the I/O thread instead of this loop; on failure the protocol is opened as usual */
+        SharePtr<CYReadAheadIO> ptrReadAheadIO = MakeShared<CYReadAheadIO>();
+        if (ptrReadAheadIO->Open(m_ptrContext->pszFileName, &pIC->interrupt_callback, format_opts, m_ptrContext->nReadAheadSize, &m_ptrContext->objMemAccount) >= 0)
+        {
+            pIC->pb = ptrReadAheadIO->Context();
+            m_ptrContext->ptrReadAheadIO = ptrReadAheadIO;
+        }
+        else
+        {
+            av_log(nullptr, AV_LOG_WARNING, "Could not start read-ahead for %s, reading it directly\n", m_ptrContext->pszFileName);
+        }
+    }
     err = avformat_open_input(&pIC, m_ptrContext->pszFileName, m_ptrContext->iformat, &format_opts);
     if (err < 0)
     {
         print_error(m_ptrContext->pszFileName, err);
+        m_ptrContext->ptrMappedIO.reset();
+        m_ptrContext->ptrReadAheadIO.reset();
         ret = -1;
         goto fail;
     }
@@ -155,7 +203,12 @@ void CYDemuxFilter::OnEntry()
     if (m_ptrParam->bAutoGenPTS)
         pIC->flags |= AVFMT_FLAG_GENPTS;
 
-    if (m_ptrParam->bFindStreamInfo)
+    if (m_ptrParam->bFindStreamInfo && m_ptrContext->bStreamInfoCache &&
+        CYStreamInfoCache::Instance().Apply(pIC, m_ptrContext->pszFileName, m_ptrContext->szCacheDir))
+    {
+        /* probed by an earlier open of the same file */
+    }
+    else if (m_ptrParam->bFindStreamInfo)
     {
         AVDictionary** opts = nullptr;
         int orig_nb_streams = pIC->nb_streams;
@@ -180,6 +233,8 @@ void CYDemuxFilter::OnEntry()
             ret = -1;
             goto fail;
         }
+        if (m_ptrContext->bStreamInfoCache)
+            CYStreamInfoCache::Instance().Store(pIC, m_ptrContext->pszFileName, m_ptrContext->szCacheDir);
     }
 
     if (pIC->pb)
@@ -214,7 +269,7 @@ void CYDemuxFilter::OnEntry()
     if (m_ptrParam->bShowStatus)
         av_dump_format(pIC, 0, m_ptrContext->pszFileName, 0);
 
-    m_ptrContext->nFileDuration = pIC->duration / 1000.0;
+    m_ptrContext->objTimeline.Reset(pIC->start_time, pIC->duration / 1000);
 
     for (i = 0; i < pIC->nb_streams; i++)
     {
@@ -282,10 +337,19 @@ void CYDemuxFilter::OnEntry()
     if (m_ptrParam->nInfiniteBuffer < 0 && m_ptrContext->bRealTime)
         m_ptrParam->nInfiniteBuffer = 1;
 
+    InitKeyframeIndex(pIC, m_ptrContext->pszFileName);
+
     while (m_bRunning)
     {
         if (m_ptrContext->bAbortRequest)
             break;
+        if (m_ptrContext->bPlaylistCleared.exchange(false))
+            m_objPreloader.Cancel();
+        if (!m_objPreloader.Busy())
+            PreloadNextItem();
+        /* a seek into the tail on screen reads an earlier item again, so it stays open until shown */
+        if (!m_ptrContext->vecRetiredItems.empty() && ItemSwitched() && !m_ptrContext->objTimeline.Pending())
+            m_ptrContext->vecRetiredItems.clear();
         if (m_ptrContext->bPaused != m_ptrContext->nLastPaused)
         {
             m_ptrContext->nLastPaused = m_ptrContext->bPaused;
@@ -301,9 +365,56 @@ void CYDemuxFilter::OnEntry()
             continue;
         }
 #endif
-        if (m_ptrContext->bSeekReq)
+        ApplyTrickPlay(pIC);
+        /* a seek, SetSpeed, StepBack, a resume or a stop ends or restarts a reverse run, each notifies */
+        if (ApplyReverse())
+        {
+            m_ptrContext->ptrReadCond->Wait();
+            continue;
+        }
+        CYSeekTarget objSeek;
+        bool bSeekReq = m_ptrContext->objSeekReq.Take(&objSeek);
+        if (bSeekReq)
+        {
+            m_ptrContext->nSeekPos = objSeek.nPos;
+            m_ptrContext->nSeekRel = objSeek.nRel;
+            m_ptrContext->nSeekFlags &= ~AVSEEK_FLAG_BYTE;
+            if (objSeek.bByBytes)
+                m_ptrContext->nSeekFlags |= AVSEEK_FLAG_BYTE;
+            m_ptrContext->bAccurate = objSeek.bAccurate;
+        }
+        /* a target in the tail of an earlier item, still on screen, is sought once that item is read again */
+        if (bSeekReq && !(m_ptrContext->nSeekFlags & AVSEEK_FLAG_BYTE))
+        {
+            CYTimelineItem objItem;
+            int nWhere = m_ptrContext->objTimeline.Locate(m_ptrContext->nSeekPos, &objItem);
+            if (nWhere == CYItemTimeline::ITEM_PREVIOUS && ReturnToItem(objItem))
+            {
+                pIC = m_ptrContext->ptrIC.get();
+            }
+            else if (nWhere != CYItemTimeline::ITEM_READ)
+            {
+                av_log(nullptr, AV_LOG_WARNING, "seeking target = %" PRId64 " is in a playlist item that is closed, ignored\n", m_ptrContext->nSeekPos);
+                m_ptrContext->bAccurate = false;
+                bSeekReq = false;
+            }
+        }
+        /* the queues hold packets of one playlist item at a time once the decoders switched */
+        if (bSeekReq && !(m_ptrContext->nSeekFlags & AVSEEK_FLAG_BYTE) && ItemSwitched() && SeekInBuffer(m_ptrContext->nSeekPos - m_nItemOffset))
+        {
+            av_log(nullptr, AV_LOG_INFO, "seeking target = %" PRId64 " within the queued packets\n", m_ptrContext->nSeekPos);
+            m_ptrContext->extclk.SetClock(m_ptrContext->nSeekPos / (double)AV_TIME_BASE, 0);
+            SetSeekDecodeTarget(objSeek);
+            m_ptrContext->bAccurate = false;
+            bSeekReq = false;
+            if (m_ptrContext->bPaused)
+                StepToNextFrame();
+        }
+        if (bSeekReq)
         {
-            int64_t nSeekTarget = m_ptrContext->nSeekPos;
+            /* the playback timeline runs through every playlist item, the demuxer seeks in the current one */
+            int64_t nItemShift = (m_ptrContext->nSeekFlags & AVSEEK_FLAG_BYTE) ? 0 : m_nItemOffset.load();
+            int64_t nSeekTarget = m_ptrContext->nSeekPos - nItemShift;
             int64_t nSeekMin = m_ptrContext->nSeekRel > 0 ? nSeekTarget - m_ptrContext->nSeekRel + 2 : INT64_MIN;
             int64_t nSeekMax = m_ptrContext->nSeekRel < 0 ? nSeekTarget - m_ptrContext->nSeekRel - 2 : INT64_MAX;
 
@@ -316,10 +427,38 @@ void CYDemuxFilter::OnEntry()
             av_log(nullptr, AV_LOG_INFO, "------------------------------------\n");
             av_log(nullptr, AV_LOG_INFO, "seeking target = %lld\n", nSeekTarget);
 
-            ret = avformat_seek_file(m_ptrContext->ptrIC.get(), -1, nSeekMin, nSeekTarget, nSeekMax, m_ptrContext->nSeekFlags);
+            /* a known keyframe goes straight to its byte offset, the container is searched otherwise */
+            int64_t nKeyPos = -1, nKeyTimestamp = 0;
+            ret = -1;
+            if (!(m_ptrContext->nSeekFlags & AVSEEK_FLAG_BYTE) && m_bIndexByteSeek && m_objKeyIndex.Lookup(nSeekTarget, &nKeyPos, &nKeyTimestamp) &&
+                (m_ptrContext->bAccurate || nKeyTimestamp >= nSeekMin))
+            {
+                ret = avformat_seek_file(m_ptrContext->ptrIC.get(), -1, nKeyPos, nKeyPos, nKeyPos, AVSEEK_FLAG_BYTE);
+                if (ret >= 0)
+                    av_log(nullptr, AV_LOG_INFO, "seeking through keyframe index: %" PRId64 " at byte %" PRId64 "\n", nKeyTimestamp, nKeyPos);
+            }
             if (ret < 0)
+            {
+                m_ptrContext->bSeeking = true;
+                ret = avformat_seek_file(m_ptrContext->ptrIC.get(), -1, nSeekMin, nSeekTarget, nSeekMax, m_ptrContext->nSeekFlags);
+                m_ptrContext->bSeeking = false;
+            }
+            m_bIndexLinked = false;
+            if (ret < 0 && m_ptrContext->objSeekReq.Superseded(objSeek.nGeneration))
+            {
+                /* interrupted by a newer target, which the next iteration seeks to; the queues stay as they are */
+                av_log(nullptr, AV_LOG_INFO, "seeking target = %" PRId64 " superseded\n", nSeekTarget);
+                if (pIC->pb)
+                {
+                    pIC->pb->error = 0;
+                    pIC->pb->eof_reached = 0;
+                }
+                m_ptrContext->objSeekReq.ClearDecodeTarget();
+            }
+            else if (ret < 0)
             {
                 av_log(nullptr, AV_LOG_ERROR, "%s: error while seeking\n", m_ptrContext->ptrIC->url);
+                m_ptrContext->objSeekReq.ClearDecodeTarget();
             }
             else
             {
@@ -343,11 +482,11 @@ void CYDemuxFilter::OnEntry()
                 }
                 else
                 {
-                    m_ptrContext->extclk.SetClock(nSeekTarget / (double)AV_TIME_BASE, 0);
+                    m_ptrContext->extclk.SetClock((nSeekTarget + nItemShift) / (double)AV_TIME_BASE, 0);
                 }
+                SetSeekDecodeTarget(objSeek);
             }
             m_ptrContext->bAccurate = false;
-            m_ptrContext->bSeekReq = false;
             m_ptrContext->nQueueAttachmentsReq = 1;
             m_ptrContext->bEof = false;
             if (m_ptrContext->bPaused)
@@ -355,10 +494,13 @@ void CYDemuxFilter::OnEntry()
         }
         if (m_ptrContext->nQueueAttachmentsReq)
         {
-            if (m_ptrContext->pVideoStream && m_ptrContext->pVideoStream->disposition & AV_DISPOSITION_ATTACHED_PIC)
+            /* the picture of the item being read, the decoder may still be on the previous one */
+            AVStream* pPictureStream = m_ptrContext->nVideoStreamIndex >= 0 ? pIC->streams[m_ptrContext->nVideoStreamIndex] : nullptr;
+            if (pPictureStream && pPictureStream->disposition & AV_DISPOSITION_ATTACHED_PIC)
             {
-                if ((ret = av_packet_ref(ptrPkt.get(), &m_ptrContext->pVideoStream->attached_pic)) < 0)
+                if ((ret = av_packet_ref(ptrPkt.get(), &pPictureStream->attached_pic)) < 0)
                     goto fail;
+                ptrPkt->opaque = (void*)(intptr_t)m_nItem;
                 m_ptrContext->ptrVideoQueue->Put(ptrPkt);
 
                 m_ptrContext->ptrVideoQueue->PutNullPacket(ptrPkt, m_ptrContext->nVideoStreamIndex);
@@ -367,22 +509,32 @@ void CYDemuxFilter::OnEntry()
         }
 
         /* if the queue are full, no need to read more */
-        if (m_ptrParam->nInfiniteBuffer < 1 &&
-            (m_ptrContext->ptrAudioQueue->size + m_ptrContext->ptrVideoQueue->size + m_ptrContext->ptrSubTitleQueue->size > MAX_QUEUE_SIZE
-                || (StreamHasEnoughPackets(m_ptrContext->pAudioStream, m_ptrContext->nAudioStreamIndex, m_ptrContext->ptrAudioQueue) &&
-                    StreamHasEnoughPackets(m_ptrContext->pVideoStream, m_ptrContext->nVideoStreamIndex, m_ptrContext->ptrVideoQueue) &&
-                    StreamHasEnoughPackets(m_ptrContext->pSubTitleStream, m_ptrContext->nSubtitleStreamIndex, m_ptrContext->ptrSubTitleQueue))))
         {
-            m_ptrContext->ptrReadCond->WaitTimeOut(10);
-            continue;
+            /* the byte cap shrinks below MAX_QUEUE_SIZE when the memory budget is tight */
+            m_nReadAheadLimit = m_ptrContext->objMemAccount.ReadAheadLimit();
+            bool bBytesFull = m_ptrParam->nInfiniteBuffer < 1 &&
+                m_ptrContext->ptrAudioQueue->Size() + m_ptrContext->ptrVideoQueue->Size() + m_ptrContext->ptrSubTitleQueue->Size() > m_nReadAheadLimit;
+            bool bEnoughPackets = m_ptrParam->nInfiniteBuffer < 1 &&
+                StreamHasEnoughPackets(m_ptrContext->pAudioStream, m_ptrContext->nAudioStreamIndex, m_ptrContext->ptrAudioQueue) &&
+                StreamHasEnoughPackets(m_ptrContext->pVideoStream, m_ptrContext->nVideoStreamIndex, m_ptrContext->ptrVideoQueue) &&
+                StreamHasEnoughPackets(m_ptrContext->pSubTitleStream, m_ptrContext->nSubtitleStreamIndex, m_ptrContext->ptrSubTitleQueue);
+            bool bRingFull = m_ptrContext->ptrAudioQueue->Full() || m_ptrContext->ptrVideoQueue->Full() || m_ptrContext->ptrSubTitleQueue->Full();
+
+            if (bBytesFull || bEnoughPackets || bRingFull)
+            {
+                /* park until a decoder drains its queue below the low watermark, a seek or a stop */
+                if (ArmReadWakeup(bBytesFull, bEnoughPackets))
+                    m_ptrContext->ptrReadCond->Wait();
+                continue;
+            }
         }
-        if (!m_ptrContext->bPaused &&
+        if (!m_ptrContext->bPaused && !m_objPreloader.Busy() && ItemSwitched() &&
             (!m_ptrContext->pAudioStream || (m_ptrContext->auddec.m_nFinished == m_ptrContext->ptrAudioQueue->serial && m_ptrContext->sampq.NbRemaining() == 0)) &&
             (!m_ptrContext->pVideoStream || (m_ptrContext->viddec.m_nFinished == m_ptrContext->ptrVideoQueue->serial && m_ptrContext->pictq.NbRemaining() == 0)))
         {
             if (m_ptrContext->bLoop || (m_ptrContext->nLoop != 1 && (!m_ptrContext->nLoop || --m_ptrContext->nLoop)))
             {
-                StreamSeek(m_ptrContext->nStartTime != AV_NOPTS_VALUE ? m_ptrContext->nStartTime : 0, 0, 0);
+                StreamSeek((m_ptrContext->nStartTime != AV_NOPTS_VALUE ? m_ptrContext->nStartTime : 0) + m_nItemOffset, 0, 0, false);
             }
             else if (m_ptrContext->bAutoExit)
             {
@@ -414,7 +566,14 @@ void CYDemuxFilter::OnEntry()
                 }
 
                 m_ptrContext->bEof = true;
+                if (ret == AVERROR_EOF && m_bIndexLinked)
+                {
+                    m_objKeyIndex.MarkComplete();
+                    m_objKeyIndex.Save(m_ptrContext->szCacheDir);
+                }
             }
+            if (ret != AVERROR_EOF && ret != AVERROR(EAGAIN))
+                m_bIndexLinked = false;
             if (pIC->pb && pIC->pb->error)
             {
                 if (m_ptrContext->bAutoExit)
@@ -422,13 +581,64 @@ void CYDemuxFilter::OnEntry()
                 else
                     break;
             }
-            m_ptrContext->ptrReadCond->WaitTimeOut(10);
+
+            /* the next playlist item carries on once it is open, the decoders drain this one meanwhile;
+               the preloader notifies when it is done */
+            if (m_ptrContext->bEof && m_objPreloader.Busy())
+            {
+                if (!m_objPreloader.Done())
+                    m_ptrContext->ptrReadCond->Wait();
+                else if (SwitchToNextItem())
+                    pIC = m_ptrContext->ptrIC.get();
+                continue;
+            }
+
+            /* a loop starts reading again at once, the decoders finish the tail of the file meanwhile */
+            if (m_ptrContext->bEof && (m_ptrContext->bLoop || m_ptrContext->nLoop != 1) && !m_bLoopSeekFailed && LoopToStart(pIC))
+            {
+                if (!m_ptrContext->bLoop && m_ptrContext->nLoop > 1)
+                    m_ptrContext->nLoop--;
+                continue;
+            }
+
+            /* at eof only a seek, a stop or the loop/autoexit check can make progress; the latter waits
+               for the decoders to finish and the frame queues to drain, which notify. Other read
+               errors (EAGAIN) are retried shortly */
+            if (m_ptrContext->bEof && !m_ptrContext->bLoop && m_ptrContext->nLoop == 1 && !m_ptrContext->bAutoExit)
+            {
+                m_ptrContext->ptrReadCond->Wait();
+            }
+            else if (m_ptrContext->bEof)
+            {
+                if (m_ptrContext->pVideoStream)
+                    m_ptrContext->pictq.ArmDrainWakeup(m_ptrContext->ptrReadCond.get());
+                if (m_ptrContext->pAudioStream)
+                    m_ptrContext->sampq.ArmDrainWakeup(m_ptrContext->ptrReadCond.get());
+                m_ptrContext->ptrReadCond->Wait();
+            }
+            else
+            {
+                m_ptrContext->ptrReadCond->WaitTimeOut(10);
+            }
 
             continue;
         }
         else
         {
             m_ptrContext->bEof = false;
+            ptrPkt->opaque = (void*)(intptr_t)m_nItem;
+        }
+        if (ptrPkt->stream_index == m_objKeyIndex.StreamIndex() && (ptrPkt->flags & AV_PKT_FLAG_KEY))
+        {
+            AVStream* pIndexStream = pIC->streams[ptrPkt->stream_index];
+            int64_t nKeyTs = ptrPkt->pts == AV_NOPTS_VALUE ? ptrPkt->dts : ptrPkt->pts;
+            if (nKeyTs != AV_NOPTS_VALUE)
+            {
+                m_objKeyIndex.Add(av_rescale_q(nKeyTs, pIndexStream->time_base, AV_TIME_BASE_Q), ptrPkt->pos, m_bIndexLinked);
+                if (!m_bIndexByteSeek && ptrPkt->pos >= 0)
+                    av_add_index_entry(pIndexStream, ptrPkt->pos, nKeyTs, 0, 0, AVINDEX_KEYFRAME);
+            }
+            m_bIndexLinked = true;
         }
         /* check if packet is in play range specified by user, then queue, otherwise discard */
         stream_start_time = pIC->streams[ptrPkt->stream_index]->start_time;
@@ -448,6 +658,7 @@ void CYDemuxFilter::OnEntry()
 
         if (ptrPkt->stream_index == m_ptrContext->nAudioStreamIndex && pkt_in_play_range)
         {
+            TrackItemEnd(ptrPkt.get(), pIC->streams[ptrPkt->stream_index]);
             m_ptrContext->ptrAudioQueue->Put(ptrPkt);
 //#ifdef DEBUG
             av_log(nullptr, AV_LOG_INFO, "read audio fPktTimeSec: %.3f, fStartTimeOffsetSec: %.3f, fDurationSec: %.3f\n", fPktTimeSec, fStartTimeOffsetSec, fDurationSec);
@@ -455,6 +666,12 @@ void CYDemuxFilter::OnEntry()
         }
         else if (ptrPkt->stream_index == m_ptrContext->nVideoStreamIndex && pkt_in_play_range && !(m_ptrContext->pVideoStream->disposition & AV_DISPOSITION_ATTACHED_PIC))
         {
+            TrackItemEnd(ptrPkt.get(), pIC->streams[ptrPkt->stream_index]);
+            if (SkipTrickPlayPacket(pIC, ptrPkt.get()))
+            {
+                av_packet_unref(ptrPkt.get());
+                continue;
+            }
             m_ptrContext->ptrVideoQueue->Put(ptrPkt);
 //#ifdef DEBUG
             av_log(nullptr, AV_LOG_INFO, "read video fPktTimeSec: %.3f, fStartTimeOffsetSec: %.3f, fDurationSec: %.3f\n", fPktTimeSec, fStartTimeOffsetSec, fDurationSec);
@@ -479,8 +696,15 @@ fail:
     {
         pIC = nullptr;
         m_ptrContext->ptrIC.reset();
+        m_ptrContext->ptrMappedIO.reset();
+        m_ptrContext->ptrReadAheadIO.reset();
     }
 
+    m_objReverse.Close();
+    m_ptrContext->bReversing = false;
+    m_objPreloader.Cancel();
+    m_objKeyIndex.Save(m_ptrContext->szCacheDir);
+    m_objKeyIndex.Reset();
     ptrPkt.reset();
     if (ret != 0)
     {
@@ -492,37 +716,74 @@ fail:
     }
 }
 
+/* index keyframes of the video stream, or of the audio stream for audio-only files, unless the
+ * container already has an index reaching into the second half of the file. Only formats with
+ * timestamp discontinuities resync reliably after a byte seek, the others get the keyframes in
+ * their own index and keep seeking by timestamp */
+void CYDemuxFilter::InitKeyframeIndex(AVFormatContext* pIC, const char* pszURL)
+{
+    m_objKeyIndex.Reset();
+    m_bIndexLinked = m_ptrContext->nStartTime == AV_NOPTS_VALUE;
+    m_bIndexByteSeek = (pIC->iformat->flags & AVFMT_TS_DISCONT) != 0;
+    if (!m_ptrContext->bKeyframeIndex || (pIC->iformat->flags & AVFMT_NO_BYTE_SEEK) || m_ptrContext->bRealTime)
+        return;
+
+    int nStreamIndex = m_ptrContext->nVideoStreamIndex >= 0 ? m_ptrContext->nVideoStreamIndex : m_ptrContext->nAudioStreamIndex;
+    AVStream* st = pIC->streams[nStreamIndex];
+    int nEntries = avformat_index_get_entries_count(st);
+    if (nEntries > 0 && pIC->duration > 0)
+    {
+        const AVIndexEntry* pLast = avformat_index_get_entry(st, nEntries - 1);
+        int64_t nStart = pIC->start_time != AV_NOPTS_VALUE ? pIC->start_time : 0;
+        if (pLast && av_rescale_q(pLast->timestamp, st->time_base, AV_TIME_BASE_Q) - nStart > pIC->duration / 2)
+            return;
+    }
+
+    if (m_objKeyIndex.Init(pszURL, nStreamIndex, st->codecpar->codec_id) && m_objKeyIndex.Load(m_ptrContext->szCacheDir) && !m_bIndexByteSeek)
+        m_objKeyIndex.AddToStream(st);
+}
+
+/* a queue has enough with MIN_FRAMES packets and one second, it is refilled at half of that */
+static CYQueueWatermark StreamWatermark(AVStream* st)
+{
+    CYQueueWatermark objWatermark;
+    objWatermark.nHighPackets = MIN_FRAMES;
+    objWatermark.nLowPackets = MIN_FRAMES / 2;
+    objWatermark.nHighDuration = av_rescale_q(AV_TIME_BASE, AV_TIME_BASE_Q, st->time_base);
+    objWatermark.nLowDuration = objWatermark.nHighDuration / 2;
+    return objWatermark;
+}
+
 int AudioOpen(SharePtr<CYMediaContext>& ptrContext, AVChannelLayoutPtr& ptrChLayout, int wanted_sample_rate, struct CYAudioParams* audio_hw_params);
-/* open a given stream. Return 0 if OK */
-int StreamComponentOpen(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex)
+
+/* create and open the decoder of stream nStreamIndex of pIC with the player's codec options, also used
+ * by the playlist preloader on formats that are not the current one. A video decoder claims its threads
+ * on objLease and takes its pictures from pFramePool, if any: the player's for the decoder it plays
+ * with, others for decoders opened ahead of their turn. Return 0 if OK */
+int OpenCodecContext(SharePtr<CYMediaContext>& ptrContext, AVFormatContext* pIC, int nStreamIndex, AVCodecContextPtr& ptrAVCtx, CYThreadLease& objLease, CYFrameBufferPool* pFramePool)
 {
-    AVCodecContextPtr ptrAVCtx;
     const AVCodec* codec = nullptr;
     const char* pszForcedCodecName = nullptr;
     AVDictionary* opts = nullptr;
-    ptrContext->ptrChLayout = AVChannelLayoutPtr(new AVChannelLayout());
     int ret = 0;
     int nStreamLowres = ptrContext->nLowRes;
 
-    if (nStreamIndex < 0 || nStreamIndex >= ptrContext->ptrIC->nb_streams)
-        return -1;
-
     ptrAVCtx = AVCodecContextPtrCreate(nullptr);
     if (!ptrAVCtx)
         return AVERROR(ENOMEM);
 
-    ret = avcodec_parameters_to_context(ptrAVCtx.get(), ptrContext->ptrIC->streams[nStreamIndex]->codecpar);
+    ret = avcodec_parameters_to_context(ptrAVCtx.get(), pIC->streams[nStreamIndex]->codecpar);
     if (ret < 0)
         goto fail;
-    ptrAVCtx->pkt_timebase = ptrContext->ptrIC->streams[nStreamIndex]->time_base;
+    ptrAVCtx->pkt_timebase = pIC->streams[nStreamIndex]->time_base;
 
     codec = avcodec_find_decoder(ptrAVCtx->codec_id);
 
     switch (ptrAVCtx->codec_type)
     {
-    case AVMEDIA_TYPE_AUDIO: ptrContext->nLastAudioStream = nStreamIndex; pszForcedCodecName = strlen(ptrContext->szForceAudioCodecName) ? ptrContext->szForceAudioCodecName : nullptr; break;
-    case AVMEDIA_TYPE_SUBTITLE: ptrContext->nLastSubTitleStream = nStreamIndex; pszForcedCodecName = strlen(ptrContext->szForceSubtitleCodecName) ? ptrContext->szForceSubtitleCodecName : nullptr; break;
-    case AVMEDIA_TYPE_VIDEO: ptrContext->nLastVideoStream = nStreamIndex; pszForcedCodecName = strlen(ptrContext->szForceVideoCodecName) ? ptrContext->szForceVideoCodecName : nullptr; break;
+    case AVMEDIA_TYPE_AUDIO: pszForcedCodecName = strlen(ptrContext->szForceAudioCodecName) ? ptrContext->szForceAudioCodecName : nullptr; break;
+    case AVMEDIA_TYPE_SUBTITLE: pszForcedCodecName = strlen(ptrContext->szForceSubtitleCodecName) ? ptrContext->szForceSubtitleCodecName : nullptr; break;
+    case AVMEDIA_TYPE_VIDEO: pszForcedCodecName = strlen(ptrContext->szForceVideoCodecName) ? ptrContext->szForceVideoCodecName : nullptr; break;
     }
     if (pszForcedCodecName)
         codec = avcodec_find_decoder_by_name(pszForcedCodecName);
@@ -547,12 +808,30 @@ int StreamComponentOpen(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex)
     if (ptrContext->bFastDecode)
         ptrAVCtx->flags2 |= AV_CODEC_FLAG2_FAST;
 
-    ret = filter_codec_opts(codec_opts, ptrAVCtx->codec_id, ptrContext->ptrIC.get(), ptrContext->ptrIC->streams[nStreamIndex], codec, &opts, nullptr);
+    ret = filter_codec_opts(codec_opts, ptrAVCtx->codec_id, pIC, pIC->streams[nStreamIndex], codec, &opts, nullptr);
     if (ret < 0)
         goto fail;
 
     if (!av_dict_get(opts, "threads", nullptr, 0))
-        av_dict_set(&opts, "threads", "auto", 0);
+    {
+        /* under a process thread budget the video decoders of all players split it, the others take one */
+        int nThreads = 0;
+        if (ptrAVCtx->codec_type == AVMEDIA_TYPE_VIDEO)
+        {
+            AVRational objFrameRate = av_guess_frame_rate(pIC, pIC->streams[nStreamIndex], nullptr);
+            int64_t nPixelRate = ((int64_t)ptrAVCtx->width * ptrAVCtx->height >> (2 * nStreamLowres)) *
+                (objFrameRate.num > 0 && objFrameRate.den > 0 ? av_q2d(objFrameRate) : 25);
+            nThreads = objLease.Acquire(nPixelRate, ptrContext->nDecodePriority);
+        }
+        else if (CYThreadBudget::Instance().GetBudget())
+        {
+            nThreads = 1;
+        }
+        if (nThreads > 0)
+            av_dict_set_int(&opts, "threads", nThreads, 0);
+        else
+            av_dict_set(&opts, "threads", "auto", 0);
+    }
     if (nStreamLowres)
         av_dict_set_int(&opts, "lowres", nStreamLowres, 0);
 
@@ -563,6 +842,9 @@ int StreamComponentOpen(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex)
         ret = CreateHwaccel(ptrContext, &ptrAVCtx->hw_device_ctx);
         if (ret < 0)
             goto fail;
+
+        if (pFramePool)
+            pFramePool->Install(ptrAVCtx.get(), ptrContext->bHugePageFrames);
     }
 
     if ((ret = avcodec_open2(ptrAVCtx.get(), codec, &opts)) < 0)
@@ -572,9 +854,43 @@ int StreamComponentOpen(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex)
     ret = check_avoptions(opts);
     if (ret < 0)
         goto fail;
+    goto out;
+
+fail:
+    ptrAVCtx.reset();
+out:
+    av_dict_free(&opts);
+    return ret;
+}
+
+/* open a given stream. Return 0 if OK */
+int StreamComponentOpen(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex)
+{
+    AVCodecContextPtr ptrAVCtx;
+    ptrContext->ptrChLayout = AVChannelLayoutPtr(new AVChannelLayout());
+    int ret = 0;
+    CYQueueWatermark objWatermark;
+
+    if (nStreamIndex < 0 || nStreamIndex >= ptrContext->ptrIC->nb_streams)
+        return -1;
+
+    switch (ptrContext->ptrIC->streams[nStreamIndex]->codecpar->codec_type)
+    {
+    case AVMEDIA_TYPE_AUDIO: ptrContext->nLastAudioStream = nStreamIndex; break;
+    case AVMEDIA_TYPE_SUBTITLE: ptrContext->nLastSubTitleStream = nStreamIndex; break;
+    case AVMEDIA_TYPE_VIDEO: ptrContext->nLastVideoStream = nStreamIndex; break;
+    default: break;
+    }
+
+    if (ptrContext->bFrameBufferPool && !ptrContext->ptrFramePool)
+        ptrContext->ptrFramePool = MakeShared<CYFrameBufferPool>();
+    if ((ret = OpenCodecContext(ptrContext, ptrContext->ptrIC.get(), nStreamIndex, ptrAVCtx, ptrContext->objThreadLease,
+        ptrContext->bFrameBufferPool ? ptrContext->ptrFramePool.get() : nullptr)) < 0)
+        goto fail;
 
     ptrContext->bEof = false;
     ptrContext->ptrIC->streams[nStreamIndex]->discard = AVDISCARD_DEFAULT;
+    objWatermark = StreamWatermark(ptrContext->ptrIC->streams[nStreamIndex]);
     switch (ptrAVCtx->codec_type)
     {
     case AVMEDIA_TYPE_AUDIO:
@@ -617,6 +933,7 @@ int StreamComponentOpen(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex)
 
     //////////////////////////////////////////////////////////////////////////
 
+    ptrContext->ptrAudioQueue->SetWatermark(objWatermark);
     if ((ret = ptrContext->auddec.Init(ptrContext, ptrAVCtx.release(), ptrContext->ptrAudioQueue, ptrContext->ptrReadCond)) < 0)
         goto fail;
 
@@ -633,6 +950,10 @@ int StreamComponentOpen(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex)
         ptrContext->nVideoStreamIndex = nStreamIndex;
         ptrContext->pVideoStream = ptrContext->ptrIC->streams[nStreamIndex];
 
+        if (ptrContext->bFrameBufferPool && ptrContext->ptrFramePool)
+            ptrContext->ptrFramePool->Prewarm(ptrAVCtx.get(), ptrContext->pictq.max_size + FRAME_POOL_PREWARM_EXTRA);
+
+        ptrContext->ptrVideoQueue->SetWatermark(objWatermark);
         if ((ret = ptrContext->viddec.Init(ptrContext, ptrAVCtx.release(), ptrContext->ptrVideoQueue, ptrContext->ptrReadCond)) < 0)
             goto fail;
 
@@ -643,6 +964,7 @@ int StreamComponentOpen(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex)
         ptrContext->nSubtitleStreamIndex = nStreamIndex;
         ptrContext->pSubTitleStream = ptrContext->ptrIC->streams[nStreamIndex];
 
+        ptrContext->ptrSubTitleQueue->SetWatermark(objWatermark);
         if ((ret = ptrContext->subdec.Init(ptrContext, ptrAVCtx.release(), ptrContext->ptrSubTitleQueue, ptrContext->ptrReadCond)) < 0)
             goto fail;
 
@@ -651,17 +973,479 @@ int StreamComponentOpen(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex)
     default:
         break;
     }
+
+    /* the new queue is empty, a parked demuxer has to start filling it */
+    ptrContext->ptrReadCond->NotifyOne();
     goto out;
 
 fail:
     ptrAVCtx.reset();
 out:
     ptrContext->ptrChLayout.reset();
-    av_dict_free(&opts);
 
     return ret;
 }
 
+/* start opening the next playlist item while the current one plays */
+void CYDemuxFilter::PreloadNextItem()
+{
+    std::string strURL;
+    {
+        UniqueLock locker(m_ptrContext->mutexPlaylist);
+        if (m_ptrContext->deqPlaylist.empty())
+            return;
+        strURL = m_ptrContext->deqPlaylist.front();
+        m_ptrContext->deqPlaylist.pop_front();
+    }
+    m_objPreloader.Start(m_ptrContext, m_ptrParam, strURL);
+}
+
+/* the decoders took the codec of the item being read, earlier items are no longer referenced */
+bool CYDemuxFilter::ItemSwitched() const
+{
+    return (m_ptrContext->nVideoStreamIndex < 0 || m_ptrContext->viddec.GetItem() == m_nItem) &&
+        (m_ptrContext->nAudioStreamIndex < 0 || m_ptrContext->auddec.GetItem() == m_nItem);
+}
+
+/* where the current item ends on the playback timeline, in AV_TIME_BASE */
+void CYDemuxFilter::TrackItemEnd(const AVPacket* pPkt, AVStream* st)
+{
+    int64_t nPts = pPkt->pts != AV_NOPTS_VALUE ? pPkt->pts : pPkt->dts;
+    if (nPts == AV_NOPTS_VALUE)
+        return;
+
+    int64_t nEnd = av_rescale_q(nPts + pPkt->duration, st->time_base, AV_TIME_BASE_Q) + m_nItemOffset;
+    if (m_nItemEnd == AV_NOPTS_VALUE || nEnd > m_nItemEnd)
+        m_nItemEnd = nEnd;
+}
+
+void CYDemuxFilter::ReportItemError(const std::string& strURL, const char* pszReason)
+{
+    av_log(nullptr, AV_LOG_ERROR, "%s: %s, skipping the playlist item\n", strURL.c_str(), pszReason);
+    if (m_ptrContext->funEventCallBack)
+    {
+        EPlayerEventInfo objEvent = {};
+        objEvent.eEventType = TYPE_EVENT_ERROR_OCCURRED;
+        objEvent.nErrorCode = ERR_PLAYLIST_FAILED;
+        snprintf(objEvent.szMessage, sizeof(objEvent.szMessage), "%s: %s", strURL.c_str(), pszReason);
+        m_ptrContext->funEventCallBack(&objEvent);
+    }
+}
+
+void StreamComponentClose(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex);
+/* the current item was read to its end: carry on with the preloaded one on the same queues, clocks
+ * and audio device. Its timestamps are offset to start where the current item ends, and each decoder
+ * takes its codec context at the first packet tagged with the new item number, after draining the
+ * current one. Subtitles stop at the switch. false when the item failed to open or has other streams */
+bool CYDemuxFilter::SwitchToNextItem()
+{
+    std::string strURL = m_objPreloader.URL();
+    SharePtr<CYMediaItem> ptrItem = m_objPreloader.Take();
+    if (!ptrItem)
+    {
+        ReportItemError(strURL, "could not be opened");
+        return false;
+    }
+
+    AVFormatContext* pIC = ptrItem->ptrIC.get();
+    AVStream* pVideoStream = ptrItem->nVideoStreamIndex >= 0 ? pIC->streams[ptrItem->nVideoStreamIndex] : nullptr;
+    AVStream* pAudioStream = ptrItem->nAudioStreamIndex >= 0 ? pIC->streams[ptrItem->nAudioStreamIndex] : nullptr;
+    AVStream* pCurVideoStream = m_ptrContext->nVideoStreamIndex >= 0 ? m_ptrContext->ptrIC->streams[m_ptrContext->nVideoStreamIndex] : nullptr;
+    bool bPicture = pVideoStream && (pVideoStream->disposition & AV_DISPOSITION_ATTACHED_PIC);
+    bool bCurPicture = pCurVideoStream && (pCurVideoStream->disposition & AV_DISPOSITION_ATTACHED_PIC);
+    if (!pVideoStream != !pCurVideoStream || bPicture != bCurPicture || !pAudioStream != (m_ptrContext->nAudioStreamIndex < 0))
+    {
+        ReportItemError(strURL, "its streams differ from the current item");
+        return false;
+    }
+
+    if (m_ptrContext->nSubtitleStreamIndex >= 0)
+        StreamComponentClose(m_ptrContext, m_ptrContext->nSubtitleStreamIndex);
+
+    int64_t nItemStart = pIC->start_time != AV_NOPTS_VALUE ? pIC->start_time : 0;
+    int64_t nItemEnd = m_nItemEnd != AV_NOPTS_VALUE ? m_nItemEnd : m_nItemOffset.load();
+    int64_t nOffset = nItemEnd - nItemStart;
+
+    RetireItem();
+
+    ptrItem->bPlaying = true;
+    ptrItem->nOffset = nOffset;
+    m_bLoopSeekFailed = false;
+    m_ptrContext->ptrMappedIO = std::move(ptrItem->ptrMappedIO);
+    m_ptrContext->ptrReadAheadIO = std::move(ptrItem->ptrReadAheadIO);
+    m_ptrContext->ptrIC = std::move(ptrItem->ptrIC);
+    m_ptrContext->ptrPlaylistItem = ptrItem;
+    m_ptrContext->nVideoStreamIndex = ptrItem->nVideoStreamIndex;
+    m_ptrContext->nAudioStreamIndex = ptrItem->nAudioStreamIndex;
+
+    m_nItem++;
+    m_nItemOffset = nOffset;
+    m_nItemEnd = AV_NOPTS_VALUE;
+    if (pVideoStream)
+    {
+        m_ptrContext->ptrVideoQueue->SetWatermark(StreamWatermark(pVideoStream));
+        m_ptrContext->viddec.QueueSwitch(m_nItem, ptrItem->ptrVideoCtx.release(), pVideoStream, nOffset, ptrItem);
+    }
+    if (pAudioStream)
+    {
+        m_ptrContext->ptrAudioQueue->SetWatermark(StreamWatermark(pAudioStream));
+        m_ptrContext->auddec.QueueSwitch(m_nItem, ptrItem->ptrAudioCtx.release(), pAudioStream, nOffset);
+    }
+
+    /* positions and the duration follow the new item once playback reaches its first frame */
+    CYTimelineItem objItem;
+    objItem.nStart = nItemEnd;
+    objItem.nOffset = nOffset;
+    objItem.nDuration = pIC->duration / 1000;
+    m_ptrContext->objTimeline.Queue(objItem);
+
+    InitKeyframeIndex(pIC, ptrItem->strURL.c_str());
+    m_ptrContext->nQueueAttachmentsReq = 1;
+    m_ptrContext->bEof = false;
+
+    for (auto& ptrPkt : ptrItem->vecPackets)
+    {
+        ptrPkt->opaque = (void*)(intptr_t)m_nItem;
+        TrackItemEnd(ptrPkt.get(), pIC->streams[ptrPkt->stream_index]);
+        if (ptrPkt->stream_index == m_ptrContext->nAudioStreamIndex)
+            m_ptrContext->ptrAudioQueue->Put(ptrPkt);
+        else if (!bPicture)
+            m_ptrContext->ptrVideoQueue->Put(ptrPkt);
+    }
+    ptrItem->vecPackets.clear();
+
+    av_log(nullptr, AV_LOG_INFO, "playlist item %d: %s starts at %.3f\n", m_nItem, ptrItem->strURL.c_str(), nItemEnd / (double)AV_TIME_BASE);
+    return true;
+}
+
+/* the end of the file was read and queued with its null packets: seek back to the start without
+ * flushing the queues. What follows is read as the next item of a playlist holding the same file, so
+ * the decoders keep their codecs and only shift the timestamps to carry on from where the file ended.
+ * false when the seek failed: that is latched for the item, whose loops then wait for the pipeline to
+ * drain and seek as usual */
+bool CYDemuxFilter::LoopToStart(AVFormatContext* pIC)
+{
+    int64_t nLoopStart = m_ptrContext->nStartTime != AV_NOPTS_VALUE ? m_ptrContext->nStartTime :
+        (pIC->start_time != AV_NOPTS_VALUE ? pIC->start_time : 0);
+    if (avformat_seek_file(pIC, -1, INT64_MIN, nLoopStart, nLoopStart, 0) < 0)
+    {
+        av_log(nullptr, AV_LOG_WARNING, "%s: cannot loop without draining\n", pIC->url);
+        m_bLoopSeekFailed = true;
+        return false;
+    }
+
+    int64_t nItemEnd = m_nItemEnd != AV_NOPTS_VALUE ? m_nItemEnd : m_nItemOffset.load();
+    int64_t nOffset = nItemEnd - nLoopStart;
+
+    m_nItem++;
+    m_nItemOffset = nOffset;
+    m_nItemEnd = AV_NOPTS_VALUE;
+    m_bIndexLinked = false;
+    if (m_ptrContext->nVideoStreamIndex >= 0)
+        m_ptrContext->viddec.QueueSwitch(m_nItem, nullptr, nullptr, nOffset);
+    if (m_ptrContext->nAudioStreamIndex >= 0)
+        m_ptrContext->auddec.QueueSwitch(m_nItem, nullptr, nullptr, nOffset);
+    if (m_ptrContext->nSubtitleStreamIndex >= 0)
+        m_ptrContext->subdec.QueueSwitch(m_nItem, nullptr, nullptr, nOffset);
+
+    CYTimelineItem objItem;
+    objItem.nStart = nItemEnd;
+    objItem.nOffset = nOffset;
+    objItem.nDuration = pIC->duration / 1000;
+    objItem.bLoop = true;
+    m_ptrContext->objTimeline.Queue(objItem);
+
+    m_ptrContext->nQueueAttachmentsReq = 1;
+    m_ptrContext->bEof = false;
+
+    av_log(nullptr, AV_LOG_INFO, "loop %d starts at %.3f\n", m_nItem, nItemEnd / (double)AV_TIME_BASE);
+    return true;
+}
+
+/* the item being read stays open until both decoders are past its last packet and the screen is too */
+void CYDemuxFilter::RetireItem()
+{
+    SharePtr<CYMediaItem> ptrRetired = m_ptrContext->ptrPlaylistItem ? m_ptrContext->ptrPlaylistItem : MakeShared<CYMediaItem>();
+    if (ptrRetired->strURL.empty())
+        ptrRetired->strURL = m_ptrContext->pszFileName;
+    ptrRetired->bPlaying = false;
+    ptrRetired->nOffset = m_nItemOffset;
+    ptrRetired->nVideoStreamIndex = m_ptrContext->nVideoStreamIndex;
+    ptrRetired->nAudioStreamIndex = m_ptrContext->nAudioStreamIndex;
+    ptrRetired->ptrMappedIO = std::move(m_ptrContext->ptrMappedIO);
+    ptrRetired->ptrReadAheadIO = std::move(m_ptrContext->ptrReadAheadIO);
+    ptrRetired->ptrIC = std::move(m_ptrContext->ptrIC);
+    m_ptrContext->vecRetiredItems.push_back(ptrRetired);
+}
+
+/* a seek went back into objItem, the item read before the current one, whose tail is still on screen:
+ * read it again from there. Another round of a loop only shifts the timestamps back; another file is
+ * taken back from the retired items with new decoders, and the item being read and the one being
+ * preloaded go back to the front of the playlist. false when the item is closed already */
+bool CYDemuxFilter::ReturnToItem(const CYTimelineItem& objItem)
+{
+    AVStream* pVideoStream = nullptr;
+    AVStream* pAudioStream = nullptr;
+    SharePtr<CYMediaItem> ptrItem;
+
+    if (!m_ptrContext->objTimeline.Read().bLoop)
+    {
+        auto itItem = std::find_if(m_ptrContext->vecRetiredItems.begin(), m_ptrContext->vecRetiredItems.end(),
+            [&](const SharePtr<CYMediaItem>& ptrRetired) { return ptrRetired->ptrIC && ptrRetired->nOffset == objItem.nOffset; });
+        if (itItem == m_ptrContext->vecRetiredItems.end() || !m_ptrContext->ptrPlaylistItem)
+            return false;
+        ptrItem = *itItem;
+
+        /* the decoders took over its codecs and closed them, it gets new ones as a preloaded item does */
+        AVFormatContext* pIC = ptrItem->ptrIC.get();
+        if (m_ptrContext->bFrameBufferPool)
+            ptrItem->ptrFramePool = MakeShared<CYFrameBufferPool>();
+        if ((ptrItem->nVideoStreamIndex >= 0 &&
+            OpenCodecContext(m_ptrContext, pIC, ptrItem->nVideoStreamIndex, ptrItem->ptrVideoCtx, ptrItem->objThreadLease, ptrItem->ptrFramePool.get()) < 0) ||
+            (ptrItem->nAudioStreamIndex >= 0 &&
+            OpenCodecContext(m_ptrContext, pIC, ptrItem->nAudioStreamIndex, ptrItem->ptrAudioCtx, ptrItem->objThreadLease, nullptr) < 0))
+        {
+            av_log(nullptr, AV_LOG_ERROR, "%s: cannot reopen the decoders to seek back into it\n", ptrItem->strURL.c_str());
+            ptrItem->ptrVideoCtx.reset();
+            ptrItem->ptrAudioCtx.reset();
+            ptrItem->ptrFramePool.reset();
+            ptrItem->objThreadLease.Release();
+            return false;
+        }
+        pVideoStream = ptrItem->nVideoStreamIndex >= 0 ? pIC->streams[ptrItem->nVideoStreamIndex] : nullptr;
+        pAudioStream = ptrItem->nAudioStreamIndex >= 0 ? pIC->streams[ptrItem->nAudioStreamIndex] : nullptr;
+
+        {
+            UniqueLock locker(m_ptrContext->mutexPlaylist);
+            if (m_objPreloader.Busy())
+                m_ptrContext->deqPlaylist.push_front(m_objPreloader.URL());
+            m_ptrContext->deqPlaylist.push_front(m_ptrContext->ptrPlaylistItem->strURL);
+        }
+        m_objPreloader.Cancel();
+        m_ptrContext->vecRetiredItems.erase(itItem);
+
+        if (m_ptrContext->nSubtitleStreamIndex >= 0)
+            StreamComponentClose(m_ptrContext, m_ptrContext->nSubtitleStreamIndex);
+        RetireItem();
+
+        ptrItem->bPlaying = true;
+        m_ptrContext->ptrMappedIO = std::move(ptrItem->ptrMappedIO);
+        m_ptrContext->ptrReadAheadIO = std::move(ptrItem->ptrReadAheadIO);
+        m_ptrContext->ptrIC = std::move(ptrItem->ptrIC);
+        m_ptrContext->ptrPlaylistItem = ptrItem;
+        m_ptrContext->nVideoStreamIndex = ptrItem->nVideoStreamIndex;
+        m_ptrContext->nAudioStreamIndex = ptrItem->nAudioStreamIndex;
+        m_bLoopSeekFailed = false;
+    }
+    else if (!m_ptrContext->bLoop && m_ptrContext->nLoop > 0)
+    {
+        /* the round it goes back to is played again */
+        m_ptrContext->nLoop++;
+    }
+
+    m_nItem++;
+    m_nItemOffset = objItem.nOffset;
+    m_nItemEnd = AV_NOPTS_VALUE;
+    m_bIndexLinked = false;
+    if (m_ptrContext->nVideoStreamIndex >= 0)
+    {
+        if (pVideoStream)
+            m_ptrContext->ptrVideoQueue->SetWatermark(StreamWatermark(pVideoStream));
+        m_ptrContext->viddec.QueueSwitch(m_nItem, ptrItem ? ptrItem->ptrVideoCtx.release() : nullptr, pVideoStream, objItem.nOffset, ptrItem);
+    }
+    if (m_ptrContext->nAudioStreamIndex >= 0)
+    {
+        if (pAudioStream)
+            m_ptrContext->ptrAudioQueue->SetWatermark(StreamWatermark(pAudioStream));
+        m_ptrContext->auddec.QueueSwitch(m_nItem, ptrItem ? ptrItem->ptrAudioCtx.release() : nullptr, pAudioStream, objItem.nOffset);
+    }
+    if (m_ptrContext->nSubtitleStreamIndex >= 0)
+        m_ptrContext->subdec.QueueSwitch(m_nItem, nullptr, nullptr, objItem.nOffset);
+    m_ptrContext->objTimeline.Return();
+    if (ptrItem)
+        InitKeyframeIndex(m_ptrContext->ptrIC.get(), ptrItem->strURL.c_str());
+
+    m_ptrContext->nQueueAttachmentsReq = 1;
+    m_ptrContext->bEof = false;
+
+    av_log(nullptr, AV_LOG_INFO, "playlist item %d: back to the one starting at %.3f\n", m_nItem, objItem.nStart / (double)AV_TIME_BASE);
+    return true;
+}
+
+/* the trick mode SetSpeed picks for fSpeed */
+static int TrickMode(double fSpeed)
+{
+    if (fSpeed < 0)
+        return TRICK_MODE_REVERSE;
+    if (fSpeed >= TRICK_PLAY_KEYFRAME_SPEED)
+        return TRICK_MODE_KEYFRAMES;
+    if (fSpeed >= TRICK_PLAY_NONREF_SPEED)
+        return TRICK_MODE_NONREF;
+    return TRICK_MODE_NONE;
+}
+
+/* the demux side of SetSpeed: a muted audio stream is not read, in keyframe mode the video stream only
+ * for its keyframes, and the clocks run at the speed from the picture on screen. When what is decoded
+ * changes the queues restart there, accurately unless only keyframes follow. The mode is derived from
+ * the one speed read here, nTrickMode may not have been updated along with it yet. */
+void CYDemuxFilter::ApplyTrickPlay(AVFormatContext* pIC)
+{
+    double fSpeed = m_ptrContext->fPlaybackSpeed;
+    int nMode = TrickMode(fSpeed);
+    bool bChanged = fSpeed != m_fTrickSpeed || nMode != m_nTrickMode;
+    if (!bChanged && pIC == m_pTrickIC)
+        return;
+
+    /* also for a playlist item that was just switched to */
+    if (m_ptrContext->nVideoStreamIndex >= 0)
+        pIC->streams[m_ptrContext->nVideoStreamIndex]->discard = nMode == TRICK_MODE_KEYFRAMES ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+    if (m_ptrContext->nAudioStreamIndex >= 0)
+        pIC->streams[m_ptrContext->nAudioStreamIndex]->discard = fSpeed != AudioTempo(fSpeed) ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+    m_pTrickIC = pIC;
+    if (!bChanged)
+        return;
+
+    bool bRestart = nMode != m_nTrickMode || AudioTempo(fSpeed) != AudioTempo(m_fTrickSpeed);
+
+    double fPos = m_ptrContext->pVideoStream ? m_ptrContext->vidclk.GetClock() : NAN;
+    if (isnan(fPos))
+        fPos = m_ptrContext->audclk.GetClock();
+    if (isnan(fPos))
+        fPos = m_ptrContext->extclk.GetClock();
+
+    m_ptrContext->vidclk.SetClockSpeed(fSpeed);
+    m_ptrContext->audclk.SetClockSpeed(fSpeed);
+    m_ptrContext->extclk.SetClockSpeed(fSpeed);
+    if (!isnan(fPos))
+        m_ptrContext->extclk.SetClock(fPos, m_ptrContext->extclk.m_fSerial);
+
+    /* going into or out of reverse is up to ApplyReverse */
+    if (bRestart && !isnan(fPos) && fSpeed > 0 && m_fTrickSpeed > 0)
+    {
+        /* queued keyframes alone cannot serve the seek from the buffer */
+        if (m_ptrContext->nVideoStreamIndex >= 0)
+            m_ptrContext->ptrVideoQueue->Flush();
+        StreamSeek((int64_t)(fPos * AV_TIME_BASE), 0, 0, nMode != TRICK_MODE_KEYFRAMES);
+    }
+
+    av_log(nullptr, AV_LOG_INFO, "playback speed %.2f -> %.2f, trick mode %d\n", m_fTrickSpeed, fSpeed, nMode);
+    m_fTrickSpeed = fSpeed;
+    m_nTrickMode = nMode;
+    m_nTrickNext = AV_NOPTS_VALUE;
+    m_nTrickLastKey = AV_NOPTS_VALUE;
+}
+
+/* keyframe trick play: keep the first keyframe at or after the next position wanted, TRICK_PLAY_KEYFRAME_INTERVAL
+ * of playback after the previous one, and seek there when that skips more than a couple of keyframes */
+bool CYDemuxFilter::SkipTrickPlayPacket(AVFormatContext* pIC, const AVPacket* pPkt)
+{
+    if (m_nTrickMode != TRICK_MODE_KEYFRAMES)
+        return false;
+    /* for demuxers that ignore AVDISCARD_NONKEY */
+    if (!(pPkt->flags & AV_PKT_FLAG_KEY))
+        return true;
+
+    int64_t nTs = pPkt->pts == AV_NOPTS_VALUE ? pPkt->dts : pPkt->pts;
+    if (nTs == AV_NOPTS_VALUE)
+        return false;
+    nTs = av_rescale_q(nTs, pIC->streams[pPkt->stream_index]->time_base, AV_TIME_BASE_Q);
+
+    /* a seek, a loop or the next playlist item went back */
+    if (m_nTrickLastKey != AV_NOPTS_VALUE && nTs < m_nTrickLastKey)
+        m_nTrickNext = AV_NOPTS_VALUE;
+    else if (m_nTrickLastKey != AV_NOPTS_VALUE)
+        m_nTrickKeyGap = nTs - m_nTrickLastKey;
+    m_nTrickLastKey = nTs;
+    if (m_nTrickNext != AV_NOPTS_VALUE && nTs < m_nTrickNext)
+        return true;
+
+    int64_t nStep = (int64_t)(m_fTrickSpeed * TRICK_PLAY_KEYFRAME_INTERVAL * AV_TIME_BASE);
+    m_nTrickNext = nTs + nStep;
+    if (m_nTrickKeyGap > 0 && nStep > 2 * m_nTrickKeyGap &&
+        avformat_seek_file(pIC, -1, m_nTrickNext, m_nTrickNext, INT64_MAX, 0) >= 0)
+    {
+        m_bIndexLinked = false;
+        m_nTrickLastKey = AV_NOPTS_VALUE;
+    }
+    return false;
+}
+
+/* reverse playback runs while the speed is REVERSE_PLAY_SPEED, and from a StepBack for as long as the
+ * player stays paused or steps; forward playback then restarts with an accurate seek to the picture it
+ * got to. The demuxer reads nothing meanwhile, a seek restarts the reverse run at its target. */
+bool CYDemuxFilter::ApplyReverse()
+{
+    bool bStepBack = m_ptrContext->nStepBackReq.exchange(0) > 0;
+    bool bReversing = m_objReverse.Running();
+    bool bVideo = !m_ptrContext->bRealTime && m_ptrContext->nVideoStreamIndex >= 0 && m_ptrContext->pVideoStream &&
+        !(m_ptrContext->pVideoStream->disposition & AV_DISPOSITION_ATTACHED_PIC);
+    bool bWanted = bVideo && (m_ptrContext->fPlaybackSpeed < 0 || bStepBack ||
+        (bReversing && (m_ptrContext->bPaused || m_ptrContext->bStep)));
+
+    if (!bWanted)
+    {
+        if (bReversing)
+        {
+            /* the picture on screen, the ones queued after it are dropped */
+            double fPos = m_ptrContext->vidclk.m_fPTS;
+            if (isnan(fPos))
+                fPos = m_objReverse.Position();
+            m_objReverse.Stop();
+            m_ptrContext->bReversing = false;
+            av_log(nullptr, AV_LOG_INFO, "reverse playback ended at %.3f\n", fPos);
+            StreamSeek((int64_t)(fPos * AV_TIME_BASE), 0, 0, true);
+        }
+        return false;
+    }
+
+    CYSeekTarget objSeek;
+    if (m_ptrContext->objSeekReq.Take(&objSeek) && !objSeek.bByBytes)
+    {
+        /* the picture at the target is the first shown */
+        StartReverse(objSeek.nPos / (double)AV_TIME_BASE + REVERSE_PTS_EPSILON);
+    }
+    else if (!bReversing)
+    {
+        /* the picture on screen is not shown again */
+        double fPos = m_ptrContext->vidclk.m_fPTS;
+        if (isnan(fPos))
+            fPos = m_ptrContext->extclk.GetClock();
+        if (isnan(fPos))
+            return false;
+        StartReverse(fPos - REVERSE_PTS_EPSILON);
+    }
+    if (bStepBack)
+        StepToNextFrame();
+    return true;
+}
+
+/* the reverse run reads the item fEnd is in: in the tail on screen, the item read before the current one,
+ * which reading goes back to first, as for a seek there, so that its input and offset are the demuxer's */
+void CYDemuxFilter::StartReverse(double fEnd)
+{
+    CYTimelineItem objItem;
+    int nWhere = m_ptrContext->objTimeline.Locate((int64_t)(fEnd * AV_TIME_BASE), &objItem);
+    if (nWhere != CYItemTimeline::ITEM_READ && !(nWhere == CYItemTimeline::ITEM_PREVIOUS && ReturnToItem(objItem)))
+    {
+        /* the item on screen is closed, reversing starts where the item being read does */
+        av_log(nullptr, AV_LOG_WARNING, "reverse playback from %.3f is in a playlist item that is closed\n", fEnd);
+        fEnd = FFMAX(fEnd, m_ptrContext->objTimeline.Read().nStart / (double)AV_TIME_BASE);
+    }
+
+    if (m_ptrContext->nAudioStreamIndex >= 0)
+        m_ptrContext->ptrAudioQueue->Flush();
+    if (m_ptrContext->nSubtitleStreamIndex >= 0)
+        m_ptrContext->ptrSubTitleQueue->Flush();
+    m_ptrContext->ptrVideoQueue->Flush();
+    m_ptrContext->objSeekReq.ClearDecodeTarget();
+    m_ptrContext->extclk.SetClock(fEnd, m_ptrContext->extclk.m_fSerial);
+    m_ptrContext->bReversing = true;
+    m_ptrContext->bEof = false;
+
+    av_log(nullptr, AV_LOG_INFO, "reverse playback from %.3f\n", fEnd);
+    m_objReverse.Start(m_ptrContext, fEnd, m_nItemOffset / (double)AV_TIME_BASE);
+}
+
 void CYDemuxFilter::StreamTogglePause()
 {
     if (m_ptrContext->bPaused)
@@ -688,59 +1472,171 @@ void CYDemuxFilter::StepToNextFrame()
 int CYDemuxFilter::StreamHasEnoughPackets(AVStream* st, int stream_id, std::shared_ptr<CYPacketQueue>& ptrQueue)
 {
     return stream_id < 0 || ptrQueue->bAbortRequest || (st->disposition & AV_DISPOSITION_ATTACHED_PIC) ||
-        ptrQueue->nb_packets > MIN_FRAMES && (!ptrQueue->duration || av_q2d(st->time_base) * ptrQueue->duration > 1.0);
+        st->discard == AVDISCARD_ALL || ptrQueue->AboveHighWatermark();
 }
 
-/* seek in the stream */
-void CYDemuxFilter::StreamSeek(int64_t pos, int64_t rel, int by_bytes)
+/* arm the low watermark of every queue that is being read, returns false when one is already drained */
+bool CYDemuxFilter::ArmReadWakeup(bool bBytesFull, bool bEnoughPackets)
 {
-    if (!m_ptrContext->bSeekReq)
+    struct
     {
-        m_ptrContext->nSeekPos = pos;
-        m_ptrContext->nSeekRel = rel;
-        m_ptrContext->nSeekFlags &= ~AVSEEK_FLAG_BYTE;
-        if (by_bytes)
-            m_ptrContext->nSeekFlags |= AVSEEK_FLAG_BYTE;
-        m_ptrContext->bSeekReq = true;
-        m_ptrContext->ptrReadCond->NotifyOne();
+        AVStream* st;
+        int nStreamIndex;
+        SharePtr<CYPacketQueue>& ptrQueue;
+    } arrQueue[] = {
+        { m_ptrContext->pAudioStream, m_ptrContext->nAudioStreamIndex, m_ptrContext->ptrAudioQueue },
+        { m_ptrContext->pVideoStream, m_ptrContext->nVideoStreamIndex, m_ptrContext->ptrVideoQueue },
+        { m_ptrContext->pSubTitleStream, m_ptrContext->nSubtitleStreamIndex, m_ptrContext->ptrSubTitleQueue },
+    };
+
+    /* bytes that have to be consumed before reading resumes, any single queue may release them */
+    int nExcess = m_ptrContext->ptrAudioQueue->Size() + m_ptrContext->ptrVideoQueue->Size() + m_ptrContext->ptrSubTitleQueue->Size() - (int)(m_nReadAheadLimit / 4 * 3);
+
+    for (auto& objQueue : arrQueue)
+    {
+        if (objQueue.nStreamIndex < 0 || !objQueue.st || objQueue.ptrQueue->bAbortRequest || objQueue.st->discard == AVDISCARD_ALL)
+            continue;
+
+        int nWakePackets = -1;
+        int64_t nWakeDuration = -1;
+        int nWakeBytes = -1;
+
+        if (objQueue.ptrQueue->Full())
+        {
+            nWakePackets = objQueue.ptrQueue->Capacity() / 2;
+        }
+        else if (bEnoughPackets && !bBytesFull && !(objQueue.st->disposition & AV_DISPOSITION_ATTACHED_PIC))
+        {
+            nWakePackets = objQueue.ptrQueue->GetWatermark().nLowPackets;
+            nWakeDuration = objQueue.ptrQueue->GetWatermark().nLowDuration - 1;
+        }
+        if (bBytesFull)
+            nWakeBytes = objQueue.ptrQueue->Size() - nExcess;
+
+        if (!objQueue.ptrQueue->ArmLowWatermark(nWakePackets, nWakeDuration, nWakeBytes))
+            return false;
     }
+    return true;
+}
+
+/* serve a seek from the queued packets when every open stream already holds data up to nTarget:
+ * the queues drop what lies before the keyframe at or before it and continue under a new serial,
+ * the demuxer keeps reading where it was. false falls back to a real seek, which flushes anyway. */
+bool CYDemuxFilter::SeekInBuffer(int64_t nTarget)
+{
+    bool bVideo = m_ptrContext->pVideoStream && !(m_ptrContext->pVideoStream->disposition & AV_DISPOSITION_ATTACHED_PIC);
+    if (!bVideo && !m_ptrContext->pAudioStream)
+        return false;
+
+    if (bVideo && !m_ptrContext->ptrVideoQueue->SeekWithin(av_rescale_q(nTarget, AV_TIME_BASE_Q, m_ptrContext->pVideoStream->time_base)))
+        return false;
+    if (m_ptrContext->pAudioStream && !m_ptrContext->ptrAudioQueue->SeekWithin(av_rescale_q(nTarget, AV_TIME_BASE_Q, m_ptrContext->pAudioStream->time_base)))
+        return false;
+    /* subtitles are sparse, a queue without one before the target is kept as it is */
+    if (m_ptrContext->pSubTitleStream)
+        m_ptrContext->ptrSubTitleQueue->SeekWithin(av_rescale_q(nTarget, AV_TIME_BASE_Q, m_ptrContext->pSubTitleStream->time_base));
+    return true;
+}
+
+/* tell the decoders which serials the seek just executed restarted and where an accurate one lands,
+ * and the renderer which frame ends it */
+void CYDemuxFilter::SetSeekDecodeTarget(const CYSeekTarget& objSeek)
+{
+    int nVideoSerial = m_ptrContext->nVideoStreamIndex >= 0 ? m_ptrContext->ptrVideoQueue->serial : -1;
+    int nAudioSerial = m_ptrContext->nAudioStreamIndex >= 0 ? m_ptrContext->ptrAudioQueue->serial : -1;
+    m_ptrContext->objSeekReq.SetDecodeTarget(m_ptrContext->bAccurate ? m_ptrContext->nSeekPos : INT64_MIN,
+        nVideoSerial, nAudioSerial, objSeek.nGeneration);
+    if (m_ptrContext->pVideoStream && !(m_ptrContext->pVideoStream->disposition & AV_DISPOSITION_ATTACHED_PIC))
+        m_ptrContext->objSeekReq.WatchDisplay(nVideoSerial, objSeek.nRequestTime);
+}
+
+/* seek in the stream, a newer request replaces one the demux thread has not started yet */
+void CYDemuxFilter::StreamSeek(int64_t pos, int64_t rel, int by_bytes, bool bAccurate)
+{
+    m_ptrContext->objSeekReq.Post(pos, rel, !!by_bytes, bAccurate);
+    m_ptrContext->ptrReadCond->NotifyOne();
 }
 
 int64_t CYDemuxFilter::GetDuration() const
 {
-    return m_ptrContext->nFileDuration;
+    return m_ptrContext->objTimeline.Duration();
 }
 
 int64_t CYDemuxFilter::GetPosition() const
 {
-    return m_ptrContext->extclk.m_fPTS * 1000;
+    return m_ptrContext->extclk.m_fPTS * 1000 - m_ptrContext->objTimeline.Offset() / 1000;
 }
 
 int16_t CYDemuxFilter::Seek(int64_t nTimestamp)
 {
     m_ptrParam->nSeekByBytes = 0;
-    m_ptrContext->bAccurate = true;
-    double fPos = (double)nTimestamp / 1000.0;
-    if (m_ptrContext->ptrIC->start_time != AV_NOPTS_VALUE)
-    {
-        double fStartTimeSec = (double)m_ptrContext->ptrIC->start_time / AV_TIME_BASE;
-        if (fPos < fStartTimeSec)
-            fPos = fStartTimeSec;
-    }
 
-    int64_t nSeekTargetUS = (int64_t)(fPos * AV_TIME_BASE);
+    int64_t nSeekTargetUS = m_ptrContext->objTimeline.SeekTarget(nTimestamp);
     int64_t nIncrUS = (int64_t)(5 * AV_TIME_BASE);
 
     nIncrUS = 1;
 
-    StreamSeek(nSeekTargetUS, nIncrUS, 0);
+    StreamSeek(nSeekTargetUS, nIncrUS, 0, true);
+
+    return ERR_SUCESS;
+}
+
+/* the decoders keep only keyframes and the audio output is muted until EndScrub */
+int16_t CYDemuxFilter::BeginScrub(bool bLowQuality)
+{
+    m_nScrubTarget = -1;
+    m_ptrContext->nScrubMode = bLowQuality ? SCRUB_MODE_KEYFRAMES_FAST : SCRUB_MODE_KEYFRAMES;
+    return ERR_SUCESS;
+}
+
+/* seek to whichever keyframe is closest, no decoding up to the exact position */
+int16_t CYDemuxFilter::ScrubTo(int64_t nTimestamp)
+{
+    m_ptrParam->nSeekByBytes = 0;
+    m_nScrubTarget = m_ptrContext->objTimeline.SeekTarget(nTimestamp);
+    StreamSeek(m_nScrubTarget, 0, 0, false);
+    return ERR_SUCESS;
+}
+
+/* back to full decoding, and one accurate seek to where the scrub was released */
+int16_t CYDemuxFilter::EndScrub()
+{
+    m_ptrContext->nScrubMode = SCRUB_MODE_NONE;
+    if (m_nScrubTarget >= 0)
+        StreamSeek(m_nScrubTarget, 1, 0, true);
+    m_nScrubTarget = -1;
+    return ERR_SUCESS;
+}
+
+bool CYDemuxFilter::IsScrubbing() const
+{
+    return m_ptrContext && m_ptrContext->nScrubMode != SCRUB_MODE_NONE;
+}
 
+/* the speed is picked up by the demux thread, see ApplyTrickPlay */
+int16_t CYDemuxFilter::SetSpeed(float fSpeed)
+{
+    m_ptrContext->fPlaybackSpeed = fSpeed;
+    m_ptrContext->nTrickMode = TrickMode(fSpeed);
+    if (m_ptrContext->ptrReadCond)
+        m_ptrContext->ptrReadCond->NotifyOne();
+    return ERR_SUCESS;
+}
+
+/* taken by the demux thread, see ApplyReverse */
+int16_t CYDemuxFilter::StepBack()
+{
+    m_ptrContext->nStepBackReq++;
+    if (m_ptrContext->ptrReadCond)
+        m_ptrContext->ptrReadCond->NotifyOne();
     return ERR_SUCESS;
 }
 
 int16_t CYDemuxFilter::SetLoop(bool bLoop)
 {
     m_ptrContext->bLoop = bLoop;
+    if (m_ptrContext->ptrReadCond)
+        m_ptrContext->ptrReadCond->NotifyOne();
     return ERR_SUCESS;
 }
 
@@ -45,6 +45,9 @@
 #define __CY_DEMUX_FILTER_HPP__
 
 #include "ChainFilter/Common/CYBaseFilter.hpp"
+#include "ChainFilter/Common/CYKeyframeIndex.hpp"
+#include "ChainFilter/Common/CYMediaPreloader.hpp"
+#include "ChainFilter/Common/CYReversePlayback.hpp"
 
 CYPLAYER_NAMESPACE_BEGIN
 
@@ -72,6 +75,13 @@ public:
 
     virtual int16_t Seek(int64_t nTimestamp);
     virtual int16_t SetLoop(bool bLoop);
+    virtual int16_t SetSpeed(float fSpeed);
+    virtual int16_t StepBack();
+
+    virtual int16_t BeginScrub(bool bLowQuality);
+    virtual int16_t ScrubTo(int64_t nTimestamp);
+    virtual int16_t EndScrub();
+    bool IsScrubbing() const;
 
 private:
     void OnEntry();
@@ -79,7 +89,23 @@ private:
     void StreamTogglePause();
     void StepToNextFrame();
     int  StreamHasEnoughPackets(AVStream* st, int stream_id, std::shared_ptr<CYPacketQueue>& ptrQueue);
-    void StreamSeek(int64_t pos, int64_t rel, int by_bytes);
+    bool ArmReadWakeup(bool bBytesFull, bool bEnoughPackets);
+    void StreamSeek(int64_t pos, int64_t rel, int by_bytes, bool bAccurate);
+    bool SeekInBuffer(int64_t nTarget);
+    void SetSeekDecodeTarget(const CYSeekTarget& objSeek);
+    void InitKeyframeIndex(AVFormatContext* pIC, const char* pszURL);
+    void PreloadNextItem();
+    bool SwitchToNextItem();
+    bool LoopToStart(AVFormatContext* pIC);
+    void RetireItem();
+    bool ReturnToItem(const CYTimelineItem& objItem);
+    void ApplyTrickPlay(AVFormatContext* pIC);
+    bool SkipTrickPlayPacket(AVFormatContext* pIC, const AVPacket* pPkt);
+    bool ApplyReverse();
+    void StartReverse(double fEnd);
+    bool ItemSwitched() const;
+    void TrackItemEnd(const AVPacket* pPkt, AVStream* st);
+    void ReportItemError(const std::string& strURL, const char* pszReason);
 
 private:
     std::atomic_bool m_bRunning = false;
@@ -89,6 +115,40 @@ private:
     const char* m_pszWindowTitle = nullptr;
     SharePtr<EPlayerParam> m_ptrParam;
     SharePtr<CYMediaContext> m_ptrContext;
+
+    /* packet bytes the memory account allows right now, re-read every loop */
+    int64_t m_nReadAheadLimit = MAX_QUEUE_SIZE;
+
+    /* keyframe byte offsets learnt while reading; linked while nothing was skipped since the last one */
+    CYKeyframeIndex m_objKeyIndex;
+    bool m_bIndexLinked = false;
+    /* the format resyncs after a byte seek, so the index seeks by byte offset */
+    bool m_bIndexByteSeek = false;
+
+    /* last ScrubTo position in AV_TIME_BASE, where EndScrub lands; -1 before the first one */
+    int64_t m_nScrubTarget = -1;
+
+    /* trick play as this thread last set it up: the speed, the file whose streams it discards, and in
+       keyframe mode the next position wanted, the last keyframe read and the keyframe spacing (AV_TIME_BASE) */
+    double m_fTrickSpeed = 1.0;
+    int m_nTrickMode = TRICK_MODE_NONE;
+    AVFormatContext* m_pTrickIC = nullptr;
+    int64_t m_nTrickNext = AV_NOPTS_VALUE;
+    int64_t m_nTrickLastKey = AV_NOPTS_VALUE;
+    int64_t m_nTrickKeyGap = 0;
+
+    /* reverse playback and step-back, the demuxer does not read while it runs */
+    CYReversePlayback m_objReverse;
+
+    /* gapless playlist: the next item opening in the background, the number of the item being read
+       (tagged on its packets), the AV_TIME_BASE offset that puts its timestamps after the previous
+       item, and the end of what was read of it on that timeline */
+    CYMediaPreloader m_objPreloader;
+    int m_nItem = 0;
+    std::atomic<int64_t> m_nItemOffset{ 0 };
+    int64_t m_nItemEnd = AV_NOPTS_VALUE;
+    /* the item cannot seek back to its start without draining, so it loops the slow way */
+    bool m_bLoopSeekFailed = false;
 };
 
 CYPLAYER_NAMESPACE_END
@@ -1,4 +1,5 @@
 #include "ChainFilter/RenderFilter/CYAudioRenderFilter.hpp"
+#include "ChainFilter/Common/CYAudioFilters.hpp"
 
 CYPLAYER_NAMESPACE_BEGIN
 
@@ -59,11 +60,6 @@ int16_t CYAudioRenderFilter::ProcessFrame(SharePtr<CYMediaContext>& ptrContext,
     return CYBaseFilter::ProcessFrame(ptrContext, ptrFrame);
 }
 
-int16_t CYAudioRenderFilter::SetSpeed(float fSpeed)
-{
-    return ERR_SUCESS;
-}
-
 int16_t CYAudioRenderFilter::SetVolume(float fVolume)
 {
     m_ptrContext->nAudioVolume = av_clip(fVolume * SDL_MIX_MAXVOLUME, 0, SDL_MIX_MAXVOLUME);
@@ -87,7 +83,7 @@ static void UpdateSampleDisplay(SharePtr<CYMediaContext>& ptrContext, short* sam
         nLen = SAMPLE_ARRAY_SIZE - ptrContext->nSampleArrayIndex;
         if (nLen > nSize)
             nLen = nSize;
-        memcpy(ptrContext->arraySample + ptrContext->nSampleArrayIndex, samples, nLen * sizeof(short));
+        memcpy(ptrContext->ptrSampleArray.get() + ptrContext->nSampleArrayIndex, samples, nLen * sizeof(short));
         samples += nLen;
         ptrContext->nSampleArrayIndex += nLen;
         if (ptrContext->nSampleArrayIndex >= SAMPLE_ARRAY_SIZE)
@@ -121,7 +117,7 @@ void SDLAudioCallback(void* pOpaque, Uint8* stream, int nLen)
             }
             else
             {
-                if (ptrContext->eShowMode != SHOW_MODE_VIDEO)
+                if (ptrContext->bAudioDisplay.load(std::memory_order_acquire))
                     UpdateSampleDisplay(ptrContext, (int16_t*)ptrContext->ptrAudioBuffer.get(), nAudioSize);
                 ptrContext->nAudioBufSize = nAudioSize;
             }
@@ -130,12 +126,15 @@ void SDLAudioCallback(void* pOpaque, Uint8* stream, int nLen)
         nLen1 = ptrContext->nAudioBufSize - ptrContext->nAudioBufIndex;
         if (nLen1 > nLen)
             nLen1 = nLen;
-        if (!ptrContext->bMuted && ptrContext->ptrAudioBuffer && ptrContext->nAudioVolume == SDL_MIX_MAXVOLUME)
+        /* scrubbing previews keyframes only, the audio in between is not worth hearing, nor is it
+           backwards or above the fastest trick play speed it is stretched for */
+        bool bSilent = ptrContext->bMuted || ptrContext->nScrubMode != SCRUB_MODE_NONE || ptrContext->fPlaybackSpeed != AudioTempo(ptrContext);
+        if (!bSilent && ptrContext->ptrAudioBuffer && ptrContext->nAudioVolume == SDL_MIX_MAXVOLUME)
             memcpy(stream, (uint8_t*)ptrContext->ptrAudioBuffer.get() + ptrContext->nAudioBufIndex, nLen1);
         else
         {
             memset(stream, 0, nLen1);
-            if (!ptrContext->bMuted && ptrContext->ptrAudioBuffer)
+            if (!bSilent && ptrContext->ptrAudioBuffer)
                 SDL_MixAudioFormat(stream, (uint8_t*)ptrContext->ptrAudioBuffer.get() + ptrContext->nAudioBufIndex, AUDIO_S16SYS, nLen1, ptrContext->nAudioVolume);
         }
         nLen -= nLen1;
@@ -146,7 +145,7 @@ void SDLAudioCallback(void* pOpaque, Uint8* stream, int nLen)
     /* Let's assume the audio driver that is used by SDL has two periods. */
     if (!isnan(ptrContext->fAudioClock))
     {
-        ptrContext->audclk.SetClockAt(ptrContext->fAudioClock - (double)(2 * ptrContext->nAudioHWBufSize + ptrContext->nAudioWriteBufSize) / ptrContext->objAudioTgt.bytes_per_sec, ptrContext->nAudioClockSerial, ptrContext->nAudioCallbackTime / 1000000.0);
+        ptrContext->audclk.SetClockAt(ptrContext->fAudioClock - (double)(2 * ptrContext->nAudioHWBufSize + ptrContext->nAudioWriteBufSize) / ptrContext->objAudioTgt.bytes_per_sec * AudioTempo(ptrContext), ptrContext->nAudioClockSerial, ptrContext->nAudioCallbackTime / 1000000.0);
         ptrContext->extclk.SyncClockToSlave(ptrContext->audclk);
     }
 }
@@ -69,8 +69,6 @@ public:
     virtual int16_t ProcessPacket(SharePtr<CYMediaContext>& ptrContext, AVPacketPtr& ptrPacket) override;
     virtual int16_t ProcessFrame(SharePtr<CYMediaContext>& ptrContext, AVFramePtr& ptrFrame) override;
 
-    virtual int16_t SetSpeed(float fSpeed);
-
     virtual int16_t SetVolume(float fVolume);
     virtual float GetVolume();
 
@@ -172,6 +172,10 @@ int16_t CYVideoRenderFilter::Resume()
     {
         StreamTogglePause(m_ptrContext);
     }
+    /* like the pause key, resuming ends stepping (and stepping back), which the demuxer may be waiting for */
+    m_ptrContext->bStep = false;
+    if (m_ptrContext->ptrReadCond)
+        m_ptrContext->ptrReadCond->NotifyOne();
     return CYBaseFilter::Resume();
 }
 
@@ -393,6 +397,9 @@ int16_t CYVideoRenderFilter::SetMute(bool bMute)
 
 int CYVideoRenderFilter::GetMasterSyncType(SharePtr<CYMediaContext>& ptrContext)
 {
+    /* away from 1x everything follows the external clock, which runs at the playback speed */
+    if (ptrContext->fPlaybackSpeed != 1.0)
+        return TYPE_SYNC_CLOCK_EXTERNAL;
     if (ptrContext->nAVSyncType == TYPE_SYNC_CLOCK_VIDEO)
     {
         if (ptrContext->pVideoStream)
@@ -415,13 +422,15 @@ int CYVideoRenderFilter::GetMasterSyncType(SharePtr<CYMediaContext>& ptrContext)
 
 void CYVideoRenderFilter::CheckExternalClockSpeed(SharePtr<CYMediaContext>& ptrContext)
 {
-    if (ptrContext->nVideoStreamIndex >= 0 && ptrContext->ptrVideoQueue->nb_packets <= EXTERNAL_CLOCK_MIN_FRAMES ||
-        ptrContext->nAudioStreamIndex >= 0 && ptrContext->ptrAudioQueue->nb_packets <= EXTERNAL_CLOCK_MIN_FRAMES)
+    int nVideoPackets = ptrContext->ptrVideoQueue->NbPackets();
+    int nAudioPackets = ptrContext->ptrAudioQueue->NbPackets();
+    if (ptrContext->nVideoStreamIndex >= 0 && nVideoPackets <= EXTERNAL_CLOCK_MIN_FRAMES ||
+        ptrContext->nAudioStreamIndex >= 0 && nAudioPackets <= EXTERNAL_CLOCK_MIN_FRAMES)
     {
         ptrContext->extclk.SetClockSpeed(FFMAX(EXTERNAL_CLOCK_SPEED_MIN, ptrContext->extclk.m_fSpeed - EXTERNAL_CLOCK_SPEED_STEP));
     }
-    else if ((ptrContext->nVideoStreamIndex < 0 || ptrContext->ptrVideoQueue->nb_packets > EXTERNAL_CLOCK_MAX_FRAMES) &&
-        (ptrContext->nAudioStreamIndex < 0 || ptrContext->ptrAudioQueue->nb_packets > EXTERNAL_CLOCK_MAX_FRAMES))
+    else if ((ptrContext->nVideoStreamIndex < 0 || nVideoPackets > EXTERNAL_CLOCK_MAX_FRAMES) &&
+        (ptrContext->nAudioStreamIndex < 0 || nAudioPackets > EXTERNAL_CLOCK_MAX_FRAMES))
     {
         ptrContext->extclk.SetClockSpeed(FFMIN(EXTERNAL_CLOCK_SPEED_MAX, ptrContext->extclk.m_fSpeed + EXTERNAL_CLOCK_SPEED_STEP));
     }
@@ -474,6 +483,37 @@ void CYVideoRenderFilter::FillRectangle(int x, int y, int w, int h)
         SDL_RenderFillRect(m_ptrContext->ptrRenderer.get(), &rect);
 }
 
+/* the memory charge tracking one of the context's textures */
+CYMemoryCharge* CYVideoRenderFilter::TextureCharge(SDL_Texture** pTexture)
+{
+    if (pTexture == &m_ptrContext->vid_texture)
+        return &m_ptrContext->objVidTextureMem;
+    if (pTexture == &m_ptrContext->sub_texture)
+        return &m_ptrContext->objSubTextureMem;
+    if (pTexture == &m_ptrContext->vis_texture)
+        return &m_ptrContext->objVisTextureMem;
+    return nullptr;
+}
+
+/* estimated backing store of a streaming texture, drivers may pad it further */
+int64_t CYVideoRenderFilter::TextureBytes(Uint32 nFormat, int nWidth, int nHeight)
+{
+    switch (nFormat)
+    {
+    case SDL_PIXELFORMAT_IYUV:
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        return (int64_t)nWidth * nHeight * 3 / 2;
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        return (int64_t)nWidth * nHeight * 2;
+    default:
+        return (int64_t)nWidth * nHeight * SDL_BYTESPERPIXEL(nFormat);
+    }
+}
+
 int CYVideoRenderFilter::ReallocTexture(SDL_Texture** pTexture, Uint32 nNewFormat, int nNewWidth, int nNewHeight, SDL_BlendMode eBlendMode, int nInitTexture)
 {
     Uint32 format;
@@ -482,10 +522,15 @@ int CYVideoRenderFilter::ReallocTexture(SDL_Texture** pTexture, Uint32 nNewForma
     {
         void* pixels;
         int pitch;
+        CYMemoryCharge* pCharge = TextureCharge(pTexture);
         if (*pTexture)
             SDL_DestroyTexture(*pTexture);
+        if (pCharge)
+            pCharge->Set(0);
         if (!(*pTexture = SDL_CreateTexture(m_ptrContext->ptrRenderer.get(), nNewFormat, SDL_TEXTUREACCESS_STREAMING, nNewWidth, nNewHeight)))
             return -1;
+        if (pCharge)
+            pCharge->Set(TextureBytes(nNewFormat, nNewWidth, nNewHeight));
         if (SDL_SetTextureBlendMode(*pTexture, eBlendMode) < 0)
             return -1;
         if (nInitTexture)
@@ -500,6 +545,46 @@ int CYVideoRenderFilter::ReallocTexture(SDL_Texture** pTexture, Uint32 nNewForma
     return 0;
 }
 
+/* allocate the sample ring on first use and let the audio callback start filling it */
+static int AllocAudioDisplay(SharePtr<CYMediaContext>& ptrContext)
+{
+    if (ptrContext->ptrSampleArray)
+        return 0;
+
+    ptrContext->ptrSampleArray.reset((int16_t*)av_calloc(SAMPLE_ARRAY_SIZE, sizeof(int16_t)));
+    if (!ptrContext->ptrSampleArray)
+        return AVERROR(ENOMEM);
+    ptrContext->objSampleArrayMem.Set(SAMPLE_ARRAY_SIZE * sizeof(int16_t));
+    ptrContext->nSampleArrayIndex = 0;
+    ptrContext->bAudioDisplay.store(true, std::memory_order_release);
+    return 0;
+}
+
+/* drop the sample ring, RDFT buffers and vis texture once nothing shows them */
+static void FreeAudioDisplay(SharePtr<CYMediaContext>& ptrContext)
+{
+    /* the audio callback may be copying into the ring right now */
+    SDL_LockAudioDevice(ptrContext->hAudioDev);
+    ptrContext->bAudioDisplay = false;
+    ptrContext->ptrSampleArray.reset();
+    SDL_UnlockAudioDevice(ptrContext->hAudioDev);
+    ptrContext->objSampleArrayMem.Set(0);
+
+    if (ptrContext->pRdftContext)
+        av_tx_uninit(&ptrContext->pRdftContext);
+    av_freep(&ptrContext->pfRealData);
+    av_freep(&ptrContext->pRdftData);
+    ptrContext->pRdftContext = nullptr;
+    ptrContext->nRdftBits = 0;
+
+    if (ptrContext->vis_texture)
+    {
+        SDL_DestroyTexture(ptrContext->vis_texture);
+        ptrContext->vis_texture = nullptr;
+    }
+    ptrContext->objVisTextureMem.Set(0);
+}
+
 void CYVideoRenderFilter::VideoAudioDisplay(SharePtr<CYMediaContext>& ptrContext)
 {
     int i, i_start, x, y1, y, ys, delay, n, nb_display_channels;
@@ -507,6 +592,10 @@ void CYVideoRenderFilter::VideoAudioDisplay(SharePtr<CYMediaContext>& ptrContext
     int64_t time_diff;
     int nRdftBits, nb_freq;
 
+    if (AllocAudioDisplay(ptrContext) < 0)
+        return;
+    const int16_t* pSamples = ptrContext->ptrSampleArray.get();
+
     for (nRdftBits = 1; (1 << nRdftBits) < 2 * ptrContext->nShowHeight; nRdftBits++)
         ;
     nb_freq = 1 << (nRdftBits - 1);
@@ -540,10 +629,10 @@ void CYVideoRenderFilter::VideoAudioDisplay(SharePtr<CYMediaContext>& ptrContext
             for (i = 0; i < 1000; i += channels)
             {
                 int idx = (SAMPLE_ARRAY_SIZE + x - i) % SAMPLE_ARRAY_SIZE;
-                int a = ptrContext->arraySample[idx];
-                int b = ptrContext->arraySample[(idx + 4 * channels) % SAMPLE_ARRAY_SIZE];
-                int c = ptrContext->arraySample[(idx + 5 * channels) % SAMPLE_ARRAY_SIZE];
-                int d = ptrContext->arraySample[(idx + 9 * channels) % SAMPLE_ARRAY_SIZE];
+                int a = pSamples[idx];
+                int b = pSamples[(idx + 4 * channels) % SAMPLE_ARRAY_SIZE];
+                int c = pSamples[(idx + 5 * channels) % SAMPLE_ARRAY_SIZE];
+                int d = pSamples[(idx + 9 * channels) % SAMPLE_ARRAY_SIZE];
                 int score = a - d;
                 if (h < score && (b ^ c) < 0)
                 {
@@ -574,7 +663,7 @@ void CYVideoRenderFilter::VideoAudioDisplay(SharePtr<CYMediaContext>& ptrContext
             y1 = ptrContext->nShowYTop + ch * h + (h / 2); /* position of center line */
             for (x = 0; x < ptrContext->nShowWidth; x++)
             {
-                y = (ptrContext->arraySample[i] * h2) >> 15;
+                y = (pSamples[i] * h2) >> 15;
                 if (y < 0)
                 {
                     y = -y;
@@ -640,7 +729,7 @@ void CYVideoRenderFilter::VideoAudioDisplay(SharePtr<CYMediaContext>& ptrContext
                 for (x = 0; x < 2 * nb_freq; x++)
                 {
                     double w = (x - nb_freq) * (1.0 / nb_freq);
-                    data_in[ch][x] = ptrContext->arraySample[i] * (1.0 - w * w);
+                    data_in[ch][x] = pSamples[i] * (1.0 - w * w);
                     i += channels;
                     if (i >= SAMPLE_ARRAY_SIZE)
                         i -= SAMPLE_ARRAY_SIZE;
@@ -894,9 +983,38 @@ void CYVideoRenderFilter::VideoImageDisplay(SharePtr<CYMediaContext>& ptrContext
     }
 }
 
+/* the first frame of a seek reached the screen: log and report how long it took */
+static void ReportSeekLatency(SharePtr<CYMediaContext>& ptrContext, int nSerial)
+{
+    int64_t nLatency = ptrContext->objSeekReq.FrameDisplayed(nSerial);
+    if (nLatency < 0)
+        return;
+
+    av_log(nullptr, AV_LOG_INFO, "seek to first displayed frame: %.1f ms\n", nLatency / 1000.0);
+    if (ptrContext->funEventCallBack)
+    {
+        EPlayerEventInfo objEvent = {};
+        objEvent.eEventType = TYPE_EVENT_SEEK_COMPLETED;
+        objEvent.fSeekLatency = nLatency / 1000.0;
+        ptrContext->funEventCallBack(&objEvent);
+    }
+}
+
+/* playback reached the first frame of the next playlist item: positions and the duration follow it */
+static void ReportItemChange(SharePtr<CYMediaContext>& ptrContext, double fClock)
+{
+    if (ptrContext->objTimeline.Present(fClock) && ptrContext->funEventCallBack)
+    {
+        EPlayerEventInfo objEvent = {};
+        objEvent.eEventType = TYPE_EVENT_MEDIA_CHANGED;
+        ptrContext->funEventCallBack(&objEvent);
+    }
+}
+
 /* display the current picture, if any */
 void CYVideoRenderFilter::VideoDisplay(SharePtr<CYMediaContext>& ptrContext)
 {
+    bool bImage = false;
     if (!ptrContext->nShowWidth)
         VideoOpen(ptrContext);
 
@@ -905,19 +1023,27 @@ void CYVideoRenderFilter::VideoDisplay(SharePtr<CYMediaContext>& ptrContext)
     if (ptrContext->pAudioStream && ptrContext->eShowMode != SHOW_MODE_VIDEO)
         VideoAudioDisplay(ptrContext);
     else if (ptrContext->pVideoStream)
+    {
         VideoImageDisplay(ptrContext);
+        bImage = true;
+    }
     SDL_RenderPresent(ptrContext->ptrRenderer.get());
+    if (bImage)
+        ReportSeekLatency(ptrContext, ptrContext->pictq.PeekLast()->serial);
 }
 
+/* wall-clock time pVP stays on screen, its timestamp distance to pNextVP at the playback speed;
+ * in reverse playback pNextVP is the earlier picture */
 double CYVideoRenderFilter::VPDuration(SharePtr<CYMediaContext>& ptrContext, CYFrame* pVP, CYFrame* pNextVP)
 {
+    double fSpeed = ptrContext->fPlaybackSpeed;
     if (pVP->serial == pNextVP->serial)
     {
-        double duration = pNextVP->pts - pVP->pts;
+        double duration = ptrContext->bReversing ? pVP->pts - pNextVP->pts : pNextVP->pts - pVP->pts;
         if (isnan(duration) || duration <= 0 || duration > ptrContext->fMaxFrameDuration)
-            return pVP->duration;
+            return pVP->duration / fabs(fSpeed);
         else
-            return duration;
+            return duration / fabs(fSpeed);
     }
     else
     {
@@ -984,7 +1110,11 @@ void CYVideoRenderFilter::UpdateVideoPTS(SharePtr<CYMediaContext>& ptrContext, d
     //set_clock(&ptrContext->vidclk, pts, serial);
     ptrContext->vidclk.SetClock(fPts, nSerial);
     //sync_clock_to_slave(&ptrContext->extclk, &ptrContext->vidclk);
-    ptrContext->extclk.SyncClockToSlave(ptrContext->vidclk);
+    /* reverse pictures are paced by their durations alone, the position follows the one on screen */
+    if (ptrContext->bReversing)
+        ptrContext->extclk.SetClock(fPts, ptrContext->extclk.m_fSerial);
+    else
+        ptrContext->extclk.SyncClockToSlave(ptrContext->vidclk);
 }
 
 void CYVideoRenderFilter::StreamTogglePause(SharePtr<CYMediaContext>& ptrContext)
@@ -1011,7 +1141,7 @@ void CYVideoRenderFilter::VideoRefresh(double* pfRemainingTime)
 
     CYFrame* sp, * sp2;
 
-    if (!m_ptrContext->bPaused && GetMasterSyncType(m_ptrContext) == TYPE_SYNC_CLOCK_EXTERNAL && m_ptrContext->bRealTime)
+    if (!m_ptrContext->bPaused && GetMasterSyncType(m_ptrContext) == TYPE_SYNC_CLOCK_EXTERNAL && m_ptrContext->bRealTime && m_ptrContext->fPlaybackSpeed == 1.0)
         CheckExternalClockSpeed(m_ptrContext);
 
     if (!m_bDisableVideo && m_ptrContext->eShowMode != SHOW_MODE_VIDEO && m_ptrContext->pAudioStream)
@@ -1083,6 +1213,8 @@ void CYVideoRenderFilter::VideoRefresh(double* pfRemainingTime)
                 if (!m_ptrContext->bStep && (m_ptrParam->nFrameDrop > 0 || (m_ptrParam->nFrameDrop && GetMasterSyncType(m_ptrContext) != TYPE_SYNC_CLOCK_VIDEO)) && time > m_ptrContext->fFrameTimer + duration)
                 {
                     m_ptrContext->nFrameDropsLate++;
+                    m_ptrContext->pictq.ReportLateDrop();
+                    m_ptrContext->objQualityGovernor.ReportDrop();
                     m_ptrContext->pictq.Next();
                     goto retry;
                 }
@@ -1156,11 +1288,11 @@ void CYVideoRenderFilter::VideoRefresh(double* pfRemainingTime)
             vqsize = 0;
             sqsize = 0;
             if (m_ptrContext->pAudioStream)
-                aqsize = m_ptrContext->ptrAudioQueue->size;
+                aqsize = m_ptrContext->ptrAudioQueue->GetStats().nBytes;
             if (m_ptrContext->pVideoStream)
-                vqsize = m_ptrContext->ptrVideoQueue->size;
+                vqsize = m_ptrContext->ptrVideoQueue->GetStats().nBytes;
             if (m_ptrContext->pSubTitleStream)
-                sqsize = m_ptrContext->ptrSubTitleQueue->size;
+                sqsize = m_ptrContext->ptrSubTitleQueue->GetStats().nBytes;
             av_diff = 0;
             if (m_ptrContext->pAudioStream && m_ptrContext->pVideoStream)
             {
@@ -1177,11 +1309,12 @@ void CYVideoRenderFilter::VideoRefresh(double* pfRemainingTime)
 
             av_bprint_init(&buf, 0, AV_BPRINT_SIZE_AUTOMATIC);
             av_bprintf(&buf,
-                "%7.2f %s:%7.3f fd=%4d aq=%5dKB vq=%5dKB sq=%5dB \r",
+                "%7.2f %s:%7.3f fd=%4d (pkt %d early %d late %d) aq=%5dKB vq=%5dKB sq=%5dB \r",
                 GetMasterClock(m_ptrContext),
                 (m_ptrContext->pAudioStream && m_ptrContext->pVideoStream) ? "A-V" : (m_ptrContext->pVideoStream ? "M-V" : (m_ptrContext->pAudioStream ? "M-A" : "   ")),
                 av_diff,
-                m_ptrContext->nFrameDropsEarly + m_ptrContext->nFrameDropsLate,
+                m_ptrContext->nPacketDropsLate + m_ptrContext->nFrameDropsEarly + m_ptrContext->nFrameDropsLate,
+                m_ptrContext->nPacketDropsLate, m_ptrContext->nFrameDropsEarly, m_ptrContext->nFrameDropsLate,
                 aqsize / 1024,
                 vqsize / 1024,
                 sqsize);
@@ -1216,18 +1349,23 @@ void CYVideoRenderFilter::RefreshLoopWaitEvent(SharePtr<CYMediaContext>& ptrCont
         if (ptrContext->eShowMode != SHOW_MODE_NONE && (!ptrContext->bPaused || ptrContext->bForceRefresh))
             VideoRefresh(&pfRemainingTime);
 
+        if (m_ptrContext)
+            ReportItemChange(m_ptrContext, GetMasterClock(m_ptrContext));
+
         if (m_ptrContext && m_ptrContext->funPositionCallBack)
         {
+            int64_t nItemOffset = m_ptrContext->objTimeline.Offset();
+            int64_t nFileDuration = m_ptrContext->objTimeline.Duration();
             if (m_nLastMircoSecond == 0)
-                m_nLastMircoSecond = m_ptrContext->extclk.GetClock() * 1000;
+                m_nLastMircoSecond = m_ptrContext->extclk.GetClock() * 1000 - nItemOffset / 1000;
 
-            int64_t nMicroSecond = m_ptrContext->extclk.GetClock() * 1000;
+            int64_t nMicroSecond = m_ptrContext->extclk.GetClock() * 1000 - nItemOffset / 1000;
             if (nMicroSecond - m_nLastMircoSecond < 0)
             {
                 m_nLastMircoSecond = nMicroSecond;
             }
 
-            if (!m_bPlayOver && (abs(nMicroSecond - m_ptrContext->nFileDuration) <= 100) && m_ptrContext->bEof)
+            if (!m_bPlayOver && (abs(nMicroSecond - nFileDuration) <= 100) && m_ptrContext->bEof)
             {
                 m_bPlayOver = true;
                 if (m_ptrContext->funStateCallBack) m_ptrContext->funStateCallBack(TYPE_STATUS_COMPLETED);
@@ -1241,11 +1379,11 @@ void CYVideoRenderFilter::RefreshLoopWaitEvent(SharePtr<CYMediaContext>& ptrCont
             {
                 if (m_bPlayOver)
                 {
-                    m_ptrContext->funPositionCallBack(m_ptrContext->nFileDuration, m_ptrContext->nFileDuration);
+                    m_ptrContext->funPositionCallBack(nFileDuration, nFileDuration);
                 }
                 else
                 {
-                    m_ptrContext->funPositionCallBack(nMicroSecond > m_ptrContext->nFileDuration ? m_ptrContext->nFileDuration : nMicroSecond, m_ptrContext->nFileDuration);
+                    m_ptrContext->funPositionCallBack(nMicroSecond > nFileDuration ? nFileDuration : nMicroSecond, nFileDuration);
                 }
 
                 m_nLastMircoSecond = nMicroSecond;
@@ -1274,20 +1412,15 @@ void StreamComponentClose(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex
         //av_freep(&ptrContext->ptrAudioBuffer1);
         ptrContext->ptrAudioBuffer1.reset();
         ptrContext->nAudioBuf1Size = 0;
+        ptrContext->objAudioBufMem.Set(0);
         ptrContext->ptrAudioBuffer.get();
 
-        if (ptrContext->pRdftContext)
-        {
-            av_tx_uninit(&ptrContext->pRdftContext);
-            av_freep(&ptrContext->pfRealData);
-            av_freep(&ptrContext->pRdftData);
-            ptrContext->pRdftContext = nullptr;
-            ptrContext->nRdftBits = 0;
-        }
+        FreeAudioDisplay(ptrContext);
         break;
     case AVMEDIA_TYPE_VIDEO:
         ptrContext->viddec.Abort(ptrContext->pictq);
         ptrContext->viddec.Destroy();
+        ptrContext->objThreadLease.Release();
         break;
     case AVMEDIA_TYPE_SUBTITLE:
         ptrContext->subdec.Abort(ptrContext->subpq);
@@ -1327,6 +1460,10 @@ void StreamClose(SharePtr<CYMediaContext>& ptrContext)
     StreamComponentClose(ptrContext, ptrContext->nVideoStreamIndex);
     StreamComponentClose(ptrContext, ptrContext->nSubtitleStreamIndex);
     ptrContext->ptrIC.reset();
+    ptrContext->ptrMappedIO.reset();
+    ptrContext->ptrReadAheadIO.reset();
+    ptrContext->vecRetiredItems.clear();
+    ptrContext->ptrPlaylistItem.reset();
 
     if (ptrContext->ptrVideoQueue) ptrContext->ptrVideoQueue->Destroy();
     if (ptrContext->ptrAudioQueue) ptrContext->ptrAudioQueue->Destroy();
@@ -1353,6 +1490,9 @@ void StreamClose(SharePtr<CYMediaContext>& ptrContext)
     ptrContext->vis_texture = nullptr;
     ptrContext->vid_texture = nullptr;
     ptrContext->sub_texture = nullptr;
+    ptrContext->objVisTextureMem.Set(0);
+    ptrContext->objVidTextureMem.Set(0);
+    ptrContext->objSubTextureMem.Set(0);
 }
 
 void CYVideoRenderFilter::DoExit(SharePtr<CYMediaContext>& ptrContext)
@@ -1394,6 +1534,8 @@ static void TogglePause(SharePtr<CYMediaContext>& ptrContext)
 {
     StreamTogglePause(ptrContext);
     ptrContext->bStep = false;
+    /* the demuxer waits on a pause to end reverse playback, and at the end of the input to loop */
+    ptrContext->ptrReadCond->NotifyOne();
 }
 
 static void ToggleMute(SharePtr<CYMediaContext>& ptrContext)
@@ -1424,6 +1566,8 @@ static void ToggleAudioDisplay(SharePtr<CYMediaContext>& ptrContext)
 
 static int GetMasterSyncType(SharePtr<CYMediaContext>& ptrContext)
 {
+    if (ptrContext->fPlaybackSpeed != 1.0)
+        return TYPE_SYNC_CLOCK_EXTERNAL;
     if (ptrContext->nAVSyncType == TYPE_SYNC_CLOCK_VIDEO)
     {
         if (ptrContext->pVideoStream)
@@ -1464,19 +1608,11 @@ double GetMasterClock(SharePtr<CYMediaContext>& ptrContext)
     return val;
 }
 
-/* seek in the stream */
+/* seek in the stream, a newer request replaces one the demux thread has not started yet */
 static void StreamSeek(SharePtr<CYMediaContext>& ptrContext, int64_t nPos, int64_t nRel, int nByBytes)
 {
-    if (!ptrContext->bSeekReq)
-    {
-        ptrContext->nSeekPos = nPos;
-        ptrContext->nSeekRel = nRel;
-        ptrContext->nSeekFlags &= ~AVSEEK_FLAG_BYTE;
-        if (nByBytes)
-            ptrContext->nSeekFlags |= AVSEEK_FLAG_BYTE;
-        ptrContext->bSeekReq = true;
-        ptrContext->ptrReadCond->NotifyOne();
-    }
+    ptrContext->objSeekReq.Post(nPos, nRel, !!nByBytes, false);
+    ptrContext->ptrReadCond->NotifyOne();
 }
 
 static void SeekChapter(SharePtr<CYMediaContext>& ptrContext, int nIncr)
@@ -1515,6 +1651,13 @@ static void StepToNextFrame(SharePtr<CYMediaContext>& ptrContext)
     ptrContext->bStep = true;
 }
 
+/* shown by reverse playback, which the demux thread starts */
+static void StepToPreviousFrame(SharePtr<CYMediaContext>& ptrContext)
+{
+    ptrContext->nStepBackReq++;
+    ptrContext->ptrReadCond->NotifyOne();
+}
+
 int StreamComponentOpen(SharePtr<CYMediaContext>& ptrContext, int nStreamIndex);
 void CYVideoRenderFilter::StreamCycleChannel(SharePtr<CYMediaContext>& ptrContext, int nCodecType)
 {
@@ -1643,6 +1786,9 @@ void CYVideoRenderFilter::OnEntry()
             case SDLK_s: // S: Step to next frame
                 StepToNextFrame(m_ptrContext);
                 break;
+            case SDLK_b: // B: Step to previous frame
+                StepToPreviousFrame(m_ptrContext);
+                break;
             case SDLK_a:
                 StreamCycleChannel(m_ptrContext, AVMEDIA_TYPE_AUDIO);
                 break;
@@ -1667,6 +1813,8 @@ void CYVideoRenderFilter::OnEntry()
                 {
                     m_ptrContext->nVFilterIndex = 0;
                     ToggleAudioDisplay(m_ptrContext);
+                    if (m_ptrContext->eShowMode == SHOW_MODE_VIDEO)
+                        FreeAudioDisplay(m_ptrContext);
                 }
                 break;
             case SDLK_PAGEUP:
@@ -1798,6 +1946,7 @@ void CYVideoRenderFilter::OnEntry()
                 {
                     SDL_DestroyTexture(m_ptrContext->vis_texture);
                     m_ptrContext->vis_texture = nullptr;
+                    m_ptrContext->objVisTextureMem.Set(0);
                 }
 #if HAVE_VULKAN_RENDERER
                 if (m_ptrVKRenderer)
@@ -92,6 +92,8 @@ private:
     void VideoAudioDisplay(SharePtr<CYMediaContext>& ptrContext);
     int ComputeMod(int a, int b);
     void FillRectangle(int x, int y, int w, int h);
+    CYMemoryCharge* TextureCharge(SDL_Texture** pTexture);
+    int64_t TextureBytes(Uint32 nFormat, int nWidth, int nHeight);
     int ReallocTexture(SDL_Texture** pTexture, Uint32 nNewFormat, int nNewWidth, int nNewHeight, SDL_BlendMode eBlendMode, int nInitTexture);
     void VideoImageDisplay(SharePtr<CYMediaContext>& ptrContext);
     void CalculateDisplayRect(SDL_Rect* pRect, int nScrXleft, int nScrYtop, int nScrWidth, int nScrHeight, int nPicWidth, int nPicHeight, AVRational objPicSar);
@@ -96,19 +96,37 @@ int16_t CYSourceFilter::Open(SharePtr<CYMediaContext>& ptrContext, const char* p
     ptrContext->ptrAudioQueue = std::make_shared<CYPLAYER_NAMESPACE::CYPacketQueue>();
     ptrContext->ptrSubTitleQueue = std::make_shared<CYPLAYER_NAMESPACE::CYPacketQueue>();
 
-    if (ptrContext->pictq.Init(ptrContext->ptrVideoQueue, VIDEO_PICTURE_QUEUE_SIZE, 1) < 0)
+    if (ptrContext->bAdaptiveVideoQueue)
+    {
+        /* allocate every slot the adaptive depth may grow into, start from the configured depth */
+        if (ptrContext->pictq.Init(ptrContext->ptrVideoQueue, FFMAX(ptrContext->nVideoQueueDepth, ptrContext->nVideoQueueMaxDepth), 1) < 0)
+            goto fail;
+        ptrContext->pictq.SetDepth(ptrContext->nVideoQueueDepth);
+        ptrContext->pictq.EnableAdaptiveDepth(ptrContext->nVideoQueueMinDepth, ptrContext->nVideoQueueMaxDepth);
+    }
+    else if (ptrContext->pictq.Init(ptrContext->ptrVideoQueue, ptrContext->nVideoQueueDepth, 1) < 0)
+    {
         goto fail;
+    }
+
+    ptrContext->objQualityGovernor.Reset(ptrContext->bAdaptiveQuality);
 
-    if (ptrContext->subpq.Init(ptrContext->ptrSubTitleQueue, SUBPICTURE_QUEUE_SIZE, 0) < 0)
+    if (ptrContext->subpq.Init(ptrContext->ptrSubTitleQueue, ptrContext->nSubtitleQueueDepth, 0) < 0)
         goto fail;
 
-    if (ptrContext->sampq.Init(ptrContext->ptrAudioQueue, SAMPLE_QUEUE_SIZE, 1) < 0)
+    if (ptrContext->sampq.Init(ptrContext->ptrAudioQueue, ptrContext->nAudioQueueDepth, 1) < 0)
         goto fail;
 
     if (ptrContext->ptrVideoQueue->Init() < 0 || ptrContext->ptrAudioQueue->Init() < 0 || ptrContext->ptrSubTitleQueue->Init() < 0)
         goto fail;
 
-    ptrContext->ptrReadCond = std::make_shared<CYPLAYER_NAMESPACE::CYCondition>();
+    ptrContext->ptrVideoQueue->SetMemoryAccount(&ptrContext->objMemAccount);
+    ptrContext->ptrAudioQueue->SetMemoryAccount(&ptrContext->objMemAccount);
+    ptrContext->ptrSubTitleQueue->SetMemoryAccount(&ptrContext->objMemAccount);
+    ptrContext->pictq.SetMemoryAccount(&ptrContext->objMemAccount);
+    ptrContext->sampq.SetMemoryAccount(&ptrContext->objMemAccount);
+
+    ptrContext->ptrReadCond = std::make_shared<CYPLAYER_NAMESPACE::CYCondition>(true);
 
     ptrContext->vidclk.InitClock(&ptrContext->ptrVideoQueue->serial);
     ptrContext->audclk.InitClock(&ptrContext->ptrAudioQueue->serial);
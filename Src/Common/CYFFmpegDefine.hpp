@@ -328,7 +328,71 @@ static inline AVFilterGraphPtr CreateAVFilterGraph()
 #define VIDEO_PICTURE_QUEUE_SIZE 3
 #define SUBPICTURE_QUEUE_SIZE 16
 #define SAMPLE_QUEUE_SIZE 9
-#define FRAME_QUEUE_SIZE FFMAX(SAMPLE_QUEUE_SIZE, FFMAX(VIDEO_PICTURE_QUEUE_SIZE, SUBPICTURE_QUEUE_SIZE))
+/* upper bound for a per-open frame queue depth */
+#define FRAME_QUEUE_MAX_SIZE 64
+/* frames between two adaptive depth decisions */
+#define FRAME_QUEUE_ADAPT_INTERVAL 64
+/* stride and plane alignment of pooled decoder buffers, enough for AVX-512 */
+#define FRAME_POOL_ALIGN 64
+/* planes at least this large are backed by huge pages when requested */
+#define FRAME_POOL_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+/* pictures the decoder may hold as references on top of the picture queue */
+#define FRAME_POOL_PREWARM_EXTRA 4
+/* rounds a frame queue reader/writer polls before parking on its semaphore */
+#define FRAME_QUEUE_SPIN_COUNT 256
+/* AVIOContext buffer of a memory-mapped input, only small header reads go through it */
+#define MAPPED_IO_BUFFER_SIZE (64 * 1024)
+/* how far ahead of the read position a mapped input asks the kernel to page in */
+#define MAPPED_IO_PREFETCH_SIZE (8 * 1024 * 1024)
+/* AVIOContext buffer handed to the demuxer by the read-ahead layer */
+#define READ_AHEAD_BUFFER_SIZE (32 * 1024)
+/* largest single read the read-ahead thread issues to the underlying protocol */
+#define READ_AHEAD_CHUNK_SIZE (256 * 1024)
+/* how often a demuxer waiting on the read-ahead cache polls the interrupt callback, in ms */
+#define READ_AHEAD_WAIT_MS 10
+/* stream probes kept in memory by the stream info cache */
+#define STREAM_INFO_CACHE_ENTRIES 1024
+/* larger cache files are not stream probes */
+#define STREAM_INFO_CACHE_MAX_BYTES (4 * 1024 * 1024)
+/* packets a playlist preload reads at most while looking for the first frame of each stream */
+#define PRELOAD_MAX_PACKETS 256
+/* pixels per second one codec thread is given under a thread budget, about 360p at 30 fps */
+#define DECODE_THREAD_PIXEL_RATE (640 * 360 * 30)
+/* codec threads a single decoder gets at most under a thread budget */
+#define DECODE_THREAD_MAX 16
+
+/* pictures the decode quality governor averages over before it changes the quality */
+#define QUALITY_GOVERNOR_INTERVAL 30
+/* late drops in an interval that count as falling behind, when the decoder is busy too */
+#define QUALITY_GOVERNOR_DROPS 2
+/* decode time / frame duration: above HIGH the decoder is behind, below LOW it has headroom */
+#define QUALITY_GOVERNOR_HIGH_LOAD 0.9
+#define QUALITY_GOVERNOR_LOW_LOAD 0.5
+/* intervals with headroom before the quality is raised again, doubled up to MAX after a failed raise */
+#define QUALITY_GOVERNOR_CALM_INTERVALS 4
+#define QUALITY_GOVERNOR_CALM_INTERVALS_MAX 64
+
+/* a non-reference video packet this far behind the master clock, in seconds, is not decoded */
+#define EARLY_PACKET_DROP_THRESHOLD 0.1
+
+/* playback speeds SetSpeed accepts */
+#define TRICK_PLAY_MIN_SPEED 0.5
+#define TRICK_PLAY_MAX_SPEED 64.0
+/* from this speed non-reference video packets are not decoded */
+#define TRICK_PLAY_NONREF_SPEED 2.0
+/* from this speed only keyframes are read and decoded */
+#define TRICK_PLAY_KEYFRAME_SPEED 8.0
+/* fastest speed audio is played at, time-stretched; it is muted and not decoded above */
+#define TRICK_PLAY_AUDIO_MAX_SPEED 2.0
+/* wall-clock seconds between keyframes shown in keyframe trick play, the demuxer seeks ahead to keep it */
+#define TRICK_PLAY_KEYFRAME_INTERVAL 0.125
+/* SetSpeed value that plays backwards at normal speed, from decoded GOPs */
+#define REVERSE_PLAY_SPEED -1.0
+/* default cap of the decoded frames held for reverse playback and step-back */
+#define REVERSE_GOP_CACHE_SIZE (256 * 1024 * 1024)
+/* seconds a reverse run ends before the picture on screen or after a seek target, absorbs the rounding
+ * between the timestamps of the decoder and of reverse playback */
+#define REVERSE_PTS_EPSILON 0.001
 
 /* NOTE: the size must be big enough to compensate the hardware audio buffersize size */
 /* TODO: We assume that a decoded and resampled frame fits into this buffer */
@@ -339,7 +403,13 @@ static inline AVFilterGraphPtr CreateAVFilterGraph()
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 #define MAX_QUEUE_SIZE (15 * 1024 * 1024)
+/* once parked on MAX_QUEUE_SIZE, the demuxer resumes reading below this */
+#define MAX_QUEUE_SIZE_LOW (MAX_QUEUE_SIZE / 4 * 3)
+/* read-ahead a player keeps under memory pressure before its frame queues are cut */
+#define MIN_QUEUE_SIZE (1 * 1024 * 1024)
 #define MIN_FRAMES 25
+/* number of slots in a packet queue ring, must be a power of two */
+#define PACKET_QUEUE_CAPACITY 4096
 #define EXTERNAL_CLOCK_MIN_FRAMES 2
 #define EXTERNAL_CLOCK_MAX_FRAMES 10
 
@@ -397,6 +467,7 @@ typedef struct CYFrame
     AVRational sar = {};
     int uploaded = 0;
     int flip_v = 0;
+    int64_t nMemBytes = 0;    /* bytes charged to the memory account while queued */
 } CYFrame;
 
 typedef struct CYAudioParams
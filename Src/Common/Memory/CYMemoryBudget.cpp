@@ -0,0 +1,183 @@
+#include "Common/Memory/CYMemoryBudget.hpp"
+
+CYPLAYER_NAMESPACE_BEGIN
+
+CYMemoryBudget& CYMemoryBudget::Instance()
+{
+    static CYMemoryBudget s_objBudget;
+    return s_objBudget;
+}
+
+CYMemoryBudget::CYMemoryBudget()
+{
+
+}
+
+CYMemoryBudget::~CYMemoryBudget()
+{
+
+}
+
+void CYMemoryBudget::SetBudget(int64_t nBytes)
+{
+    m_nBudget = FFMAX(nBytes, 0);
+}
+
+int64_t CYMemoryBudget::GetBudget() const
+{
+    return m_nBudget;
+}
+
+int64_t CYMemoryBudget::Usage() const
+{
+    int64_t nUsage = 0;
+    for (int i = 0; i < TYPE_MEMORY_NB; i++)
+        nUsage += m_arrUsage[i].load(std::memory_order_relaxed);
+    return nUsage;
+}
+
+int64_t CYMemoryBudget::Usage(EMemoryCategory eCategory) const
+{
+    return m_arrUsage[eCategory].load(std::memory_order_relaxed);
+}
+
+int  CYMemoryBudget::Accounts() const
+{
+    return m_nAccounts;
+}
+
+void CYMemoryBudget::Register()
+{
+    m_nAccounts++;
+}
+
+void CYMemoryBudget::Unregister()
+{
+    m_nAccounts--;
+}
+
+void CYMemoryBudget::Charge(EMemoryCategory eCategory, int64_t nDelta)
+{
+    m_arrUsage[eCategory].fetch_add(nDelta, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+CYMemoryAccount::CYMemoryAccount()
+{
+    CYMemoryBudget::Instance().Register();
+}
+
+CYMemoryAccount::~CYMemoryAccount()
+{
+    for (int i = 0; i < TYPE_MEMORY_NB; i++)
+        Charge((EMemoryCategory)i, -m_arrUsage[i].load());
+    CYMemoryBudget::Instance().Unregister();
+}
+
+void CYMemoryAccount::Charge(EMemoryCategory eCategory, int64_t nDelta)
+{
+    if (!nDelta)
+        return;
+    m_arrUsage[eCategory].fetch_add(nDelta, std::memory_order_relaxed);
+    CYMemoryBudget::Instance().Charge(eCategory, nDelta);
+}
+
+int64_t CYMemoryAccount::Usage() const
+{
+    int64_t nUsage = 0;
+    for (int i = 0; i < TYPE_MEMORY_NB; i++)
+        nUsage += m_arrUsage[i].load(std::memory_order_relaxed);
+    return nUsage;
+}
+
+int64_t CYMemoryAccount::Usage(EMemoryCategory eCategory) const
+{
+    return m_arrUsage[eCategory].load(std::memory_order_relaxed);
+}
+
+void CYMemoryAccount::SetQuota(int64_t nBytes)
+{
+    m_nQuota = FFMAX(nBytes, 0);
+}
+
+int64_t CYMemoryAccount::GetQuota() const
+{
+    return m_nQuota;
+}
+
+/* at least budget / players, more while the others leave part of the budget unused */
+int64_t CYMemoryAccount::Allowance() const
+{
+    CYMemoryBudget& objBudget = CYMemoryBudget::Instance();
+    int64_t nBudget = objBudget.GetBudget();
+    int64_t nQuota = m_nQuota;
+
+    if (!nBudget)
+        return nQuota;
+
+    int64_t nFairShare = nBudget / FFMAX(objBudget.Accounts(), 1);
+    int64_t nOthers = objBudget.Usage() - Usage();
+    int64_t nAllowance = FFMAX(nFairShare, nBudget - nOthers);
+    return nQuota ? FFMIN(nAllowance, nQuota) : nAllowance;
+}
+
+/* packets are the cheapest to give up, so they get whatever frames, textures and audio leave */
+int64_t CYMemoryAccount::ReadAheadLimit() const
+{
+    int64_t nAllowance = Allowance();
+    if (!nAllowance)
+        return MAX_QUEUE_SIZE;
+
+    int64_t nOther = Usage() - Usage(TYPE_MEMORY_PACKETS);
+    return FFMAX(MIN_QUEUE_SIZE, FFMIN(nAllowance - nOther, (int64_t)MAX_QUEUE_SIZE));
+}
+
+EMemoryPressure CYMemoryAccount::Pressure() const
+{
+    int64_t nAllowance = Allowance();
+    if (!nAllowance)
+        return TYPE_MEMORY_PRESSURE_NONE;
+
+    int64_t nOther = Usage() - Usage(TYPE_MEMORY_PACKETS);
+    if (nAllowance - nOther < MIN_QUEUE_SIZE)
+        return TYPE_MEMORY_PRESSURE_FRAMES;
+    if (nAllowance - nOther < MAX_QUEUE_SIZE)
+        return TYPE_MEMORY_PRESSURE_READ_AHEAD;
+    return TYPE_MEMORY_PRESSURE_NONE;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+CYMemoryCharge::CYMemoryCharge(CYMemoryAccount* pAccount, EMemoryCategory eCategory)
+    : m_pAccount(pAccount)
+    , m_eCategory(eCategory)
+{
+
+}
+
+CYMemoryCharge::~CYMemoryCharge()
+{
+    Set(0);
+}
+
+void CYMemoryCharge::Bind(CYMemoryAccount* pAccount, EMemoryCategory eCategory)
+{
+    Set(0);
+    m_pAccount = pAccount;
+    m_eCategory = eCategory;
+}
+
+void CYMemoryCharge::Set(int64_t nBytes)
+{
+    if (m_pAccount)
+        m_pAccount->Charge(m_eCategory, nBytes - m_nBytes);
+    m_nBytes = nBytes;
+}
+
+int64_t CYMemoryCharge::Get() const
+{
+    return m_nBytes;
+}
+
+CYPLAYER_NAMESPACE_END
@@ -0,0 +1,165 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+
+#ifndef __CY_MEMORY_BUDGET_HPP__
+#define __CY_MEMORY_BUDGET_HPP__
+
+#include "Common/CYCommonDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+
+#include <atomic>
+#include <stdint.h>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+enum EMemoryCategory
+{
+    TYPE_MEMORY_PACKETS = 0,    // demuxed packets waiting in the packet queues
+    TYPE_MEMORY_FRAMES,         // decoded frames held by the frame queues
+    TYPE_MEMORY_TEXTURES,       // SDL video/subtitle/visualization textures
+    TYPE_MEMORY_AUDIO,          // resampled audio buffers
+    TYPE_MEMORY_NB
+};
+
+/* backpressure levels, reported by CYMemoryAccount::Pressure */
+enum EMemoryPressure
+{
+    TYPE_MEMORY_PRESSURE_NONE = 0,
+    TYPE_MEMORY_PRESSURE_READ_AHEAD,    // packet read-ahead is capped below MAX_QUEUE_SIZE
+    TYPE_MEMORY_PRESSURE_FRAMES,        // even minimal read-ahead does not fit, frame queues shrink too
+};
+
+class CYMemoryAccount;
+
+/**
+ * Process-wide memory budget shared by every player.
+ *
+ * Each player owns a CYMemoryAccount that registers here, and every queue, texture and
+ * audio buffer charges its bytes to that account. With a budget set, each account may use
+ * at least an equal share of it, more while the other accounts leave memory unused, and
+ * never more than its own quota. A budget of 0 means unlimited.
+ */
+class CYMemoryBudget
+{
+public:
+    static CYMemoryBudget& Instance();
+
+public:
+    void SetBudget(int64_t nBytes);
+    int64_t GetBudget() const;
+    int64_t Usage() const;
+    int64_t Usage(EMemoryCategory eCategory) const;
+    int  Accounts() const;
+
+private:
+    CYMemoryBudget();
+    ~CYMemoryBudget();
+
+    friend class CYMemoryAccount;
+    void Register();
+    void Unregister();
+    void Charge(EMemoryCategory eCategory, int64_t nDelta);
+
+private:
+    std::atomic<int64_t> m_nBudget{ 0 };
+    std::atomic<int> m_nAccounts{ 0 };
+    std::atomic<int64_t> m_arrUsage[TYPE_MEMORY_NB] = {};
+};
+
+/**
+ * One player's share of the process budget, safe to charge from any thread.
+ */
+class CYMemoryAccount
+{
+public:
+    CYMemoryAccount();
+    virtual ~CYMemoryAccount();
+
+public:
+    void Charge(EMemoryCategory eCategory, int64_t nDelta);
+    int64_t Usage() const;
+    int64_t Usage(EMemoryCategory eCategory) const;
+
+    /** hard per-player cap on top of the fair share, 0 for none. */
+    void SetQuota(int64_t nBytes);
+    int64_t GetQuota() const;
+
+    /** bytes this player may use right now, 0 when neither a budget nor a quota is set. */
+    int64_t Allowance() const;
+
+    /** packet read-ahead limit: what is left of the allowance after frames, textures and audio. */
+    int64_t ReadAheadLimit() const;
+    EMemoryPressure Pressure() const;
+
+private:
+    std::atomic<int64_t> m_nQuota{ 0 };
+    std::atomic<int64_t> m_arrUsage[TYPE_MEMORY_NB] = {};
+};
+
+/**
+ * A single allocation tracked against an account, e.g. one texture. Set() charges the
+ * difference to the previous size, destruction releases it.
+ */
+class CYMemoryCharge
+{
+public:
+    CYMemoryCharge(CYMemoryAccount* pAccount = nullptr, EMemoryCategory eCategory = TYPE_MEMORY_TEXTURES);
+    virtual ~CYMemoryCharge();
+
+    CYMemoryCharge(const CYMemoryCharge&) = delete;
+    CYMemoryCharge& operator=(const CYMemoryCharge&) = delete;
+
+public:
+    void Bind(CYMemoryAccount* pAccount, EMemoryCategory eCategory);
+    void Set(int64_t nBytes);
+    int64_t Get() const;
+
+private:
+    CYMemoryAccount* m_pAccount = nullptr;
+    EMemoryCategory m_eCategory = TYPE_MEMORY_TEXTURES;
+    int64_t m_nBytes = 0;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_MEMORY_BUDGET_HPP__
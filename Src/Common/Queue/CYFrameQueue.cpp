@@ -1,6 +1,18 @@
 #include "Common/Queue/CYFrameQueue.hpp"
 #include "Common/Queue/CYPacketQueue.hpp"
 
+#include <cmath>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CY_CPU_RELAX()  _mm_pause()
+#elif defined(__i386__) || defined(__x86_64__)
+#define CY_CPU_RELAX()  __builtin_ia32_pause()
+#else
+#define CY_CPU_RELAX()  std::this_thread::yield()
+#endif
+
 CYPLAYER_NAMESPACE_BEGIN
 
 CYFrameQueue::CYFrameQueue()
@@ -17,67 +29,125 @@ int CYFrameQueue::Init(std::shared_ptr<CYPLAYER_NAMESPACE::CYPacketQueue> ptrQue
 {
     int i;
     this->ptrQueue = ptrQueue;
-    this->max_size = FFMIN(max_size, FRAME_QUEUE_SIZE);
+    this->max_size = FFMAX(1, FFMIN(max_size, FRAME_QUEUE_MAX_SIZE));
     this->keep_last = !!keep_last;
+    this->rindex = 0;
+    this->windex = 0;
+    this->size = 0;
+    this->rindex_shown = 0;
+    this->m_vecQueue.assign(this->max_size, CYFrame());
+    m_nDepth = this->max_size;
+    m_nDepthLimit = 0;
+    m_bAdaptive = false;
     for (i = 0; i < this->max_size; i++)
-        if (!(this->m_lstQueue[i].pFrame = av_frame_alloc()))
+        if (!(this->m_vecQueue[i].pFrame = av_frame_alloc()))
             return AVERROR(ENOMEM);
     return 0;
 }
 
+/* limit the writer to nDepth frames, counting the kept last frame; slots beyond it stay allocated */
+void CYFrameQueue::SetDepth(int nDepth)
+{
+    nDepth = FFMAX(1 + this->keep_last, FFMIN(nDepth, this->max_size));
+    int nOld = m_nDepth.exchange(nDepth);
+    if (nDepth > nOld)
+        WakeUp(m_nWriterWaiting, m_objWriterSem);
+}
+
+int CYFrameQueue::GetDepth() const
+{
+    return m_nDepth;
+}
+
+void CYFrameQueue::EnableAdaptiveDepth(int nMinDepth, int nMaxDepth)
+{
+    m_nMinDepth = FFMAX(1 + this->keep_last, FFMIN(nMinDepth, this->max_size));
+    m_nMaxDepth = FFMAX(m_nMinDepth, FFMIN(nMaxDepth, this->max_size));
+    m_nSamples = 0;
+    m_fProduceMean = 0;
+    m_fProduceVar = 0;
+    m_nLateDrops = 0;
+    m_bAdaptive = true;
+    SetDepth(FFMAX(m_nMinDepth, FFMIN(GetDepth(), m_nMaxDepth)));
+}
+
+/* writer side: time it took to produce the frame about to be pushed, excluding queue waits */
+void CYFrameQueue::ReportProduceTime(double fSeconds, double fFrameDuration)
+{
+    if (!m_bAdaptive || isnan(fSeconds))
+        return;
+
+    double fDelta = fSeconds - m_fProduceMean;
+    m_fProduceMean += fDelta / 16;
+    m_fProduceVar = (m_fProduceVar + fDelta * fDelta / 16) * 15 / 16;
+
+    if (++m_nSamples >= FRAME_QUEUE_ADAPT_INTERVAL)
+    {
+        m_nSamples = 0;
+        AdaptDepth(fFrameDuration);
+    }
+}
+
+/* reader side: a frame was dropped because it was already late when it reached the front */
+void CYFrameQueue::ReportLateDrop()
+{
+    m_nLateDrops.fetch_add(1, std::memory_order_relaxed);
+}
+
+/* cap the depth at nMaxDepth whatever SetDepth or the adaptation chose, 0 removes the cap */
+void CYFrameQueue::LimitDepth(int nMaxDepth)
+{
+    nMaxDepth = FFMAX(nMaxDepth, 0);
+    if (m_nDepthLimit.exchange(nMaxDepth) != nMaxDepth)
+        WakeUp(m_nWriterWaiting, m_objWriterSem);
+}
+
+/* charge the buffers of queued frames to pAccount, set before the writer starts */
+void CYFrameQueue::SetMemoryAccount(CYMemoryAccount* pAccount)
+{
+    m_pMemAccount = pAccount;
+}
 
+/* wake both sides so they see an abort */
 void CYFrameQueue::NotifyOne()
 {
-    UniqueLock locker(m_mutex);
-    m_cvCond.notify_one();
+    WakeUp(m_nReaderWaiting, m_objReaderSem);
+    WakeUp(m_nWriterWaiting, m_objWriterSem);
 }
 
 void CYFrameQueue::Destroy()
 {
     int i;
-    for (i = 0; i < this->max_size; i++)
+    for (i = 0; i < (int)this->m_vecQueue.size(); i++)
     {
-        CYFrame* vp = &this->m_lstQueue[i];
+        CYFrame* vp = &this->m_vecQueue[i];
         UnRefItem(vp);
         av_frame_free(&vp->pFrame);
     }
+    this->m_vecQueue.clear();
 }
 
 /* return the number of undisplayed frames in the queue */
 int CYFrameQueue::NbRemaining()
 {
-    return this->size - this->rindex_shown;
+    return this->size.load(std::memory_order_acquire) - this->rindex_shown.load(std::memory_order_relaxed);
 }
 
 
 CYFrame* CYFrameQueue::PeekReadable()
 {
     /* wait until we have a readable a new frame */
-    UniqueLock locker(this->m_mutex);
-    while (this->size - this->rindex_shown <= 0 &&
-        !this->ptrQueue->bAbortRequest)
-    {
-        //SDL_CondWait(this->cond, this->mutex);
-        this->m_cvCond.wait(locker);
-    }
-    //SDL_UnlockMutex(this->mutex);
+    WaitFor(&CYFrameQueue::Readable, m_nReaderWaiting, m_objReaderSem);
 
-    if (this->ptrQueue->bAbortRequest)
+    if (Aborted())
         return nullptr;
 
-    return &this->m_lstQueue[(this->rindex + this->rindex_shown) % this->max_size];
+    return &this->m_vecQueue[(this->rindex + this->rindex_shown) % this->max_size];
 }
 
 void CYFrameQueue::Push()
 {
-    if (++this->windex == this->max_size)
-        this->windex = 0;
-    UniqueLock locker(this->m_mutex);
-    //SDL_LockMutex(this->mutex);
-    this->size++;
-    //SDL_CondSignal(this->cond);
-    this->m_cvCond.notify_one();
-    //SDL_UnlockMutex(this->mutex);
+    PushBatch(1);
 }
 
 void CYFrameQueue::Next()
@@ -85,57 +155,116 @@ void CYFrameQueue::Next()
     if (this->keep_last && !this->rindex_shown)
     {
         this->rindex_shown = 1;
+        CheckDrained();
         return;
     }
-    UnRefItem(&this->m_lstQueue[this->rindex]);
-    if (++this->rindex == this->max_size)
-        this->rindex = 0;
-    UniqueLock locker(this->m_mutex);
-    //SDL_LockMutex(this->mutex);
-    this->size--;
-    //SDL_CondSignal(this->cond);
-    this->m_cvCond.notify_one();
-    //SDL_UnlockMutex(this->mutex);
+    UnRefItem(&this->m_vecQueue[this->rindex]);
+    this->rindex.store((this->rindex + 1) % this->max_size, std::memory_order_relaxed);
+    this->size.fetch_sub(1, std::memory_order_seq_cst);
+    WakeUp(m_nWriterWaiting, m_objWriterSem);
+    CheckDrained();
 }
 
 CYFrame* CYFrameQueue::PeekWritable()
 {
     /* wait until we have space to put a new frame */
-    //SDL_LockMutex(this->mutex);
-    UniqueLock locker(this->m_mutex);
-    while (this->size >= this->max_size &&
-        !this->ptrQueue->bAbortRequest)
-    {
-        //SDL_CondWait(this->cond, this->mutex);
-        this->m_cvCond.wait(locker);
-    }
-    //SDL_UnlockMutex(this->mutex);
+    WaitFor(&CYFrameQueue::Writable, m_nWriterWaiting, m_objWriterSem);
+
+    if (Aborted())
+        return nullptr;
+
+    return &this->m_vecQueue[this->windex];
+}
 
-    if (this->ptrQueue->bAbortRequest)
+/* wait for at least one free slot, then return up to nMax consecutive writable frames */
+int CYFrameQueue::PeekWritableBatch(CYFrame** pFrames, int nMax)
+{
+    WaitFor(&CYFrameQueue::Writable, m_nWriterWaiting, m_objWriterSem);
+
+    if (Aborted())
+        return -1;
+
+    /* at least one frame is writable, even if the depth was lowered meanwhile */
+    int nFree = FFMIN(FFMAX(1, EffectiveDepth() - this->size.load(std::memory_order_acquire)), nMax);
+    for (int i = 0; i < nFree; i++)
+        pFrames[i] = &this->m_vecQueue[(this->windex + i) % this->max_size];
+    return nFree;
+}
+
+/* PeekWritable for a writer that must not park, nullptr while the queue is full or aborted */
+CYFrame* CYFrameQueue::TryPeekWritable()
+{
+    if (!Writable() || Aborted())
         return nullptr;
 
-    return &this->m_lstQueue[this->windex];
+    return &this->m_vecQueue[this->windex];
+}
+
+/* park until a slot is free, the packet queue is aborted or bCancel is set (then WakeWriters), false
+ * for the latter two. Nothing is reserved, the slot may be gone again by the time TryPeekWritable looks */
+bool CYFrameQueue::WaitWritable(const std::atomic_bool& bCancel)
+{
+    WaitFor(&CYFrameQueue::Writable, m_nWriterWaiting, m_objWriterSem, &bCancel);
+    return !Aborted() && !bCancel;
+}
+
+/* wake the parked writers so that one waiting in WaitWritable sees its cancel */
+void CYFrameQueue::WakeWriters()
+{
+    WakeUp(m_nWriterWaiting, m_objWriterSem);
+}
+
+/* notify pCond once the reader has shown every queued frame, at once if it already has; one
+ * notification per call, pCond has to outlive the queue's reader */
+void CYFrameQueue::ArmDrainWakeup(CYCondition* pCond)
+{
+    m_pDrainCond = pCond;
+    m_bDrainArmed.store(true, std::memory_order_seq_cst);
+    CheckDrained();
+}
+
+/* publish nCount frames filled through PeekWritable/PeekWritableBatch/TryPeekWritable */
+void CYFrameQueue::PushBatch(int nCount)
+{
+    if (nCount <= 0)
+        return;
+    if (m_pMemAccount)
+    {
+        int64_t nBytes = 0;
+        for (int i = 0; i < nCount; i++)
+        {
+            CYFrame* vp = &this->m_vecQueue[(this->windex + i) % this->max_size];
+            vp->nMemBytes = 0;
+            for (int j = 0; j < AV_NUM_DATA_POINTERS && vp->pFrame->buf[j]; j++)
+                vp->nMemBytes += vp->pFrame->buf[j]->size;
+            nBytes += vp->nMemBytes;
+        }
+        m_pMemAccount->Charge(TYPE_MEMORY_FRAMES, nBytes);
+    }
+    this->windex.store((this->windex + nCount) % this->max_size, std::memory_order_relaxed);
+    this->size.fetch_add(nCount, std::memory_order_seq_cst);
+    WakeUp(m_nReaderWaiting, m_objReaderSem);
 }
 
 CYFrame* CYFrameQueue::Peek()
 {
-    return &this->m_lstQueue[(this->rindex + this->rindex_shown) % this->max_size];
+    return &this->m_vecQueue[(this->rindex + this->rindex_shown) % this->max_size];
 }
 
 CYFrame* CYFrameQueue::PeekNext()
 {
-    return &this->m_lstQueue[(this->rindex + this->rindex_shown + 1) % this->max_size];
+    return &this->m_vecQueue[(this->rindex + this->rindex_shown + 1) % this->max_size];
 }
 
 CYFrame* CYFrameQueue::PeekLast()
 {
-    return &this->m_lstQueue[this->rindex];
+    return &this->m_vecQueue[this->rindex];
 }
 
 /* return last shown position */
 int64_t CYFrameQueue::LastPos()
 {
-    CYFrame* fp = &this->m_lstQueue[this->rindex];
+    CYFrame* fp = &this->m_vecQueue[this->rindex];
     if (this->rindex_shown && fp->serial == this->ptrQueue->serial)
         return fp->pos;
     else
@@ -144,8 +273,107 @@ int64_t CYFrameQueue::LastPos()
 
 void CYFrameQueue::UnRefItem(CYFrame* vp)
 {
+    if (m_pMemAccount && vp->nMemBytes)
+        m_pMemAccount->Charge(TYPE_MEMORY_FRAMES, -vp->nMemBytes);
+    vp->nMemBytes = 0;
     av_frame_unref(vp->pFrame);
     avsubtitle_free(&vp->sub);
 }
 
-CYPLAYER_NAMESPACE_END
\ No newline at end of file
+bool CYFrameQueue::Readable() const
+{
+    return this->size.load(std::memory_order_seq_cst) - this->rindex_shown.load(std::memory_order_relaxed) > 0;
+}
+
+bool CYFrameQueue::Writable() const
+{
+    return this->size.load(std::memory_order_seq_cst) < EffectiveDepth();
+}
+
+bool CYFrameQueue::Aborted() const
+{
+    return this->ptrQueue->bAbortRequest;
+}
+
+int  CYFrameQueue::EffectiveDepth() const
+{
+    int nDepth = m_nDepth.load(std::memory_order_relaxed);
+    int nLimit = m_nDepthLimit.load(std::memory_order_relaxed);
+    return nLimit ? FFMIN(nDepth, FFMAX(nLimit, 1 + this->keep_last)) : nDepth;
+}
+
+/* spin a little, then park until pfnReady holds, the packet queue is aborted or *pbCancel is set */
+void CYFrameQueue::WaitFor(bool (CYFrameQueue::*pfnReady)() const, std::atomic<int>& nWaiting, CYSemaphore& objSem, const std::atomic_bool* pbCancel)
+{
+    for (int i = 0; i < FRAME_QUEUE_SPIN_COUNT; i++)
+    {
+        if ((this->*pfnReady)() || Aborted() || (pbCancel && *pbCancel))
+            return;
+        CY_CPU_RELAX();
+    }
+
+    while (!(this->*pfnReady)() && !Aborted() && !(pbCancel && *pbCancel))
+    {
+        /* announce the park before the last check, a change after it is sure to post */
+        nWaiting.fetch_add(1, std::memory_order_seq_cst);
+        if ((this->*pfnReady)() || Aborted() || (pbCancel && *pbCancel))
+        {
+            /* if a waker already took the count its post stays behind as a spurious wakeup */
+            int n = nWaiting.load(std::memory_order_relaxed);
+            while (n > 0 && !nWaiting.compare_exchange_weak(n, n - 1))
+                ;
+            return;
+        }
+        objSem.Wait();
+    }
+}
+
+/* the other side changed size: only post when someone is parked */
+void CYFrameQueue::WakeUp(std::atomic<int>& nWaiting, CYSemaphore& objSem)
+{
+    if (nWaiting.load(std::memory_order_seq_cst) > 0)
+    {
+        for (int n = nWaiting.exchange(0); n > 0; n--)
+            objSem.Post();
+    }
+}
+
+/* reader side: the armed drain wakeup fires once nothing is left to show */
+void CYFrameQueue::CheckDrained()
+{
+    if (m_bDrainArmed.load(std::memory_order_seq_cst) && NbRemaining() == 0 && m_bDrainArmed.exchange(false))
+        m_pDrainCond->NotifyOne();
+}
+
+/* grow straight to what covers a mean + 3 sigma production spike, or one step on late drops;
+ * shrink one frame per interval once the spike fits with a frame to spare */
+void CYFrameQueue::AdaptDepth(double fFrameDuration)
+{
+    int nDepth = GetDepth();
+    int nTarget = nDepth;
+    int nLateDrops = m_nLateDrops.exchange(0);
+
+    int nNeeded = nDepth;
+    if (fFrameDuration > 0 && !isnan(fFrameDuration))
+    {
+        double fSpike = m_fProduceMean + 3 * sqrt(m_fProduceVar);
+        nNeeded = (int)ceil(fSpike / fFrameDuration) + this->keep_last;
+    }
+
+    if (nLateDrops > 0)
+        nTarget = FFMAX(nNeeded, nDepth + 1);
+    else if (nNeeded > nDepth)
+        nTarget = nNeeded;
+    else if (nNeeded < nDepth - 1)
+        nTarget = nDepth - 1;
+
+    nTarget = FFMAX(m_nMinDepth, FFMIN(nTarget, m_nMaxDepth));
+    if (nTarget != nDepth)
+    {
+        av_log(nullptr, AV_LOG_DEBUG, "frame queue depth %d -> %d (produce %.3fms +/- %.3fms, late drops %d)\n",
+            nDepth, nTarget, m_fProduceMean * 1000, sqrt(m_fProduceVar) * 1000, nLateDrops);
+        SetDepth(nTarget);
+    }
+}
+
+CYPLAYER_NAMESPACE_END
@@ -46,10 +46,38 @@
 
 #include "Common/CYCommonDefine.hpp"
 #include "Common/CYFFmpegDefine.hpp"
+#include "Common/Memory/CYMemoryBudget.hpp"
+#include "Common/Thread/CYCondition.hpp"
+#include "Common/Thread/CYSemaphore.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 CYPLAYER_NAMESPACE_BEGIN
 
 class CYPacketQueue;
+
+/**
+ * Single-producer/single-consumer frame ring.
+ *
+ * The decode thread is the only writer and the render thread (or the SDL audio callback)
+ * the only reader. windex is owned by the writer, rindex/rindex_shown by the reader and
+ * size is the atomic handoff between them, so a frame moves without taking a lock.
+ * A side that finds nothing to do spins for FRAME_QUEUE_SPIN_COUNT rounds before it parks
+ * on its semaphore; the other side only posts it when someone is parked, so neither side,
+ * the audio callback included, ever takes a mutex.
+ *
+ * max_size is the number of slots and never changes after Init. The writer may only fill
+ * up to the current depth, which can be lowered or raised at any time without moving
+ * frames; with adaptive depth enabled the writer re-evaluates it from the production
+ * times it reports and the late drops reported by the reader. LimitDepth caps whatever
+ * depth is in effect, which is how memory pressure shrinks the queue.
+ *
+ * A thread outside the pair may wait for the queue too: for a free slot (WaitWritable, the
+ * reverse presenter) or, armed once, to be notified when the reader empties it (ArmDrainWakeup,
+ * the demuxer at the end of the input).
+ */
 class CYFrameQueue
 {
 public:
@@ -58,6 +86,13 @@ public:
 
 public:
     int  Init(std::shared_ptr<CYPLAYER_NAMESPACE::CYPacketQueue> ptrQueue, int max_size, int keep_last);
+    void SetDepth(int nDepth);
+    int  GetDepth() const;
+    void EnableAdaptiveDepth(int nMinDepth, int nMaxDepth);
+    void ReportProduceTime(double fSeconds, double fFrameDuration);
+    void ReportLateDrop();
+    void LimitDepth(int nMaxDepth);
+    void SetMemoryAccount(CYMemoryAccount* pAccount);
     void NotifyOne();
     void Destroy();
     int NbRemaining();
@@ -65,6 +100,12 @@ public:
     void Push();
     void Next();
     CYFrame* PeekWritable();
+    int  PeekWritableBatch(CYFrame** pFrames, int nMax);
+    CYFrame* TryPeekWritable();
+    bool WaitWritable(const std::atomic_bool& bCancel);
+    void WakeWriters();
+    void ArmDrainWakeup(CYCondition* pCond);
+    void PushBatch(int nCount);
     CYFrame* Peek();
     CYFrame* PeekNext();
     CYFrame* PeekLast();
@@ -73,16 +114,45 @@ public:
 
     std::mutex m_mutex;
 public:
-    CYFrame m_lstQueue[FRAME_QUEUE_SIZE] = {};
-    int rindex = 0;
-    int windex = 0;
-    int size = 0;
+    std::vector<CYFrame> m_vecQueue;
+    std::atomic<int> rindex{ 0 };
+    std::atomic<int> windex{ 0 };
+    std::atomic<int> size{ 0 };
     int max_size = 0;
     int keep_last = 0;
-    int rindex_shown = 0;
-    std::condition_variable m_cvCond;
+    std::atomic<int> rindex_shown{ 0 };
     //PacketQueue* pktq;
     std::shared_ptr<CYPacketQueue> ptrQueue;
+
+private:
+    bool Readable() const;
+    bool Writable() const;
+    bool Aborted() const;
+    void WaitFor(bool (CYFrameQueue::*pfnReady)() const, std::atomic<int>& nWaiting, CYSemaphore& objSem, const std::atomic_bool* pbCancel = nullptr);
+    void WakeUp(std::atomic<int>& nWaiting, CYSemaphore& objSem);
+    void CheckDrained();
+    void AdaptDepth(double fFrameDuration);
+    int  EffectiveDepth() const;
+
+private:
+    CYSemaphore m_objReaderSem;
+    CYSemaphore m_objWriterSem;
+    std::atomic<int> m_nReaderWaiting{ 0 };
+    std::atomic<int> m_nWriterWaiting{ 0 };
+    std::atomic<int> m_nDepth{ 0 };
+    std::atomic<int> m_nDepthLimit{ 0 };
+    CYMemoryAccount* m_pMemAccount = nullptr;
+    std::atomic_bool m_bDrainArmed{ false };
+    CYCondition* m_pDrainCond = nullptr;
+
+    /* adaptive depth, touched by the writer only except m_nLateDrops */
+    bool m_bAdaptive = false;
+    int m_nMinDepth = 0;
+    int m_nMaxDepth = 0;
+    int m_nSamples = 0;
+    double m_fProduceMean = 0;
+    double m_fProduceVar = 0;
+    std::atomic<int> m_nLateDrops{ 0 };
 };
 
 CYPLAYER_NAMESPACE_END
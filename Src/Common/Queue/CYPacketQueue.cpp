@@ -1,10 +1,17 @@
 #include "Common/Queue/CYPacketQueue.hpp"
 
+#include <thread>
+
 CYPLAYER_NAMESPACE_BEGIN
 
-CYPacketQueue::CYPacketQueue()
+CYPacketQueue::CYPacketQueue(int nCapacity)
 {
+    size_t nSlots = 2;
+    while (nSlots < (size_t)FFMAX(nCapacity, 2))
+        nSlots <<= 1;
 
+    m_vecSlots.resize(nSlots);
+    m_nMask = nSlots - 1;
 }
 
 CYPacketQueue::~CYPacketQueue()
@@ -28,11 +35,10 @@ void CYPacketQueue::Abort()
 void CYPacketQueue::Flush()
 {
     UniqueLock locker(m_mutex);
-    m_lstPkt.clear();
-    nb_packets = 0;
-    size = 0;
-    duration = 0;
+    while (PopSlot(nullptr, nullptr))
+        ;
     serial++;
+    CommitOut();
 }
 
 void CYPacketQueue::Destroy()
@@ -41,35 +47,36 @@ void CYPacketQueue::Destroy()
 }
 
 int  CYPacketQueue::Put(AVPacketPtr& ptrPkt2)
-{    
-
-    AVPacketPtr pkt1 = AVPacketPtrCreate();
-    if (!pkt1)
-    {
-        av_packet_unref(ptrPkt2.get());
-        return -1;
-    }
-    av_packet_move_ref(pkt1.get(), ptrPkt2.get());
-
-
-
-    SharePtr<CYPacketWrapper> ptrPacket = MakeShared<CYPacketWrapper>();
+{
+    return PutBatch(&ptrPkt2, 1) == 1 ? 0 : -1;
+}
 
-    if (bAbortRequest)
-        return -1;
+/* queue nCount packets with a single publish, returns the number queued or -1 if none was */
+int  CYPacketQueue::PutBatch(AVPacketPtr* pPkts, int nCount)
+{
+    size_t nTail = m_nTail.load(std::memory_order_relaxed);
+    int nPut = 0;
 
+    for (; nPut < nCount; nPut++)
+    {
+        while (!bAbortRequest && nTail - m_nHead.load(std::memory_order_acquire) > m_nMask)
+        {
+            /* the demuxer checks Full() before reading, so this only happens on races */
+            Publish(nTail);
+            std::this_thread::yield();
+        }
 
-    ptrPacket->ptrPkt = std::move(pkt1);
-    ptrPacket->nSerial = serial;
+        if (bAbortRequest || !FillSlot(m_vecSlots[nTail & m_nMask], pPkts[nPut].get()))
+            break;
+        IndexKeyframe(nTail, m_vecSlots[nTail & m_nMask].ptrPkt.get());
+        nTail++;
+    }
 
-    UniqueLock locker(m_mutex);
-    m_lstPkt.push_back(ptrPacket);
-    nb_packets++;
-    size += ptrPacket->ptrPkt->size + sizeof(CYPacketWrapper);
-    duration += ptrPacket->ptrPkt->duration;
-    m_cvCond.notify_one();
+    for (int i = nPut; i < nCount; i++)
+        av_packet_unref(pPkts[i].get());
 
-    return 0;
+    Publish(nTail);
+    return (nPut > 0 || nCount == 0) ? nPut : -1;
 }
 
 int  CYPacketQueue::PutNullPacket(AVPacketPtr& ptrPkt, int stream_index)
@@ -80,8 +87,27 @@ int  CYPacketQueue::PutNullPacket(AVPacketPtr& ptrPkt, int stream_index)
 
 int  CYPacketQueue::Get(AVPacketPtr& ptrPkt, int block, int* serial)
 {
-    SharePtr<CYPacketWrapper> ptrPacket;
-    int ret;
+    return GetBatch(&ptrPkt, 1, block, serial);
+}
+
+/* dequeue up to nMax packets under one lock, returns the number dequeued, 0 if empty or -1 on abort */
+int  CYPacketQueue::GetBatch(AVPacketPtr* pPkts, int nMax, int block, int* pSerials)
+{
+    int ret = 0;
+
+    for (int i = 0; i < nMax; i++)
+    {
+        if (pPkts[i])
+        {
+            av_packet_unref(pPkts[i].get());
+        }
+        else
+        {
+            pPkts[i] = AVPacketPtrCreate();
+            if (!pPkts[i])
+                return -1;
+        }
+    }
 
     UniqueLock locker(m_mutex);
     for (;;)
@@ -92,29 +118,22 @@ int  CYPacketQueue::Get(AVPacketPtr& ptrPkt, int block, int* serial)
             break;
         }
 
-        if (m_lstPkt.size() > 0)
-        {
-            ptrPacket = m_lstPkt.front();
-            m_lstPkt.pop_front();
-
-            nb_packets--;
-            size -= ptrPacket->ptrPkt->size + sizeof(CYPacketWrapper);
-            duration -= ptrPacket->ptrPkt->duration;
+        while (ret < nMax && PopSlot(pPkts[ret].get(), pSerials ? &pSerials[ret] : nullptr))
+            ret++;
 
-            if (serial)
-                *serial = ptrPacket->nSerial;
-            ptrPkt = std::move(ptrPacket->ptrPkt);
-            ret = 1;
-            break;
-        }
-        else if (!block)
+        if (ret > 0 || !block)
         {
-            ret = 0;
+            if (ret > 0)
+                CommitOut();
             break;
         }
         else
         {
-            m_cvCond.wait(locker);
+            m_bWaiting.store(true, std::memory_order_seq_cst);
+            m_cvCond.wait(locker, [this]() {
+                return bAbortRequest || m_nHead.load(std::memory_order_relaxed) != m_nTail.load(std::memory_order_seq_cst);
+            });
+            m_bWaiting.store(false, std::memory_order_relaxed);
         }
     }
     return ret;
@@ -127,7 +146,318 @@ void CYPacketQueue::Start()
     {
         bAbortRequest = false;
         serial++;
+        CommitOut();
+    }
+}
+
+bool CYPacketQueue::Full() const
+{
+    return m_nTail.load(std::memory_order_acquire) - m_nHead.load(std::memory_order_acquire) > m_nMask;
+}
+
+int  CYPacketQueue::Capacity() const
+{
+    return (int)m_vecSlots.size();
+}
+
+void CYPacketQueue::SetWatermark(const CYQueueWatermark& objWatermark)
+{
+    m_objWatermark = objWatermark;
+}
+
+const CYQueueWatermark& CYPacketQueue::GetWatermark() const
+{
+    return m_objWatermark;
+}
+
+bool CYPacketQueue::AboveHighWatermark() const
+{
+    CYPacketQueueStats objStats = GetStats();
+    return objStats.nPackets > m_objWatermark.nHighPackets && (!objStats.nDuration || objStats.nDuration > m_objWatermark.nHighDuration);
+}
+
+bool CYPacketQueue::BelowLowWatermark() const
+{
+    CYPacketQueueStats objStats = GetStats();
+    return objStats.nPackets <= m_objWatermark.nLowPackets || (objStats.nDuration && objStats.nDuration < m_objWatermark.nLowDuration);
+}
+
+bool CYPacketQueue::ArmLowWatermark(int nWakePackets, int64_t nWakeDuration, int nWakeBytes)
+{
+    m_nWakePackets = nWakePackets;
+    m_nWakeDuration = nWakeDuration;
+    m_nWakeBytes = nWakeBytes;
+    m_bLowArmed = true;
+
+    /* pairs with CheckLowWatermark: either we see the drained counters or the consumer sees the arm */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ReachedWakeThreshold())
+    {
+        m_bLowArmed = false;
+        return false;
+    }
+    return true;
+}
+
+bool CYPacketQueue::CheckLowWatermark()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_bLowArmed || !ReachedWakeThreshold())
+        return false;
+    return m_bLowArmed.exchange(false);
+}
+
+bool CYPacketQueue::ReachedWakeThreshold() const
+{
+    CYPacketQueueStats objStats = GetStats();
+    return objStats.nPackets <= m_nWakePackets
+        || (objStats.nDuration && objStats.nDuration <= m_nWakeDuration)
+        || objStats.nBytes <= m_nWakeBytes;
+}
+
+/* producer side: move pPkt into the slot shell, allocating the shell the first time the slot is used */
+bool CYPacketQueue::FillSlot(CYPacketWrapper& objSlot, AVPacket* pPkt)
+{
+    if (objSlot.ptrPkt)
+    {
+        m_nPoolHits.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        objSlot.ptrPkt = AVPacketPtrCreate();
+        if (!objSlot.ptrPkt)
+            return false;
+        m_nPoolMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+    av_packet_move_ref(objSlot.ptrPkt.get(), pPkt);
+    objSlot.nSerial = serial;
+
+    /* committed by Publish before the slot becomes visible, so the out side never overtakes the in side */
+    m_arrPendingIn[CYQueueCounters::COUNTER_PACKETS]++;
+    m_arrPendingIn[CYQueueCounters::COUNTER_BYTES] += objSlot.ptrPkt->size + (int)sizeof(CYPacketWrapper);
+    m_arrPendingIn[CYQueueCounters::COUNTER_DURATION] += objSlot.ptrPkt->duration;
+    return true;
+}
+
+/* producer side: make every slot before nTail visible and wake a parked consumer */
+void CYPacketQueue::Publish(size_t nTail)
+{
+    if (nTail == m_nTail.load(std::memory_order_relaxed))
+        return;
+
+    CommitIn();
+    m_nTail.store(nTail, std::memory_order_seq_cst);
+    if (m_bWaiting.load(std::memory_order_seq_cst))
+    {
+        LockGuard locker(m_mutex);
+        m_cvCond.notify_one();
+    }
+}
+
+void CYPacketQueue::SetMemoryAccount(CYMemoryAccount* pAccount)
+{
+    m_pMemAccount = pAccount;
+}
+
+/* producer side: remember keyframes with a timestamp, forgetting the ones already taken out */
+void CYPacketQueue::IndexKeyframe(size_t nSeq, const AVPacket* pPkt)
+{
+    size_t nHead = m_nHead.load(std::memory_order_acquire);
+    while (!m_deqKeyframes.empty() && m_deqKeyframes.front().nSeq < nHead)
+        m_deqKeyframes.pop_front();
+
+    int64_t nTimestamp = pPkt->pts != AV_NOPTS_VALUE ? pPkt->pts : pPkt->dts;
+    if (pPkt->data && (pPkt->flags & AV_PKT_FLAG_KEY) && nTimestamp != AV_NOPTS_VALUE)
+        m_deqKeyframes.push_back({ nSeq, nTimestamp });
+}
+
+bool CYPacketQueue::SeekWithin(int64_t nTarget)
+{
+    UniqueLock locker(m_mutex);
+    size_t nHead = m_nHead.load(std::memory_order_relaxed);
+    size_t nTail = m_nTail.load(std::memory_order_relaxed);
+
+    size_t nKeySeq = nTail;
+    for (const CYQueuedKeyframe& objKey : m_deqKeyframes)
+    {
+        if (objKey.nSeq >= nHead && objKey.nTimestamp <= nTarget)
+            nKeySeq = objKey.nSeq;
+    }
+    if (nKeySeq == nTail)
+        return false;
+
+    /* the newest packet with a timestamp must have reached the target, dts never exceeds pts */
+    int64_t nNewest = AV_NOPTS_VALUE;
+    for (size_t nSeq = nTail; nSeq > nKeySeq && nNewest == AV_NOPTS_VALUE; )
+    {
+        const AVPacket* pPkt = m_vecSlots[--nSeq & m_nMask].ptrPkt.get();
+        nNewest = pPkt->dts != AV_NOPTS_VALUE ? pPkt->dts : pPkt->pts;
+    }
+    if (nNewest == AV_NOPTS_VALUE || nNewest < nTarget)
+        return false;
+
+    while (m_nHead.load(std::memory_order_relaxed) != nKeySeq)
+        PopSlot(nullptr, nullptr);
+    serial++;
+    for (size_t nSeq = nKeySeq; nSeq != nTail; nSeq++)
+        m_vecSlots[nSeq & m_nMask].nSerial = serial;
+    CommitOut();
+    return true;
+}
+
+int64_t CYPacketQueue::PoolHits() const
+{
+    return m_nPoolHits.load(std::memory_order_relaxed);
+}
+
+int64_t CYPacketQueue::PoolMisses() const
+{
+    return m_nPoolMisses.load(std::memory_order_relaxed);
+}
+
+CYPacketQueueStats CYPacketQueue::GetStats() const
+{
+    int64_t arrOut[CYQueueCounters::COUNTER_NB];
+    int64_t arrIn[CYQueueCounters::COUNTER_NB];
+    CYPacketQueueStats objStats;
+
+    /* out first: whatever was taken out had been committed on the in side before. if the out
+     * side did not move while the in side was read, both sets held at that moment. */
+    for (;;)
+    {
+        uint32_t nSeqOut = ReadCounters(m_objOut, arrOut);
+        ReadCounters(m_objIn, arrIn);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_objOut.nSeq.load(std::memory_order_relaxed) == nSeqOut)
+            break;
     }
+
+    objStats.nPackets = (int)(arrIn[CYQueueCounters::COUNTER_PACKETS] - arrOut[CYQueueCounters::COUNTER_PACKETS]);
+    objStats.nBytes = (int)(arrIn[CYQueueCounters::COUNTER_BYTES] - arrOut[CYQueueCounters::COUNTER_BYTES]);
+    objStats.nDuration = arrIn[CYQueueCounters::COUNTER_DURATION] - arrOut[CYQueueCounters::COUNTER_DURATION];
+    objStats.nSerial = (int)arrOut[CYQueueCounters::COUNTER_SERIAL];
+    objStats.nMaxPackets = (int)arrIn[CYQueueCounters::COUNTER_MAX_PACKETS];
+    objStats.nMaxBytes = (int)arrIn[CYQueueCounters::COUNTER_MAX_BYTES];
+    objStats.nTotalEnqueued = arrIn[CYQueueCounters::COUNTER_PACKETS];
+    objStats.nTotalDequeued = arrOut[CYQueueCounters::COUNTER_PACKETS];
+    return objStats;
+}
+
+int  CYPacketQueue::NbPackets() const
+{
+    return GetStats().nPackets;
+}
+
+int  CYPacketQueue::Size() const
+{
+    return GetStats().nBytes;
+}
+
+int64_t CYPacketQueue::Duration() const
+{
+    return GetStats().nDuration;
+}
+
+/* producer side: fold the pending in counters into m_objIn and update the high-water marks */
+void CYPacketQueue::CommitIn()
+{
+    int64_t arrOut[CYQueueCounters::COUNTER_NB];
+    if (!m_arrPendingIn[CYQueueCounters::COUNTER_PACKETS])
+        return;
+
+    if (m_pMemAccount)
+        m_pMemAccount->Charge(TYPE_MEMORY_PACKETS, m_arrPendingIn[CYQueueCounters::COUNTER_BYTES]);
+
+    ReadCounters(m_objOut, arrOut);
+    BeginWrite(m_objIn);
+    for (int i = CYQueueCounters::COUNTER_PACKETS; i <= CYQueueCounters::COUNTER_DURATION; i++)
+    {
+        m_objIn.arrValues[i].store(m_objIn.arrValues[i].load(std::memory_order_relaxed) + m_arrPendingIn[i], std::memory_order_relaxed);
+        m_arrPendingIn[i] = 0;
+    }
+
+    /* arrOut may be slightly stale, so the marks are an upper bound */
+    int64_t nPackets = m_objIn.arrValues[CYQueueCounters::COUNTER_PACKETS].load(std::memory_order_relaxed) - arrOut[CYQueueCounters::COUNTER_PACKETS];
+    int64_t nBytes = m_objIn.arrValues[CYQueueCounters::COUNTER_BYTES].load(std::memory_order_relaxed) - arrOut[CYQueueCounters::COUNTER_BYTES];
+    if (nPackets > m_objIn.arrValues[CYQueueCounters::COUNTER_MAX_PACKETS].load(std::memory_order_relaxed))
+        m_objIn.arrValues[CYQueueCounters::COUNTER_MAX_PACKETS].store(nPackets, std::memory_order_relaxed);
+    if (nBytes > m_objIn.arrValues[CYQueueCounters::COUNTER_MAX_BYTES].load(std::memory_order_relaxed))
+        m_objIn.arrValues[CYQueueCounters::COUNTER_MAX_BYTES].store(nBytes, std::memory_order_relaxed);
+    EndWrite(m_objIn);
+}
+
+/* must be called with m_mutex held: fold the pending out counters into m_objOut and mirror serial */
+void CYPacketQueue::CommitOut()
+{
+    if (m_pMemAccount)
+        m_pMemAccount->Charge(TYPE_MEMORY_PACKETS, -m_arrPendingOut[CYQueueCounters::COUNTER_BYTES]);
+
+    BeginWrite(m_objOut);
+    for (int i = CYQueueCounters::COUNTER_PACKETS; i <= CYQueueCounters::COUNTER_DURATION; i++)
+    {
+        m_objOut.arrValues[i].store(m_objOut.arrValues[i].load(std::memory_order_relaxed) + m_arrPendingOut[i], std::memory_order_relaxed);
+        m_arrPendingOut[i] = 0;
+    }
+    m_objOut.arrValues[CYQueueCounters::COUNTER_SERIAL].store(serial, std::memory_order_relaxed);
+    EndWrite(m_objOut);
+}
+
+void CYPacketQueue::BeginWrite(CYQueueCounters& objCounters)
+{
+    objCounters.nSeq.store(objCounters.nSeq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void CYPacketQueue::EndWrite(CYQueueCounters& objCounters)
+{
+    objCounters.nSeq.store(objCounters.nSeq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/* retry until the values were read between two identical, even sequence numbers, returns that number */
+uint32_t CYPacketQueue::ReadCounters(const CYQueueCounters& objCounters, int64_t* pValues)
+{
+    for (;;)
+    {
+        uint32_t nSeq = objCounters.nSeq.load(std::memory_order_acquire);
+        if (nSeq & 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (int i = 0; i < CYQueueCounters::COUNTER_NB; i++)
+            pValues[i] = objCounters.arrValues[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (objCounters.nSeq.load(std::memory_order_relaxed) == nSeq)
+            return nSeq;
+    }
+}
+
+/* must be called with m_mutex held, Get and Flush are the only consumers.
+ * the packet is moved into pPkt, or dropped when pPkt is null; the shell stays in the slot. */
+bool CYPacketQueue::PopSlot(AVPacket* pPkt, int* pSerial)
+{
+    size_t nHead = m_nHead.load(std::memory_order_relaxed);
+    if (nHead == m_nTail.load(std::memory_order_acquire))
+        return false;
+
+    CYPacketWrapper& objSlot = m_vecSlots[nHead & m_nMask];
+    AVPacket* pSlotPkt = objSlot.ptrPkt.get();
+
+    m_arrPendingOut[CYQueueCounters::COUNTER_PACKETS]++;
+    m_arrPendingOut[CYQueueCounters::COUNTER_BYTES] += pSlotPkt->size + (int)sizeof(CYPacketWrapper);
+    m_arrPendingOut[CYQueueCounters::COUNTER_DURATION] += pSlotPkt->duration;
+
+    if (pSerial)
+        *pSerial = objSlot.nSerial;
+    if (pPkt)
+        av_packet_move_ref(pPkt, pSlotPkt);
+    else
+        av_packet_unref(pSlotPkt);
+
+    m_nHead.store(nHead + 1, std::memory_order_release);
+    return true;
 }
 
-CYPLAYER_NAMESPACE_END
\ No newline at end of file
+CYPLAYER_NAMESPACE_END
@@ -46,8 +46,12 @@
 
 #include "Common/CYCommonDefine.hpp"
 #include "Common/CYFFmpegDefine.hpp"
+#include "Common/Memory/CYMemoryBudget.hpp"
 
-#include <list>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <condition_variable>
 
 CYPLAYER_NAMESPACE_BEGIN
 
@@ -55,13 +59,65 @@ class CYPacketWrapper
 {
 public:
     AVPacketPtr ptrPkt;
-    int nSerial;
+    int nSerial = 0;
 };
 
+/* read-ahead watermarks of a packet queue, durations are in the stream time base */
+struct CYQueueWatermark
+{
+    int nHighPackets = MIN_FRAMES;
+    int nLowPackets = MIN_FRAMES / 2;
+    int64_t nHighDuration = 0;
+    int64_t nLowDuration = 0;
+};
+
+/* a consistent view of a packet queue, see CYPacketQueue::GetStats */
+struct CYPacketQueueStats
+{
+    int nPackets = 0;
+    int nBytes = 0;
+    int64_t nDuration = 0;
+    int nSerial = 0;
+    int nMaxPackets = 0;            // high-water marks since the queue was created
+    int nMaxBytes = 0;
+    int64_t nTotalEnqueued = 0;     // packets ever put / taken out (including flushed ones)
+    int64_t nTotalDequeued = 0;
+};
+
+/* cumulative counters of one side of the queue, one writer at a time, readers go through nSeq.
+ * the in side also keeps the high-water marks, the out side a copy of the serial. */
+struct CYQueueCounters
+{
+    enum { COUNTER_PACKETS, COUNTER_BYTES, COUNTER_DURATION, COUNTER_MAX_PACKETS, COUNTER_MAX_BYTES, COUNTER_SERIAL, COUNTER_NB };
+
+    std::atomic<uint32_t> nSeq{ 0 };
+    std::atomic<int64_t> arrValues[COUNTER_NB] = {};
+};
+
+/**
+ * Bounded single-producer/single-consumer packet queue.
+ *
+ * The demux thread is the only producer and the decoder thread the only consumer,
+ * so the packets live in a power-of-two ring indexed by two atomic counters. Put never
+ * takes a lock; the consumer side (Get/Flush) is serialized by m_mutex, which is only
+ * contended on flush, and a consumer parks on m_cvCond only when the ring is empty.
+ *
+ * Every slot keeps its AVPacket shell for the lifetime of the queue and packets are
+ * moved in and out by reference, so the slots double as the queue's packet pool and a
+ * warm queue does no heap allocation per packet.
+ *
+ * The queue size is never stored. The producer counts what went in and the consumer what
+ * came out, each in its own CYQueueCounters behind a sequence lock, and readers take the
+ * difference. GetStats reads the out side, then the in side, then checks the out side did
+ * not move, so any thread gets values that existed together without taking m_mutex.
+ *
+ * The producer also remembers where the queued keyframes are, so that a seek landing in
+ * what is already buffered can be served by SeekWithin without touching the demuxer.
+ */
 class CYPacketQueue
 {
 public:
-    CYPacketQueue();
+    explicit CYPacketQueue(int nCapacity = PACKET_QUEUE_CAPACITY);
     virtual ~CYPacketQueue();
 
 public:
@@ -74,14 +130,102 @@ public:
     int  Get(AVPacketPtr& ptrPkt, int block, int* serial);
     void Start();
 
+    /** batched Put/Get: one publish / one lock for the whole array, see the .cpp for return values. */
+    int  PutBatch(AVPacketPtr* pPkts, int nCount);
+    int  GetBatch(AVPacketPtr* pPkts, int nMax, int block, int* pSerials);
+
+    /** true when the ring has no free slot, the producer should stop reading. */
+    bool Full() const;
+    int  Capacity() const;
+
+    void SetWatermark(const CYQueueWatermark& objWatermark);
+    const CYQueueWatermark& GetWatermark() const;
+    /** the queue holds enough packets, the demuxer may stop reading. */
+    bool AboveHighWatermark() const;
+    /** the queue is running dry and should be refilled. */
+    bool BelowLowWatermark() const;
+
+    /**
+     * Called by the demuxer before it parks: the consumer reports a wakeup once the queue
+     * drains to nWakePackets packets, nWakeDuration duration or nWakeBytes bytes (-1 disables
+     * a threshold). Returns false if a threshold is already reached and it must not park.
+     */
+    bool ArmLowWatermark(int nWakePackets, int64_t nWakeDuration, int nWakeBytes);
+    /** Called by the consumer after Get, true exactly once per arm when a threshold is crossed. */
+    bool CheckLowWatermark();
+
+    /** packet shells reused from the slot pool / allocated because the slot was cold. */
+    int64_t PoolHits() const;
+    int64_t PoolMisses() const;
+
+    /** lock-free snapshot, safe from any thread. */
+    CYPacketQueueStats GetStats() const;
+    int  NbPackets() const;
+    int  Size() const;
+    int64_t Duration() const;
+
+    /** charge queued packet bytes to pAccount, set before the queue is started. */
+    void SetMemoryAccount(CYMemoryAccount* pAccount);
+
+    /**
+     * Producer side: serve a seek to nTarget (stream time base) from the queued packets.
+     * Needs a keyframe at or before nTarget and a packet at or after it; the packets before
+     * that keyframe are dropped and the rest continue under a new serial. Returns false and
+     * leaves the queue untouched otherwise.
+     */
+    bool SeekWithin(int64_t nTarget);
+
     int serial = 0;
+    std::atomic_bool bAbortRequest{ false };
+
+private:
+    struct CYQueuedKeyframe
+    {
+        size_t nSeq;
+        int64_t nTimestamp;
+    };
+
+    bool FillSlot(CYPacketWrapper& objSlot, AVPacket* pPkt);
+    void IndexKeyframe(size_t nSeq, const AVPacket* pPkt);
+    void Publish(size_t nTail);
+    bool PopSlot(AVPacket* pPkt, int* pSerial);
+    bool ReachedWakeThreshold() const;
+    void CommitIn();
+    void CommitOut();
+
+    static void BeginWrite(CYQueueCounters& objCounters);
+    static void EndWrite(CYQueueCounters& objCounters);
+    static uint32_t ReadCounters(const CYQueueCounters& objCounters, int64_t* pValues);
 
-    int nb_packets = 0;
-    int size = 0;
-    int64_t duration = 0;
-    bool bAbortRequest = false;
 private:
-    std::list<SharePtr<CYPacketWrapper>> m_lstPkt;
+    std::vector<CYPacketWrapper> m_vecSlots;
+    size_t m_nMask = 0;
+
+    /* consumer and producer indexes live on separate cache lines */
+    alignas(64) std::atomic<size_t> m_nHead{ 0 };
+    alignas(64) std::atomic<size_t> m_nTail{ 0 };
+    alignas(64) std::atomic_bool m_bWaiting{ false };
+
+    CYQueueWatermark m_objWatermark;
+    std::atomic_bool m_bLowArmed{ false };
+    std::atomic<int> m_nWakePackets{ -1 };
+    std::atomic<int64_t> m_nWakeDuration{ -1 };
+    std::atomic<int> m_nWakeBytes{ -1 };
+
+    /* in: written by the producer. out: written by whoever holds m_mutex (Get/Flush/Start). */
+    alignas(64) CYQueueCounters m_objIn;
+    alignas(64) CYQueueCounters m_objOut;
+
+    /* accounted but not yet committed, owned by the producer / by the m_mutex holder */
+    int64_t m_arrPendingIn[3] = { 0 };
+    int64_t m_arrPendingOut[3] = { 0 };
+
+    std::atomic<int64_t> m_nPoolHits{ 0 };
+    std::atomic<int64_t> m_nPoolMisses{ 0 };
+    CYMemoryAccount* m_pMemAccount = nullptr;
+
+    /* ring positions of queued keyframes in queue order, owned by the producer */
+    std::deque<CYQueuedKeyframe> m_deqKeyframes;
 
     std::mutex m_mutex;
     std::condition_variable m_cvCond;
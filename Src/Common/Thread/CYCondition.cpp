@@ -3,7 +3,8 @@
 
 CYPLAYER_NAMESPACE_BEGIN
 
-CYCondition::CYCondition()
+CYCondition::CYCondition(bool bLatched)
+    : m_bLatched(bLatched)
 {
 
 }
@@ -16,7 +17,14 @@ CYCondition::~CYCondition()
 ECondRetCode CYCondition::WaitTimeOut(int nMilliSeconds)
 {
     UniqueLock locker(m_mutex);
-    if (m_cv.wait_for(locker, std::chrono::microseconds(nMilliSeconds)) == std::cv_status::timeout)
+    if (m_bLatched)
+    {
+        bool bSignaled = m_cv.wait_for(locker, std::chrono::milliseconds(nMilliSeconds), [this]() { return m_bSignaled; });
+        m_bSignaled = false;
+        return bSignaled ? COND_RET_OK : COND_RET_TIMEOUT;
+    }
+
+    if (m_cv.wait_for(locker, std::chrono::milliseconds(nMilliSeconds)) == std::cv_status::timeout)
     {
         return COND_RET_TIMEOUT;
     }
@@ -26,6 +34,13 @@ ECondRetCode CYCondition::WaitTimeOut(int nMilliSeconds)
 ECondRetCode CYCondition::Wait()
 {
     UniqueLock locker(m_mutex);
+    if (m_bLatched)
+    {
+        m_cv.wait(locker, [this]() { return m_bSignaled; });
+        m_bSignaled = false;
+        return COND_RET_OK;
+    }
+
     m_cv.wait(locker);
     return COND_RET_OK;
 }
@@ -33,12 +48,14 @@ ECondRetCode CYCondition::Wait()
 void CYCondition::NotifyOne()
 {
     UniqueLock locker(m_mutex);
+    m_bSignaled = true;
     m_cv.notify_one();
 }
 
 void CYCondition::NotifyALL()
 {
     UniqueLock locker(m_mutex);
+    m_bSignaled = true;
     m_cv.notify_all();
 }
 
@@ -60,7 +60,11 @@ enum ECondRetCode
 class CYCondition
 {
 public:
-    CYCondition();
+    /**
+     * bLatched: a notify with no waiter is remembered and the next wait returns at once,
+     * so a waiter that checks its predicate before parking cannot miss a wakeup.
+     */
+    explicit CYCondition(bool bLatched = false);
     virtual ~CYCondition();
 
 public:
@@ -72,6 +76,8 @@ public:
 private:
     std::mutex m_mutex;
     std::condition_variable m_cv;
+    bool m_bLatched = false;
+    bool m_bSignaled = false;
 };
 
 CYPLAYER_NAMESPACE_END
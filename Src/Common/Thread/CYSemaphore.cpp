@@ -0,0 +1,78 @@
+#include "Common/Thread/CYSemaphore.hpp"
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+#include <errno.h>
+#include <time.h>
+#endif
+
+CYPLAYER_NAMESPACE_BEGIN
+
+CYSemaphore::CYSemaphore()
+{
+#if defined(_WIN32)
+    m_hSem = CreateSemaphore(nullptr, 0, LONG_MAX, nullptr);
+#elif defined(__APPLE__)
+    m_hSem = dispatch_semaphore_create(0);
+#else
+    sem_init(&m_hSem, 0, 0);
+#endif
+}
+
+CYSemaphore::~CYSemaphore()
+{
+#if defined(_WIN32)
+    CloseHandle(m_hSem);
+#elif defined(__APPLE__)
+    dispatch_release(m_hSem);
+#else
+    sem_destroy(&m_hSem);
+#endif
+}
+
+void CYSemaphore::Post()
+{
+#if defined(_WIN32)
+    ReleaseSemaphore(m_hSem, 1, nullptr);
+#elif defined(__APPLE__)
+    dispatch_semaphore_signal(m_hSem);
+#else
+    sem_post(&m_hSem);
+#endif
+}
+
+void CYSemaphore::Wait()
+{
+#if defined(_WIN32)
+    WaitForSingleObject(m_hSem, INFINITE);
+#elif defined(__APPLE__)
+    dispatch_semaphore_wait(m_hSem, DISPATCH_TIME_FOREVER);
+#else
+    while (sem_wait(&m_hSem) != 0 && errno == EINTR)
+        ;
+#endif
+}
+
+bool CYSemaphore::WaitTimeOut(int nMilliSeconds)
+{
+#if defined(_WIN32)
+    return WaitForSingleObject(m_hSem, nMilliSeconds) == WAIT_OBJECT_0;
+#elif defined(__APPLE__)
+    return dispatch_semaphore_wait(m_hSem, dispatch_time(DISPATCH_TIME_NOW, (int64_t)nMilliSeconds * 1000000)) == 0;
+#else
+    struct timespec tDeadline;
+    clock_gettime(CLOCK_REALTIME, &tDeadline);
+    tDeadline.tv_sec += nMilliSeconds / 1000;
+    tDeadline.tv_nsec += (long)(nMilliSeconds % 1000) * 1000000;
+    if (tDeadline.tv_nsec >= 1000000000)
+    {
+        tDeadline.tv_sec++;
+        tDeadline.tv_nsec -= 1000000000;
+    }
+    int ret;
+    while ((ret = sem_timedwait(&m_hSem, &tDeadline)) != 0 && errno == EINTR)
+        ;
+    return ret == 0;
+#endif
+}
+
+CYPLAYER_NAMESPACE_END
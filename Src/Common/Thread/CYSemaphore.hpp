@@ -0,0 +1,88 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_SEMAPHORE_HPP__
+#define __CY_SEMAPHORE_HPP__
+
+#include "Common/CYCommonDefine.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#else
+#include <semaphore.h>
+#endif
+
+CYPLAYER_NAMESPACE_BEGIN
+
+/**
+ * Counting semaphore on the platform primitive.
+ *
+ * Post takes no user-space lock and only enters the kernel when a thread is blocked, which
+ * makes it safe to call from the SDL audio callback; it is the park/wake path of CYFrameQueue.
+ */
+class CYSemaphore
+{
+public:
+    CYSemaphore();
+    virtual ~CYSemaphore();
+
+public:
+    void Post();
+    void Wait();
+    /** false when nMilliSeconds passed without a post. */
+    bool WaitTimeOut(int nMilliSeconds);
+
+private:
+#if defined(_WIN32)
+    HANDLE m_hSem = nullptr;
+#elif defined(__APPLE__)
+    dispatch_semaphore_t m_hSem = nullptr;
+#else
+    sem_t m_hSem;
+#endif
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_SEMAPHORE_HPP__
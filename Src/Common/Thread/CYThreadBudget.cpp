@@ -0,0 +1,202 @@
+#include "Common/Thread/CYThreadBudget.hpp"
+
+#include <algorithm>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+CYThreadBudget& CYThreadBudget::Instance()
+{
+    static CYThreadBudget s_objBudget;
+    return s_objBudget;
+}
+
+CYThreadBudget::CYThreadBudget()
+{
+
+}
+
+CYThreadBudget::~CYThreadBudget()
+{
+
+}
+
+void CYThreadBudget::SetBudget(int nThreads)
+{
+    LockGuard locker(m_mutex);
+    m_nBudget = FFMAX(nThreads, 0);
+}
+
+int CYThreadBudget::GetBudget() const
+{
+    return m_nBudget;
+}
+
+int CYThreadBudget::Leases() const
+{
+    LockGuard locker(m_mutex);
+    return (int)m_vecLeases.size();
+}
+
+int CYThreadBudget::Assigned() const
+{
+    LockGuard locker(m_mutex);
+    int nAssigned = 0;
+    for (CYThreadLease* pLease : m_vecLeases)
+        nAssigned += pLease->m_nThreads;
+    return nAssigned;
+}
+
+/* must be called with m_mutex held: pLease's share, capped at what the decoders of the other
+ * leases leave of the budget, and the lease is registered holding it */
+int CYThreadBudget::Grant(CYThreadLease* pLease, int64_t nWeight, int nCap)
+{
+    int nBudget = m_nBudget;
+    int nHeld = 0;
+    for (CYThreadLease* pOther : m_vecLeases)
+        if (pOther != pLease)
+            nHeld += pOther->m_nThreads;
+
+    int nThreads = FFMAX(1, FFMIN(Share(pLease, nWeight, nCap), nBudget - nHeld));
+    pLease->m_nWeight = nWeight;
+    pLease->m_nCap = nCap;
+    pLease->m_nThreads = nThreads;
+    if (!pLease->m_bRegistered)
+    {
+        m_vecLeases.push_back(pLease);
+        pLease->m_bRegistered = true;
+    }
+    return nThreads;
+}
+
+void CYThreadBudget::Transfer(CYThreadLease* pLease, CYThreadLease* pFrom)
+{
+    LockGuard locker(m_mutex);
+    m_vecLeases.erase(std::remove(m_vecLeases.begin(), m_vecLeases.end(), pFrom), m_vecLeases.end());
+    if (!pFrom->m_bRegistered)
+    {
+        m_vecLeases.erase(std::remove(m_vecLeases.begin(), m_vecLeases.end(), pLease), m_vecLeases.end());
+        pLease->m_bRegistered = false;
+        pLease->m_nThreads = 0;
+        return;
+    }
+
+    pLease->m_nWeight = pFrom->m_nWeight;
+    pLease->m_nCap = pFrom->m_nCap;
+    pLease->m_nThreads = pFrom->m_nThreads.load();
+    if (!pLease->m_bRegistered)
+    {
+        m_vecLeases.push_back(pLease);
+        pLease->m_bRegistered = true;
+    }
+    pFrom->m_bRegistered = false;
+    pFrom->m_nThreads = 0;
+}
+
+void CYThreadBudget::Remove(CYThreadLease* pLease)
+{
+    LockGuard locker(m_mutex);
+    if (!pLease->m_bRegistered)
+        return;
+    m_vecLeases.erase(std::remove(m_vecLeases.begin(), m_vecLeases.end(), pLease), m_vecLeases.end());
+    pLease->m_bRegistered = false;
+    pLease->m_nThreads = 0;
+}
+
+/* must be called with m_mutex held: pLease's split of the whole budget, taking it at nWeight and
+ * nCap. One thread each, then the rest in proportion to the weights of the leases below their
+ * cap; what a capped lease cannot use goes round again to the others */
+int CYThreadBudget::Share(CYThreadLease* pLease, int64_t nWeight, int nCap) const
+{
+    struct ShareItem
+    {
+        int64_t nWeight;
+        int nCap;
+        int nThreads;
+    };
+    std::vector<ShareItem> vecItems;
+    vecItems.reserve(m_vecLeases.size() + 1);
+    for (CYThreadLease* pOther : m_vecLeases)
+        if (pOther != pLease)
+            vecItems.push_back({ pOther->m_nWeight, pOther->m_nCap, 1 });
+    vecItems.push_back({ nWeight, nCap, 1 });
+
+    int nRemaining = m_nBudget - (int)vecItems.size();
+    while (nRemaining > 0)
+    {
+        int64_t nWeights = 0;
+        for (ShareItem& objItem : vecItems)
+            if (objItem.nThreads < objItem.nCap)
+                nWeights += objItem.nWeight;
+        if (!nWeights)
+            break;
+
+        int nGiven = 0;
+        for (ShareItem& objItem : vecItems)
+        {
+            if (objItem.nThreads >= objItem.nCap)
+                continue;
+            int nShare = (int)FFMIN((int64_t)nRemaining * objItem.nWeight / nWeights, objItem.nCap - objItem.nThreads);
+            objItem.nThreads += nShare;
+            nGiven += nShare;
+        }
+
+        /* rounding left every share at 0: the heaviest lease below its cap takes one more */
+        if (!nGiven)
+        {
+            ShareItem* pHeaviest = nullptr;
+            for (ShareItem& objItem : vecItems)
+                if (objItem.nThreads < objItem.nCap && (!pHeaviest || objItem.nWeight > pHeaviest->nWeight))
+                    pHeaviest = &objItem;
+            pHeaviest->nThreads++;
+            nGiven = 1;
+        }
+        nRemaining -= nGiven;
+    }
+    return vecItems.back().nThreads;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+CYThreadLease::CYThreadLease()
+{
+
+}
+
+CYThreadLease::~CYThreadLease()
+{
+    Release();
+}
+
+int CYThreadLease::Acquire(int64_t nPixelRate, int nPriority)
+{
+    CYThreadBudget& objBudget = CYThreadBudget::Instance();
+    if (!objBudget.GetBudget())
+    {
+        Release();
+        return 0;
+    }
+
+    nPixelRate = FFMAX(nPixelRate, 1);
+    int64_t nWeight = nPixelRate << FFMAX(0, FFMIN(nPriority, 2));
+    int nCap = (int)FFMAX(1, FFMIN((nPixelRate + DECODE_THREAD_PIXEL_RATE - 1) / DECODE_THREAD_PIXEL_RATE, DECODE_THREAD_MAX));
+    LockGuard locker(objBudget.m_mutex);
+    return objBudget.Grant(this, nWeight, nCap);
+}
+
+void CYThreadLease::Take(CYThreadLease& objFrom)
+{
+    if (&objFrom != this)
+        CYThreadBudget::Instance().Transfer(this, &objFrom);
+}
+
+void CYThreadLease::Release()
+{
+    CYThreadBudget::Instance().Remove(this);
+}
+
+int CYThreadLease::Threads() const
+{
+    return m_nThreads;
+}
+
+CYPLAYER_NAMESPACE_END
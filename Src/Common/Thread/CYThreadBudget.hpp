@@ -0,0 +1,131 @@
+/*
+ * CYPlayer License
+ * -----------
+ *
+ * CYPlayer is licensed under the terms of the MIT license reproduced below.
+ * This means that CYPlayer is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ *
+ *
+ * ===============================================================================
+ *
+ * Copyright (C) 2023-2026 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ===============================================================================
+ */
+ /*
+  * AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+  * VERSION:  1.0.0
+  * PURPOSE:  Cross-platform efficient all-round player SDK.
+  * CREATION: 2025.04.23
+  * LCHANGE:  2025.04.23
+  * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+  */
+
+#ifndef __CY_THREAD_BUDGET_HPP__
+#define __CY_THREAD_BUDGET_HPP__
+
+#include "Common/CYCommonDefine.hpp"
+#include "Common/CYFFmpegDefine.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+
+CYPLAYER_NAMESPACE_BEGIN
+
+class CYThreadLease;
+
+/**
+ * Process-wide budget of codec threads shared by every player.
+ *
+ * Without a budget each video decoder opens with "threads=auto", one FFmpeg worker per core,
+ * so N players start N times as many workers as there are cores. With a budget set, each
+ * player's CYThreadLease claims a weight, the pixel rate of its video scaled by its priority,
+ * and the budget is split in proportion to the weights: every lease gets at least one thread,
+ * and never more than its pixel rate can keep busy (DECODE_THREAD_PIXEL_RATE per thread), the
+ * rest goes to the other leases.
+ *
+ * A codec keeps the thread count it was opened with, so a lease is granted its share only as far
+ * as the threads held by the decoders of the other leases leave room. The leases together stay
+ * within the budget, save the one thread a decoder gets even when the others hold it all; threads
+ * released by one player, and a larger share after a split, reach the others at their next
+ * decoder open (next playlist item, reopen). A budget of 0 disables it.
+ */
+class CYThreadBudget
+{
+public:
+    static CYThreadBudget& Instance();
+
+public:
+    void SetBudget(int nThreads);
+    int  GetBudget() const;
+    int  Leases() const;
+    /* threads the decoders of all leases were opened with, over the budget only by the one thread each lease gets at least */
+    int  Assigned() const;
+
+private:
+    CYThreadBudget();
+    ~CYThreadBudget();
+
+    friend class CYThreadLease;
+    int  Grant(CYThreadLease* pLease, int64_t nWeight, int nCap);
+    void Transfer(CYThreadLease* pLease, CYThreadLease* pFrom);
+    void Remove(CYThreadLease* pLease);
+    int  Share(CYThreadLease* pLease, int64_t nWeight, int nCap) const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::atomic<int> m_nBudget{ 0 };
+    std::vector<CYThreadLease*> m_vecLeases;
+};
+
+/**
+ * One player's claim on the process thread budget, released on destruction.
+ */
+class CYThreadLease
+{
+public:
+    CYThreadLease();
+    virtual ~CYThreadLease();
+
+public:
+    /** claim threads for a decoder of nPixelRate pixels per second at nPriority (0 low, 1 normal,
+        2 high); returns the count to open it with, 0 when no budget is set. */
+    int  Acquire(int64_t nPixelRate, int nPriority);
+    /** take over the claim of objFrom, whose decoder replaces the one of this lease; objFrom is
+        left released. */
+    void Take(CYThreadLease& objFrom);
+    void Release();
+    int  Threads() const;
+
+private:
+    friend class CYThreadBudget;
+    int64_t m_nWeight = 0;
+    int m_nCap = 1;
+    std::atomic<int> m_nThreads{ 0 };
+    bool m_bRegistered = false;
+};
+
+CYPLAYER_NAMESPACE_END
+
+#endif // __CY_THREAD_BUDGET_HPP__
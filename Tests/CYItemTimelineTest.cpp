@@ -0,0 +1,75 @@
+#include <iostream>
+
+#include "ChainFilter/Common/CYItemTimeline.hpp"
+
+#define TEST_SEC        AV_TIME_BASE
+#define TEST_ITEM_MS    10000
+
+static int g_nErrors = 0;
+
+static void Expect(bool bOk, const char* pszWhat)
+{
+    if (!bOk)
+    {
+        std::cout << "FAILED: " << pszWhat << std::endl;
+        g_nErrors++;
+    }
+}
+
+// The demuxer reads a playlist item ahead of the screen: it queues the next one when the current
+// one is read to its end, the screen keeps showing the tail until the master clock gets there.
+static void QueueItem(cry::CYItemTimeline& objTimeline, int64_t nStart, int64_t nFileStart, bool bLoop)
+{
+    cry::CYTimelineItem objItem;
+    objItem.nStart = nStart;
+    objItem.nOffset = nStart - nFileStart;
+    objItem.nDuration = TEST_ITEM_MS;
+    objItem.bLoop = bLoop;
+    objTimeline.Queue(objItem);
+}
+
+int main(int argc, char* argv[])
+{
+    cry::CYItemTimeline objTimeline;
+    cry::CYTimelineItem objItem;
+
+    /* item A, 10 s from 0, read to its end: item B is read from 10 s while A's last seconds play */
+    objTimeline.Reset(0, TEST_ITEM_MS);
+    QueueItem(objTimeline, 10 * TEST_SEC, 0, false);
+    Expect(!objTimeline.Present(9.5), "the screen stays on A before 10 s");
+    Expect(objTimeline.Offset() == 0, "positions are within A during its tail");
+
+    /* Seek(9000) from the position on screen lands in A's tail, not 9 s into B */
+    int64_t nTarget = objTimeline.SeekTarget(9000);
+    Expect(nTarget == 9 * TEST_SEC, "a seek during A's tail maps with A's offset");
+    Expect(objTimeline.Locate(nTarget, &objItem) == cry::CYItemTimeline::ITEM_PREVIOUS && objItem.nOffset == 0,
+        "a target in A's tail is found in the item before B");
+    objTimeline.Return();
+    Expect(!objTimeline.Pending() && objTimeline.Read().nOffset == 0, "reading went back to A");
+
+    /* A is read to its end again, and this time played into B */
+    QueueItem(objTimeline, 10 * TEST_SEC, 0, false);
+    Expect(objTimeline.Present(10.2), "B goes on screen at 10 s");
+    Expect(objTimeline.Duration() == TEST_ITEM_MS && objTimeline.Offset() == 10 * TEST_SEC, "positions follow B");
+    nTarget = objTimeline.SeekTarget(1000);
+    Expect(nTarget == 11 * TEST_SEC && objTimeline.Locate(nTarget, &objItem) == cry::CYItemTimeline::ITEM_READ,
+        "a seek in B stays in B");
+    Expect(objTimeline.SeekTarget(-500) == 10 * TEST_SEC, "a seek before B's start lands on it");
+
+    /* B loops at 20 s: a seek during the tail of its first round goes back one round */
+    QueueItem(objTimeline, 20 * TEST_SEC, 0, true);
+    Expect(!objTimeline.Present(19.0), "the first round of B stays on screen");
+    nTarget = objTimeline.SeekTarget(8000);
+    Expect(objTimeline.Locate(nTarget, &objItem) == cry::CYItemTimeline::ITEM_PREVIOUS && objTimeline.Read().bLoop &&
+        objItem.nOffset == 10 * TEST_SEC, "a target in the first round of B is one round back");
+
+    /* C follows the second round of B before the screen left the first one: B's first round is gone */
+    QueueItem(objTimeline, 30 * TEST_SEC, 0, false);
+    nTarget = objTimeline.SeekTarget(8000);
+    Expect(objTimeline.Locate(nTarget, &objItem) == cry::CYItemTimeline::ITEM_GONE, "two items back cannot be sought");
+    Expect(!objTimeline.Present(25.0) && objTimeline.Offset() == 20 * TEST_SEC, "another round of a loop is no media change");
+    Expect(objTimeline.Present(30.0) && !objTimeline.Pending(), "C goes on screen at 30 s");
+
+    std::cout << (g_nErrors ? "item timeline test failed" : "item timeline test passed") << std::endl;
+    return g_nErrors ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <chrono>
+
+#include "ChainFilter/Common/CYMappedFileIO.hpp"
+#include "ChainFilter/Common/CYReadAheadIO.hpp"
+
+enum EInputMode
+{
+    INPUT_FILE_PROTOCOL,
+    INPUT_MAPPED,
+    INPUT_READ_AHEAD,
+};
+
+// Demux a local file end to end, through the file protocol, CYMappedFileIO or CYReadAheadIO,
+// and report the packet payload throughput. Run it twice to compare a warm page cache.
+double DemuxFile(const char* pszPath, EInputMode eMode, int64_t* pBytes)
+{
+    cry::CYMappedFileIO objMappedIO;
+    cry::CYReadAheadIO objReadAheadIO;
+    AVFormatContext* pIC = avformat_alloc_context();
+    AVPacket* pPkt = av_packet_alloc();
+    *pBytes = 0;
+    if (!pIC || !pPkt)
+        return -1;
+
+    if (eMode == INPUT_MAPPED && objMappedIO.Open(pszPath) >= 0)
+        pIC->pb = objMappedIO.Context();
+    else if (eMode == INPUT_READ_AHEAD && objReadAheadIO.Open(pszPath, nullptr, nullptr, 64 * 1024 * 1024, nullptr) >= 0)
+        pIC->pb = objReadAheadIO.Context();
+    else if (eMode != INPUT_FILE_PROTOCOL)
+    {
+        std::cout << "could not set up custom I/O for " << pszPath << std::endl;
+        avformat_free_context(pIC);
+        av_packet_free(&pPkt);
+        return -1;
+    }
+
+    auto tStart = std::chrono::steady_clock::now();
+    if (avformat_open_input(&pIC, pszPath, nullptr, nullptr) < 0)
+    {
+        std::cout << "could not open " << pszPath << std::endl;
+        av_packet_free(&pPkt);
+        return -1;
+    }
+    while (av_read_frame(pIC, pPkt) >= 0)
+    {
+        *pBytes += pPkt->size;
+        av_packet_unref(pPkt);
+    }
+    std::chrono::duration<double> tElapsed = std::chrono::steady_clock::now() - tStart;
+
+    avformat_close_input(&pIC);
+    av_packet_free(&pPkt);
+    return *pBytes / tElapsed.count() / (1024 * 1024);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "usage: CYMappedIOBench <local media file> [rounds]" << std::endl;
+        return 1;
+    }
+    int nRounds = argc > 2 ? atoi(argv[2]) : 3;
+    av_log_set_level(AV_LOG_ERROR);
+
+    int nErrors = 0;
+    for (int i = 0; i < nRounds; i++)
+    {
+        int64_t nFileBytes = 0, nMappedBytes = 0, nReadAheadBytes = 0;
+        double fFile = DemuxFile(argv[1], INPUT_FILE_PROTOCOL, &nFileBytes);
+        double fMapped = DemuxFile(argv[1], INPUT_MAPPED, &nMappedBytes);
+        double fReadAhead = DemuxFile(argv[1], INPUT_READ_AHEAD, &nReadAheadBytes);
+        if (fFile < 0 || fMapped < 0 || fReadAhead < 0 || nFileBytes != nMappedBytes || nFileBytes != nReadAheadBytes)
+            nErrors++;
+
+        std::cout << "round " << i
+            << "  file protocol: " << (int64_t)fFile << " MB/s"
+            << "  mapped: " << (int64_t)fMapped << " MB/s"
+            << "  read-ahead: " << (int64_t)fReadAhead << " MB/s"
+            << "  payload: " << nMappedBytes / (1024 * 1024) << " MB" << std::endl;
+    }
+
+    return nErrors ? 1 : 0;
+}
@@ -40,6 +40,9 @@ void PlayerEventCallback(const cry::EPlayerEventInfo* eventInfo) {
         case cry::TYPE_EVENT_BUFFERING_ENDED:
             std::cout << "Buffering ended" << std::endl;
             break;
+        case cry::TYPE_EVENT_SEEK_COMPLETED:
+            std::cout << "Seek completed in " << eventInfo->fSeekLatency << " ms" << std::endl;
+            break;
         default:
             std::cout << "Unknown event: " << static_cast<int>(eventInfo->eEventType) << std::endl;
             break;
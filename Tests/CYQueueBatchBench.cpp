@@ -0,0 +1,125 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+#include "Common/Queue/CYPacketQueue.hpp"
+#include "Common/Queue/CYFrameQueue.hpp"
+
+// Small audio-like packets through the packet queue, one at a time vs PutBatch/GetBatch.
+double BenchPacketQueue(int nPackets, int nBatch)
+{
+    cry::CYPacketQueue objQueue;
+    objQueue.Init();
+    objQueue.Start();
+
+    auto tStart = std::chrono::steady_clock::now();
+    std::thread objProducer([&]() {
+        std::vector<AVPacketPtr> vecPkts(nBatch);
+        for (auto& ptrPkt : vecPkts)
+            ptrPkt = AVPacketPtrCreate();
+
+        for (int i = 0; i < nPackets; i += nBatch)
+        {
+            while (objQueue.NbPackets() > 256)
+                std::this_thread::yield();
+            for (int j = 0; j < nBatch; j++)
+            {
+                vecPkts[j]->size = 256;
+                vecPkts[j]->pts = i + j;
+            }
+            if (nBatch == 1)
+                objQueue.Put(vecPkts[0]);
+            else
+                objQueue.PutBatch(vecPkts.data(), nBatch);
+        }
+    });
+
+    std::vector<AVPacketPtr> vecOut(nBatch);
+    std::vector<int> vecSerial(nBatch);
+    int nReceived = 0;
+    while (nReceived < nPackets)
+    {
+        int nGot = nBatch == 1 ? objQueue.Get(vecOut[0], 1, &vecSerial[0]) : objQueue.GetBatch(vecOut.data(), nBatch, 1, vecSerial.data());
+        if (nGot <= 0)
+            break;
+        for (int j = 0; j < nGot; j++)
+        {
+            if (vecOut[j]->pts != nReceived + j)
+                std::cout << "out of order packet " << vecOut[j]->pts << std::endl;
+        }
+        nReceived += nGot;
+    }
+    objProducer.join();
+
+    std::chrono::duration<double> tElapsed = std::chrono::steady_clock::now() - tStart;
+    return nReceived / tElapsed.count();
+}
+
+// Decoded frames through a sample-queue sized frame queue, Push vs PushBatch.
+double BenchFrameQueue(int nFrames, int nBatch)
+{
+    SharePtr<cry::CYPacketQueue> ptrPktQueue = MakeShared<cry::CYPacketQueue>();
+    ptrPktQueue->Init();
+    ptrPktQueue->Start();
+
+    cry::CYFrameQueue objQueue;
+    objQueue.Init(ptrPktQueue, 9, 1);
+
+    auto tStart = std::chrono::steady_clock::now();
+    std::thread objProducer([&]() {
+        std::vector<CYFrame*> vecFrames(nBatch);
+        int i = 0;
+        while (i < nFrames)
+        {
+            if (nBatch == 1)
+            {
+                CYFrame* pFrame = objQueue.PeekWritable();
+                if (!pFrame)
+                    break;
+                pFrame->pts = i++;
+                objQueue.Push();
+                continue;
+            }
+
+            int nWritable = objQueue.PeekWritableBatch(vecFrames.data(), FFMIN(nBatch, nFrames - i));
+            if (nWritable <= 0)
+                break;
+            for (int j = 0; j < nWritable; j++)
+                vecFrames[j]->pts = i++;
+            objQueue.PushBatch(nWritable);
+        }
+    });
+
+    for (int i = 0; i < nFrames; i++)
+    {
+        CYFrame* pFrame = objQueue.PeekReadable();
+        if (!pFrame)
+            break;
+        if (pFrame->pts != i)
+            std::cout << "out of order frame " << pFrame->pts << std::endl;
+        objQueue.Next();
+    }
+    objProducer.join();
+
+    std::chrono::duration<double> tElapsed = std::chrono::steady_clock::now() - tStart;
+    ptrPktQueue->Abort();
+    objQueue.Destroy();
+    return nFrames / tElapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+    int nCount = argc > 1 ? atoi(argv[1]) : 1000000;
+    const int arrBatch[] = { 1, 4, 8, 16 };
+
+    std::cout << "items: " << nCount << std::endl;
+    for (int nBatch : arrBatch)
+    {
+        std::cout << "batch " << nBatch
+            << "  packet queue: " << (int64_t)BenchPacketQueue(nCount, nBatch) << " pkt/s"
+            << "  frame queue: " << (int64_t)BenchFrameQueue(nCount, FFMIN(nBatch, 9)) << " frame/s" << std::endl;
+    }
+
+    return 0;
+}